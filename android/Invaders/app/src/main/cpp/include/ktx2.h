@@ -0,0 +1,55 @@
+#ifndef KTX2_H
+#define KTX2_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal KTX2 container support for what the texture converter writes: one 2D
+// image with a mip chain, no array layers, cube faces or supercompression.
+
+// VkFormat values of the formats the game uses
+const uint32_t KTX2_FORMAT_RGBA8 = 37;          // VK_FORMAT_R8G8B8A8_UNORM
+const uint32_t KTX2_FORMAT_BC1_RGB = 131;       // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+const uint32_t KTX2_FORMAT_BC3 = 137;           // VK_FORMAT_BC3_UNORM_BLOCK
+const uint32_t KTX2_FORMAT_ETC2_RGB = 147;      // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+const uint32_t KTX2_FORMAT_ETC2_RGBA = 151;     // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+
+// Compressed copies of an image live next to it as <name>.bc.ktx2 (BC1/BC3)
+// and <name>.etc2.ktx2 (ETC2), written by the texture_compress tool
+const char* const KTX2_SUFFIX_BC = "bc";
+const char* const KTX2_SUFFIX_ETC2 = "etc2";
+std::string ktx2SiblingPath(const std::string& imagePath, const char* suffix);
+
+struct Ktx2Level {
+    size_t offset;      // into Ktx2Texture::data
+    size_t size;
+    int width, height;
+};
+
+struct Ktx2Texture {
+    uint32_t vkFormat = 0;
+    int width = 0, height = 0;
+    bool bottomUp = false;          // KTXorientation "ru": first row is the bottom one, as GL expects
+    std::vector<Ktx2Level> levels;  // levels[0] is the base level
+    std::vector<unsigned char> data;
+};
+
+// Bytes per 4x4 block, or 0 for the uncompressed RGBA8 format
+uint32_t ktx2BlockBytes(uint32_t vkFormat);
+// Size of one mip level of the given dimensions
+size_t ktx2LevelSize(uint32_t vkFormat, int width, int height);
+// GL internal format for glCompressedTexImage2D (GL_RGBA8 for KTX2_FORMAT_RGBA8), 0 if unknown
+uint32_t ktx2GLInternalFormat(uint32_t vkFormat);
+const char* ktx2FormatName(uint32_t vkFormat);
+
+// Reads a file or an in-memory copy of one; false (with a message) if it is not a
+// KTX2 file this loader understands
+bool readKtx2(const std::string& path, Ktx2Texture& texture);
+bool parseKtx2(const unsigned char* bytes, size_t size, Ktx2Texture& texture);
+
+// Writes levels in the order given (base first); the file stores them smallest first
+bool writeKtx2(const std::string& path, const Ktx2Texture& texture);
+
+#endif
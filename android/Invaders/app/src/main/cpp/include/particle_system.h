@@ -0,0 +1,107 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shader.h"
+
+// Burst of particles spawned by ParticleSystem::emit. Every random range is
+// sampled uniformly per particle.
+struct ParticleEmitter {
+    glm::vec2 position = glm::vec2(0.0f);
+    glm::vec2 baseVelocity = glm::vec2(0.0f);   // added to every particle (inherited motion)
+    float direction = 0.0f;                     // radians, 0 = +x
+    float spread = 6.2831853f;                  // cone width around direction (radians)
+    float speedMin = 0.5f, speedMax = 2.0f;     // world units per second
+    float lifeMin = 0.3f, lifeMax = 1.0f;       // seconds
+    float sizeMin = 0.02f, sizeMax = 0.05f;     // world units
+    float drag = 1.0f;                          // fraction of velocity lost per second
+    float positionJitter = 0.0f;                // spawn radius around position
+    glm::vec4 colorMin = glm::vec4(1.0f);
+    glm::vec4 colorMax = glm::vec4(1.0f);
+    int count = 100;
+
+    static ParticleEmitter explosionDebris(glm::vec2 position);
+    static ParticleEmitter hitSparks(glm::vec2 position, glm::vec2 bulletVelocity);
+    static ParticleEmitter engineTrail(glm::vec2 position);
+};
+
+// Fixed-capacity particle pool drawn as additive point sprites. Simulation runs
+// on the GPU with transform feedback between two ping-pong buffers; contexts
+// without it (or when asked to) fall back to a SIMD loop over CPU streams that
+// are uploaded each frame. New particles overwrite the oldest slots.
+class ParticleSystem {
+public:
+    enum Backend { GPU_TRANSFORM_FEEDBACK, CPU_SIMD };
+
+    explicit ParticleSystem(int maxParticles);
+    ~ParticleSystem();
+
+    // updateShader (particle_update.vs) must be linked with feedbackVaryings()
+    // captured; renderShader is particle.vs/particle.fs
+    bool initialize(Shader* updateShader, Shader* renderShader, bool allowGPU = true);
+    void cleanup();
+    // The EGL context was destroyed along with every GL object: drop the names
+    // without deleting them, since a new context may have reused them
+    void contextLost();
+
+    void emit(const ParticleEmitter& emitter);
+    void update(float deltaTime);
+    // Expects additive blending to be set by the caller
+    void render(const glm::mat4& view, const glm::mat4& projection, float pixelsPerUnit);
+    void clear();
+
+    Backend getBackend() const { return backend; }
+    int getCapacity() const { return maxParticles; }
+    // Slots touched since the last clear (upper bound on live particles)
+    int getActiveRange() const { return activeRange; }
+
+    static const std::vector<const char*>& feedbackVaryings();
+
+private:
+    // Vertex layout shared by both backends' shaders (attribute locations 0-4)
+    struct Particle {
+        glm::vec2 position;
+        glm::vec2 velocity;
+        glm::vec2 ageLife;      // x = age, y = lifetime (seconds)
+        glm::vec2 sizeDrag;     // x = size (world units), y = drag
+        glm::vec4 color;
+    };
+
+    int maxParticles;
+    Backend backend;
+    Shader* updateShader;
+    Shader* renderShader;
+
+    // GPU backend: particles ping-pong between two buffers
+    unsigned int buffers[2];
+    unsigned int vaos[2];
+    int current;
+
+    // CPU backend: interleaved (x, y) pair streams so 4-wide SIMD covers two particles
+    std::vector<float> positions;
+    std::vector<float> velocities;
+    std::vector<float> ageLife;
+    std::vector<float> dragPairs;       // drag duplicated per component, CPU only
+    std::vector<float> sizeDrag;
+    std::vector<float> colors;
+    unsigned int dynamicBuffer;         // positions + ageLife, refilled every frame
+    unsigned int staticBuffer;          // sizeDrag + color, written when particles spawn
+    unsigned int streamVAO;
+
+    std::vector<Particle> pending;      // emitted since the last update
+    int spawnCursor;
+    int activeRange;
+    float simulationTime;
+    float aliveUntil;                   // no particle lives past this simulation time
+    unsigned int randomState;
+
+    float random(float minValue, float maxValue);
+    bool createGPUBuffers();
+    void createCPUBuffers();
+    void flushPending();
+    void uploadRun(int first, const Particle* particles, int count);
+};
+
+#endif
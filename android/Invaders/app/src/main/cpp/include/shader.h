@@ -7,6 +7,12 @@
 #include <iostream>
 #include <android/asset_manager.h>
 
+// In-memory vertex/fragment source pair, e.g. from the embedded shader table
+struct ShaderSource {
+  const char* vertexCode;
+  const char* fragmentCode;
+};
+
 class Shader {
   public:
   unsigned int ID;
@@ -14,6 +20,9 @@ class Shader {
   // Android constructor for asset loading
   Shader(AAssetManager* assetManager, const char* vertexAssetPath, const char* fragmentAssetPath);
 
+  // Constructor for sources already in memory (no asset I/O)
+  explicit Shader(const ShaderSource& source);
+
   void use();
 
   void setBool(const std::string &name, bool value) const;
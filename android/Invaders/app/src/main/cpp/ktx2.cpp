@@ -0,0 +1,300 @@
+#include "ktx2.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const unsigned char KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+static const char* ORIENTATION_KEY = "KTXorientation";
+
+// identifier + 9 header words + index (4 words, 2 qwords)
+static const size_t HEADER_SIZE = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+static const size_t LEVEL_INDEX_ENTRY_SIZE = 3 * 8;
+
+// Khronos data format descriptor constants (KHR_DF_*)
+static const uint8_t DF_MODEL_RGBSDA = 1;
+static const uint8_t DF_MODEL_BC1A = 128;
+static const uint8_t DF_MODEL_BC3 = 130;
+static const uint8_t DF_MODEL_ETC2 = 161;
+static const uint8_t DF_CHANNEL_COLOR = 0;
+static const uint8_t DF_CHANNEL_ETC2_COLOR = 2;
+static const uint8_t DF_CHANNEL_ALPHA = 15;
+
+uint32_t ktx2BlockBytes(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case KTX2_FORMAT_BC1_RGB:
+        case KTX2_FORMAT_ETC2_RGB:
+            return 8;
+        case KTX2_FORMAT_BC3:
+        case KTX2_FORMAT_ETC2_RGBA:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+size_t ktx2LevelSize(uint32_t vkFormat, int width, int height) {
+    uint32_t blockBytes = ktx2BlockBytes(vkFormat);
+    if (blockBytes == 0) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+}
+
+uint32_t ktx2GLInternalFormat(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case KTX2_FORMAT_RGBA8: return 0x8058;          // GL_RGBA8
+        case KTX2_FORMAT_BC1_RGB: return 0x83F0;        // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+        case KTX2_FORMAT_BC3: return 0x83F3;            // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+        case KTX2_FORMAT_ETC2_RGB: return 0x9274;       // GL_COMPRESSED_RGB8_ETC2
+        case KTX2_FORMAT_ETC2_RGBA: return 0x9278;      // GL_COMPRESSED_RGBA8_ETC2_EAC
+        default: return 0;
+    }
+}
+
+const char* ktx2FormatName(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case KTX2_FORMAT_RGBA8: return "RGBA8";
+        case KTX2_FORMAT_BC1_RGB: return "BC1";
+        case KTX2_FORMAT_BC3: return "BC3";
+        case KTX2_FORMAT_ETC2_RGB: return "ETC2 RGB";
+        case KTX2_FORMAT_ETC2_RGBA: return "ETC2 RGBA";
+        default: return "unknown";
+    }
+}
+
+std::string ktx2SiblingPath(const std::string& imagePath, const char* suffix) {
+    size_t slash = imagePath.find_last_of("/\\");
+    size_t dot = imagePath.find_last_of('.');
+    std::string stem = dot != std::string::npos && (slash == std::string::npos || dot > slash)
+        ? imagePath.substr(0, dot) : imagePath;
+    return stem + "." + suffix + ".ktx2";
+}
+
+static uint32_t readU32(const unsigned char* bytes) {
+    return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+           static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+static uint64_t readU64(const unsigned char* bytes) {
+    return static_cast<uint64_t>(readU32(bytes)) | static_cast<uint64_t>(readU32(bytes + 4)) << 32;
+}
+
+static void writeU32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<unsigned char>(value >> (i * 8)));
+}
+
+static void writeU64(std::vector<unsigned char>& out, uint64_t value) {
+    writeU32(out, static_cast<uint32_t>(value));
+    writeU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+static void padTo(std::vector<unsigned char>& out, size_t alignment) {
+    while (out.size() % alignment != 0) out.push_back(0);
+}
+
+bool readKtx2(const std::string& path, Ktx2Texture& texture) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    std::vector<unsigned char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+        std::cout << "WARNING::KTX2::Failed reading " << path << std::endl;
+        return false;
+    }
+    if (!parseKtx2(bytes.data(), bytes.size(), texture)) {
+        std::cout << "WARNING::KTX2::" << path << " is not a supported KTX2 file" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool parseKtx2(const unsigned char* bytes, size_t size, Ktx2Texture& texture) {
+    if (size < HEADER_SIZE || std::memcmp(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        return false;
+    }
+    const unsigned char* header = bytes + sizeof(KTX2_IDENTIFIER);
+    uint32_t vkFormat = readU32(header);
+    uint32_t width = readU32(header + 8);
+    uint32_t height = readU32(header + 12);
+    uint32_t depth = readU32(header + 16);
+    uint32_t layers = readU32(header + 20);
+    uint32_t faces = readU32(header + 24);
+    uint32_t levelCount = std::max(readU32(header + 28), 1u);
+    uint32_t supercompression = readU32(header + 32);
+    uint32_t kvdOffset = readU32(header + 44);
+    uint32_t kvdLength = readU32(header + 48);
+    if (ktx2GLInternalFormat(vkFormat) == 0 || width == 0 || height == 0 || depth > 1 || layers > 1 ||
+        faces != 1 || supercompression != 0 || levelCount > 32 ||
+        size < HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE) {
+        return false;
+    }
+
+    texture.vkFormat = vkFormat;
+    texture.width = static_cast<int>(width);
+    texture.height = static_cast<int>(height);
+    texture.levels.clear();
+    texture.data.clear();
+
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const unsigned char* entry = bytes + HEADER_SIZE + level * LEVEL_INDEX_ENTRY_SIZE;
+        uint64_t offset = readU64(entry);
+        uint64_t length = readU64(entry + 8);
+        int levelWidth = std::max(1, texture.width >> level);
+        int levelHeight = std::max(1, texture.height >> level);
+        if (offset > size || length > size - offset || length != ktx2LevelSize(vkFormat, levelWidth, levelHeight)) {
+            return false;
+        }
+        texture.levels.push_back({texture.data.size(), static_cast<size_t>(length), levelWidth, levelHeight});
+        texture.data.insert(texture.data.end(), bytes + offset, bytes + offset + length);
+    }
+
+    // key/value entries: u32 length, "key\0value", padded to 4 bytes
+    texture.bottomUp = false;
+    if (kvdOffset <= size && kvdLength <= size - kvdOffset) {
+        size_t cursor = kvdOffset, end = kvdOffset + kvdLength;
+        while (cursor + 4 <= end) {
+            uint32_t length = readU32(bytes + cursor);
+            if (length > end - cursor - 4) break;
+            const char* entry = reinterpret_cast<const char*>(bytes + cursor + 4);
+            size_t keyLength = strnlen(entry, length);
+            if (keyLength < length && std::strcmp(entry, ORIENTATION_KEY) == 0) {
+                texture.bottomUp = keyLength + 2 < length && entry[keyLength + 2] == 'u';
+            }
+            cursor += 4 + ((length + 3) & ~3u);
+        }
+    }
+    return true;
+}
+
+// Basic data format descriptor block for the format (KDFS 1.3, section 5.5)
+static std::vector<unsigned char> dataFormatDescriptor(uint32_t vkFormat) {
+    struct Sample { uint16_t bitOffset; uint8_t bitLength; uint8_t channel; uint32_t upper; };
+    std::vector<Sample> samples;
+    uint8_t model, blockDimension, bytesPlane;
+    switch (vkFormat) {
+        case KTX2_FORMAT_BC1_RGB:
+            model = DF_MODEL_BC1A; blockDimension = 3; bytesPlane = 8;
+            samples = {{0, 64, DF_CHANNEL_COLOR, 0xFFFFFFFF}};
+            break;
+        case KTX2_FORMAT_BC3:
+            model = DF_MODEL_BC3; blockDimension = 3; bytesPlane = 16;
+            samples = {{0, 64, DF_CHANNEL_ALPHA, 0xFFFFFFFF}, {64, 64, DF_CHANNEL_COLOR, 0xFFFFFFFF}};
+            break;
+        case KTX2_FORMAT_ETC2_RGB:
+            model = DF_MODEL_ETC2; blockDimension = 3; bytesPlane = 8;
+            samples = {{0, 64, DF_CHANNEL_ETC2_COLOR, 0xFFFFFFFF}};
+            break;
+        case KTX2_FORMAT_ETC2_RGBA:
+            model = DF_MODEL_ETC2; blockDimension = 3; bytesPlane = 16;
+            samples = {{0, 64, DF_CHANNEL_ALPHA, 0xFFFFFFFF}, {64, 64, DF_CHANNEL_ETC2_COLOR, 0xFFFFFFFF}};
+            break;
+        default:
+            model = DF_MODEL_RGBSDA; blockDimension = 0; bytesPlane = 4;
+            samples = {{0, 8, 0, 255}, {8, 8, 1, 255}, {16, 8, 2, 255}, {24, 8, DF_CHANNEL_ALPHA, 255}};
+            break;
+    }
+
+    std::vector<unsigned char> block;
+    uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+    writeU32(block, 4 + blockSize);         // dfdTotalSize
+    writeU32(block, 0);                     // vendorId 0 (Khronos), descriptorType 0 (basic)
+    writeU32(block, 2 | blockSize << 16);   // versionNumber 2, descriptorBlockSize
+    block.push_back(model);
+    block.push_back(1);                     // BT.709 primaries
+    block.push_back(1);                     // linear transfer, as the textures are sampled as UNORM
+    block.push_back(0);                     // straight alpha
+    block.push_back(blockDimension);        // block width - 1
+    block.push_back(blockDimension);        // block height - 1
+    block.push_back(0);
+    block.push_back(0);
+    block.push_back(bytesPlane);
+    for (int i = 0; i < 7; i++) block.push_back(0);
+    for (const Sample& sample : samples) {
+        block.push_back(static_cast<unsigned char>(sample.bitOffset));
+        block.push_back(static_cast<unsigned char>(sample.bitOffset >> 8));
+        block.push_back(static_cast<unsigned char>(sample.bitLength - 1));
+        block.push_back(sample.channel);
+        writeU32(block, 0);                 // sample position
+        writeU32(block, 0);                 // lower
+        writeU32(block, sample.upper);
+    }
+    return block;
+}
+
+bool writeKtx2(const std::string& path, const Ktx2Texture& texture) {
+    uint32_t levelCount = static_cast<uint32_t>(texture.levels.size());
+    uint32_t blockBytes = ktx2BlockBytes(texture.vkFormat);
+    // mip padding: lcm(texel block size, 4)
+    size_t levelAlignment = blockBytes != 0 ? blockBytes : 4;
+
+    std::vector<unsigned char> dfd = dataFormatDescriptor(texture.vkFormat);
+    std::vector<unsigned char> kvd;
+    std::string orientation = texture.bottomUp ? "ru" : "rd";
+    writeU32(kvd, static_cast<uint32_t>(std::strlen(ORIENTATION_KEY) + 1 + orientation.size() + 1));
+    kvd.insert(kvd.end(), ORIENTATION_KEY, ORIENTATION_KEY + std::strlen(ORIENTATION_KEY) + 1);
+    kvd.insert(kvd.end(), orientation.c_str(), orientation.c_str() + orientation.size() + 1);
+    padTo(kvd, 4);
+
+    size_t dfdOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE;
+    size_t kvdOffset = dfdOffset + dfd.size();
+    size_t dataOffset = kvdOffset + kvd.size();
+
+    // levels go into the file smallest first
+    std::vector<unsigned char> levelData;
+    std::vector<size_t> levelOffsets(levelCount);
+    for (uint32_t level = levelCount; level-- > 0;) {
+        while ((dataOffset + levelData.size()) % levelAlignment != 0) levelData.push_back(0);
+        levelOffsets[level] = dataOffset + levelData.size();
+        const Ktx2Level& entry = texture.levels[level];
+        levelData.insert(levelData.end(), texture.data.begin() + entry.offset,
+                         texture.data.begin() + entry.offset + entry.size);
+    }
+
+    std::vector<unsigned char> out(KTX2_IDENTIFIER, KTX2_IDENTIFIER + sizeof(KTX2_IDENTIFIER));
+    writeU32(out, texture.vkFormat);
+    writeU32(out, 1);                       // typeSize
+    writeU32(out, static_cast<uint32_t>(texture.width));
+    writeU32(out, static_cast<uint32_t>(texture.height));
+    writeU32(out, 0);                       // pixelDepth
+    writeU32(out, 0);                       // layerCount
+    writeU32(out, 1);                       // faceCount
+    writeU32(out, levelCount);
+    writeU32(out, 0);                       // no supercompression
+    writeU32(out, static_cast<uint32_t>(dfdOffset));
+    writeU32(out, static_cast<uint32_t>(dfd.size()));
+    writeU32(out, static_cast<uint32_t>(kvdOffset));
+    writeU32(out, static_cast<uint32_t>(kvd.size()));
+    writeU64(out, 0);                       // no supercompression global data
+    writeU64(out, 0);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        writeU64(out, levelOffsets[level]);
+        writeU64(out, texture.levels[level].size);
+        writeU64(out, texture.levels[level].size);
+    }
+    out.insert(out.end(), dfd.begin(), dfd.end());
+    out.insert(out.end(), kvd.begin(), kvd.end());
+    out.insert(out.end(), levelData.begin(), levelData.end());
+
+    // written next to the final name first so a crash never leaves a truncated file behind
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(reinterpret_cast<const char*>(out.data()), out.size())) {
+            std::cout << "WARNING::KTX2::Cannot write " << tmpPath << std::endl;
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cout << "WARNING::KTX2::Cannot rename " << tmpPath << " to " << path << std::endl;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
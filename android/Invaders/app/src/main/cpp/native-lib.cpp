@@ -18,7 +18,13 @@
 #include "stb_image.h"
 #include "shader.h"
 #include "stb_easy_font.h"
+#include "ktx2.h"
+#include "resource_pack.h"
+#include "particle_system.h"
 #include "include/audio_manager.h"
+#ifdef INVADERS_EMBEDDED_SHADERS
+#include "embedded_shaders.h"
+#endif
 
 #define LOG_TAG "InvadersNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -202,8 +208,40 @@ static std::vector<Bullet> bullets(MAX_BULLETS);
 const int MAX_EXPLOSIONS = 20;
 static std::vector<Explosion> explosions(MAX_EXPLOSIONS);  // Explosion pool
 
+// Layout of textures/explosion_atlas.png (see tools/explosion_atlas.cpp)
+const int EXPLOSION_FLIPBOOK_FRAMES = 16;
+const int EXPLOSION_FLIPBOOK_VARIATIONS = 4;
+
+// ===== QUALITY PROFILES =====
+// Same profiles as the desktop build (--quality there)
+struct QualityProfile {
+    const char* name;
+    bool flipbookExplosions;   // sample the pre-rendered explosion atlas instead of running explosion.fs
+    int blurPasses;            // bloom ping-pong passes (kept even)
+    int maxParticles;          // particle pool capacity
+};
+
+static const QualityProfile QUALITY_PROFILES[] = {
+    {"low",    true,  4,  32768},
+    {"medium", true,  10, 65536},
+    {"high",   false, 10, 131072},
+};
+// Phones run the low profile: one texture fetch per explosion pixel
+static QualityProfile g_quality = QUALITY_PROFILES[0];
+
 AudioManager* audioManager = nullptr; // Audio manager for sound effects
 
+// Debris, sparks and engine trail. GLES builds run the CPU SIMD (NEON) backend:
+// the Android Shader has no transform feedback varyings.
+static ParticleSystem* particleSystem = nullptr;
+const float ENGINE_TRAIL_RATE = 240.0f;  // trail particles per second
+static float g_engineTrailAccumulator = 0.0f;
+// Particle update + upload cost, logged every PARTICLE_REPORT_INTERVAL seconds
+const float PARTICLE_REPORT_INTERVAL = 5.0f;
+static double g_particleUpdateMs = 0.0;
+static int g_particleUpdates = 0;
+static float g_particleReportTimer = 0.0f;
+
 // Screen dimensions
 static int g_screenWidth = 800;
 static int g_screenHeight = 600;
@@ -318,21 +356,26 @@ static bool g_useRelativeMovement = true; // Enable relative movement
 
 // Asset manager for loading textures
 static AAssetManager* g_assetManager = nullptr;
+static AAsset* g_resourcePackAsset = nullptr;    // assets/resources.pack, open for the process lifetime
 
 // Texture IDs
 static GLuint g_playerTexture = 0;
 static GLuint g_enemyTexture = 0;
 static GLuint g_bulletTexture = 0;
 static GLuint g_enemyMissileTexture = 0;
+static GLuint g_explosionAtlasTexture = 0;
+static int g_explosionAtlasCell = 0;
 // Shader objects (same as desktop version)
 static Shader* playerShader = nullptr;
 static Shader* enemyShader = nullptr;
 static Shader* explosionShader = nullptr;
+static Shader* explosionFlipbookShader = nullptr;
 static Shader* backgroundShader = nullptr;
 static Shader* textShader = nullptr;
 static Shader* parallaxShader = nullptr;
 static Shader* blurShader = nullptr;
 static Shader* hdrShader = nullptr;
+static Shader* particleShader = nullptr;
 static GLuint g_quadVAO = 0;
 static GLuint g_quadVBO = 0;
 static GLuint g_backgroundVAO = 0;
@@ -466,6 +509,10 @@ void createExplosion(glm::vec2 position) {
             break;
         }
     }
+
+    if (particleSystem) {
+        particleSystem->emit(ParticleEmitter::explosionDebris(position));
+    }
 }
 
 void updateExplosions(float deltaTime) {
@@ -561,6 +608,9 @@ void updateBullets(float deltaTime) {
                                  enemies[j].position, ENEMY_RADIUS)) {
 
                     createExplosion(enemies[j].position);
+                    if (particleSystem) {
+                        particleSystem->emit(ParticleEmitter::hitSparks(bullets[i].position, bullets[i].velocity));
+                    }
 
                     // PLAY EXPLOSION SOUND
                     if (audioManager) {
@@ -660,6 +710,9 @@ void updateEnemyBullets(float deltaTime) {
 
                 // Create explosion at player position
                 createExplosion(enemyBullets[i].position);
+                if (particleSystem) {
+                    particleSystem->emit(ParticleEmitter::hitSparks(enemyBullets[i].position, enemyBullets[i].velocity));
+                }
 
                 // Check game over condition
                 if (playerLives <= 0) {
@@ -1244,27 +1297,96 @@ std::string loadShaderFromAssets(const char* filename) {
     return shaderSource;
 }
 
+// Load the <name>.etc2.ktx2 sibling of a texture asset (written by the desktop
+// texture_compress tool); ETC2 is core in OpenGL ES 3.0, so no extension check.
+// Returns 0 if there is none and the caller decodes the PNG instead.
+static GLuint loadCompressedTextureFromAssets(const char* filename, int* outWidth, int* outHeight) {
+    std::string ktxName = ktx2SiblingPath(filename, KTX2_SUFFIX_ETC2);
+    Ktx2Texture texture;
+    bool parsed;
+    ResourceData packed;
+    if (ResourcePack::instance().find(ktxName, packed)) {
+        parsed = parseKtx2(packed.data, packed.size, texture);
+    } else {
+        AAsset* asset = AAssetManager_open(g_assetManager, ktxName.c_str(), AASSET_MODE_BUFFER);
+        if (!asset) {
+            return 0;
+        }
+        const unsigned char* buffer = (const unsigned char*)AAsset_getBuffer(asset);
+        parsed = buffer && parseKtx2(buffer, AAsset_getLength(asset), texture);
+        AAsset_close(asset);
+    }
+    bool etc2 = texture.vkFormat == KTX2_FORMAT_ETC2_RGB || texture.vkFormat == KTX2_FORMAT_ETC2_RGBA;
+    if (!parsed || !etc2 || !texture.bottomUp) {
+        LOGE("Ignoring %s (not a bottom-up ETC2 KTX2 file)", ktxName.c_str());
+        return 0;
+    }
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLenum internalFormat = ktx2GLInternalFormat(texture.vkFormat);
+    for (size_t level = 0; level < texture.levels.size(); level++) {
+        const Ktx2Level& mip = texture.levels[level];
+        glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, internalFormat, mip.width, mip.height, 0,
+                               (GLsizei)mip.size, texture.data.data() + mip.offset);
+    }
+    // the file may stop short of 1x1; the chain is complete up to its last level
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)texture.levels.size() - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        LOGE("Failed to upload %s (GL error 0x%x)", ktxName.c_str(), error);
+        glDeleteTextures(1, &textureID);
+        return 0;
+    }
+    if (outWidth) *outWidth = texture.width;
+    if (outHeight) *outHeight = texture.height;
+
+    LOGI("Texture loaded successfully: %s (%dx%d, %s, %zu levels, ID: %u)", ktxName.c_str(),
+         texture.width, texture.height, ktx2FormatName(texture.vkFormat), texture.levels.size(), textureID);
+    return textureID;
+}
+
 // Load texture from Android assets
-GLuint loadTextureFromAssets(const char* filename) {
+GLuint loadTextureFromAssets(const char* filename, int* outWidth = nullptr, int* outHeight = nullptr) {
     if (!g_assetManager) {
         LOGE("Asset manager not initialized");
         return 0;
     }
+
+    GLuint compressedTexture = loadCompressedTextureFromAssets(filename, outWidth, outHeight);
+    if (compressedTexture) {
+        return compressedTexture;
+    }
     
     LOGI("Attempting to load texture: %s", filename);
     
-    AAsset* asset = AAssetManager_open(g_assetManager, filename, AASSET_MODE_BUFFER);
-    if (!asset) {
-        LOGE("Failed to open asset: %s", filename);
-        return 0;
+    // Entries of the mounted resources.pack are used in place; other textures are separate assets
+    ResourceData packed;
+    AAsset* asset = nullptr;
+    off_t length;
+    const unsigned char* buffer;
+    if (ResourcePack::instance().find(filename, packed)) {
+        length = (off_t)packed.size;
+        buffer = packed.data;
+    } else {
+        asset = AAssetManager_open(g_assetManager, filename, AASSET_MODE_BUFFER);
+        if (!asset) {
+            LOGE("Failed to open asset: %s", filename);
+            return 0;
+        }
+        length = AAsset_getLength(asset);
+        buffer = (const unsigned char*)AAsset_getBuffer(asset);
     }
     
-    off_t length = AAsset_getLength(asset);
-    const unsigned char* buffer = (const unsigned char*)AAsset_getBuffer(asset);
-    
     if (!buffer || length <= 0) {
         LOGE("Failed to read asset: %s", filename);
-        AAsset_close(asset);
+        if (asset) AAsset_close(asset);
         return 0;
     }
     
@@ -1275,7 +1397,7 @@ GLuint loadTextureFromAssets(const char* filename) {
     // stb_image can load from memory buffer
     unsigned char *data = stbi_load_from_memory(buffer, length, &width, &height, &nrChannels, 0);
     
-    AAsset_close(asset); // Close asset after reading into memory
+    if (asset) AAsset_close(asset); // Close asset after reading into memory
     
     if (!data) {
         LOGE("Failed to load texture with stb_image: %s - Error: %s", filename, stbi_failure_reason());
@@ -1314,6 +1436,8 @@ GLuint loadTextureFromAssets(const char* filename) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     
     stbi_image_free(data); // Free stb_image data
+    if (outWidth) *outWidth = width;
+    if (outHeight) *outHeight = height;
     
     LOGI("Texture loaded successfully: %s (%dx%d, %d channels, ID: %u)", filename, width, height, nrChannels, textureID);
     return textureID;
@@ -1418,6 +1542,10 @@ void initializeLevel(int level) {
         explosions[i].isActive = false;
     }
 
+    if (particleSystem) {
+        particleSystem->clear();
+    }
+
     std::cout << "Level " << level << " - Speed: " << currentLevelConfig.enemySpeed 
               << ", Attack Interval: " << currentLevelConfig.attackInterval << std::endl;
     
@@ -1518,6 +1646,21 @@ void renderLives() {
 }
 
 // Initialize OpenGL resources
+// Create a shader from the sources embedded at build time, falling back to the APK assets
+static Shader* createShader(const char* vertexName, const char* fragmentName) {
+#ifdef INVADERS_EMBEDDED_SHADERS
+    const char* vertexCode = findEmbeddedShader(vertexName);
+    const char* fragmentCode = findEmbeddedShader(fragmentName);
+    if (vertexCode && fragmentCode) {
+        return new Shader(ShaderSource{vertexCode, fragmentCode});
+    }
+    LOGE("Shader %s/%s not embedded, loading from assets", vertexName, fragmentName);
+#endif
+    std::string vertexPath = std::string("shaders/") + vertexName;
+    std::string fragmentPath = std::string("shaders/") + fragmentName;
+    return new Shader(g_assetManager, vertexPath.c_str(), fragmentPath.c_str());
+}
+
 static bool initializeOpenGL() {
     // Any GL object names obtained from a previous context are now invalid.
     // Make sure handles that are lazily generated elsewhere are reset so
@@ -1528,58 +1671,81 @@ static bool initializeOpenGL() {
     
     LOGI("Initializing OpenGL ES");
     
-    // Create shaders using Android asset constructor (same API as desktop version)
-    enemyShader = new Shader(g_assetManager, "shaders/enemy.vs", "shaders/enemy.fs");
+    // Create shaders from embedded sources (or Android assets when not embedded)
+    enemyShader = createShader("enemy.vs", "enemy.fs");
     if (enemyShader->ID == 0) {
         LOGE("Failed to create enemy shader");
         return false;
     }
 
-    playerShader = new Shader(g_assetManager, "shaders/player.vs", "shaders/player.fs");
+    playerShader = createShader("player.vs", "player.fs");
     if (playerShader->ID == 0) {
         LOGE("Failed to create player shader");
         return false;
     }
     
-    explosionShader = new Shader(g_assetManager, "shaders/explosion.vs", "shaders/explosion.fs");
+    explosionShader = createShader("explosion.vs", "explosion.fs");
     if (explosionShader->ID == 0) {
         LOGE("Failed to create explosion shader");
         return false;
     }
+
+    explosionFlipbookShader = createShader("explosion.vs", "explosion_flipbook.fs");
+    if (explosionFlipbookShader->ID == 0) {
+        LOGE("Failed to create explosion flipbook shader");
+        return false;
+    }
     
-    backgroundShader = new Shader(g_assetManager, "shaders/background.vs", "shaders/background.fs");
+    backgroundShader = createShader("background.vs", "background.fs");
     if (backgroundShader->ID == 0) {
         LOGE("Failed to create background shader");
         return false;
     }
     
-    parallaxShader = new Shader(g_assetManager, "shaders/parallax.vs", "shaders/parallax.fs");
+    parallaxShader = createShader("parallax.vs", "parallax.fs");
     if (parallaxShader->ID == 0) {
         LOGE("Failed to create parallax shader");
         return false;
     }
 
-    blurShader = new Shader(g_assetManager, "shaders/background.vs", "shaders/blur.fs");
+    blurShader = createShader("background.vs", "blur.fs");
     if (blurShader->ID == 0) {
         LOGE("Failed to create blur shader");
         return false;
     }
 
-    hdrShader = new Shader(g_assetManager, "shaders/background.vs", "shaders/hdr.fs");
+    hdrShader = createShader("background.vs", "hdr.fs");
     if (hdrShader->ID == 0) {
         LOGE("Failed to create hdr shader");
         return false;
     }
 
-    parallaxShader = new Shader(g_assetManager, "shaders/parallax.vs", "shaders/parallax.fs");
+    parallaxShader = createShader("parallax.vs", "parallax.fs");
     
-    textShader = new Shader(g_assetManager, "shaders/text.vs", "shaders/text.fs");
+    textShader = createShader("text.vs", "text.fs");
     if (textShader->ID == 0) {
         LOGE("Failed to create text shader");
         return false;
     }
     textShaderPtr = textShader;
 
+    particleShader = createShader("particle.vs", "particle.fs");
+    if (particleShader->ID == 0) {
+        LOGE("Failed to create particle shader");
+        return false;
+    }
+
+    // The particle buffers died with the previous context; start a fresh pool
+    if (particleSystem) {
+        particleSystem->contextLost();
+        delete particleSystem;
+    }
+    particleSystem = new ParticleSystem(g_quality.maxParticles);
+    if (!particleSystem->initialize(nullptr, particleShader, false)) {
+        delete particleSystem;
+        particleSystem = nullptr;
+    }
+
     // Setup text rendering VAO
     glGenVertexArrays(1, &textVAO);
     glGenBuffers(1, &textVBO);
@@ -1699,6 +1865,32 @@ static bool initializeOpenGL() {
     g_bulletTexture = loadTextureFromAssets("textures/missiles.png");
     g_enemyMissileTexture = loadTextureFromAssets("textures/shot-2.png");
 
+    // Explosion flipbook atlas; without it explosions fall back to explosion.fs
+    if (g_quality.flipbookExplosions) {
+        int atlasWidth = 0, atlasHeight = 0;
+        g_explosionAtlasTexture = loadTextureFromAssets("textures/explosion_atlas.png", &atlasWidth, &atlasHeight);
+        g_explosionAtlasCell = atlasHeight / EXPLOSION_FLIPBOOK_VARIATIONS;
+        if (g_explosionAtlasTexture &&
+            (g_explosionAtlasCell == 0 || atlasWidth != g_explosionAtlasCell * EXPLOSION_FLIPBOOK_FRAMES)) {
+            LOGE("Explosion atlas is not %dx%d cells, using procedural explosions",
+                 EXPLOSION_FLIPBOOK_FRAMES, EXPLOSION_FLIPBOOK_VARIATIONS);
+            glDeleteTextures(1, &g_explosionAtlasTexture);
+            g_explosionAtlasTexture = 0;
+        }
+        if (g_explosionAtlasTexture) {
+            // Cells sit edge to edge, so no repeat and no mips bleeding neighbours in
+            glBindTexture(GL_TEXTURE_2D, g_explosionAtlasTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+            explosionFlipbookShader->use();
+            explosionFlipbookShader->setInt("flipbook", 0);
+            explosionFlipbookShader->setVec2("cellScale", glm::vec2(1.0f / EXPLOSION_FLIPBOOK_FRAMES, 1.0f / EXPLOSION_FLIPBOOK_VARIATIONS));
+            explosionFlipbookShader->setFloat("cellInset", 0.5f / g_explosionAtlasCell);
+        }
+    }
+
     // Validate texture loading
     if (g_playerTexture == 0) {
         LOGE("Failed to load player texture");
@@ -1869,6 +2061,28 @@ static void updateGame(float deltaTime) {
         updateBullets(g_deltaTime);
         updateEnemyBullets(g_deltaTime);
         updateExplosions(g_deltaTime);
+
+        // Engine trail behind the ship, emitted at a fixed rate independent of frame rate
+        if (particleSystem) {
+            g_engineTrailAccumulator += g_deltaTime * ENGINE_TRAIL_RATE;
+            ParticleEmitter trail = ParticleEmitter::engineTrail(glm::vec2(playerPosition.x, playerPosition.y - 0.12f));
+            trail.count = static_cast<int>(g_engineTrailAccumulator);
+            g_engineTrailAccumulator -= trail.count;
+            particleSystem->emit(trail);
+
+            auto particleStart = std::chrono::steady_clock::now();
+            particleSystem->update(g_deltaTime);
+            g_particleUpdateMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - particleStart).count();
+            g_particleUpdates++;
+            g_particleReportTimer += g_deltaTime;
+            if (g_particleReportTimer >= PARTICLE_REPORT_INTERVAL) {
+                LOGI("Particles: update + upload avg %.3f ms over %d frames (%d slots live)",
+                     g_particleUpdateMs / g_particleUpdates, g_particleUpdates, particleSystem->getActiveRange());
+                g_particleUpdateMs = 0.0;
+                g_particleUpdates = 0;
+                g_particleReportTimer = 0.0f;
+            }
+        }
         
         // Update audio listener position to follow player
         if (audioManager) {
@@ -2178,7 +2392,28 @@ static void renderGame() {
     glEnable(GL_BLEND); // Enable transparency for explosions
     glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending for more boom!
     for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-        if (explosions[i].isActive) {  
+        if (explosions[i].isActive && g_explosionAtlasTexture) {
+            // One atlas fetch per pixel; the pool slot picks the spark variation
+            float progress = explosions[i].timer / explosions[i].duration;
+            int frame = std::min(static_cast<int>(progress * (EXPLOSION_FLIPBOOK_FRAMES - 1) + 0.5f),
+                                 EXPLOSION_FLIPBOOK_FRAMES - 1);
+
+            explosionFlipbookShader->use();
+            explosionFlipbookShader->setMat4("view", view);
+            explosionFlipbookShader->setMat4("projection", projection);
+            explosionFlipbookShader->setVec2("cell", glm::vec2(frame, i % EXPLOSION_FLIPBOOK_VARIATIONS));
+
+            glm::mat4 explosionModel = glm::mat4(1.0f);
+            explosionModel = glm::translate(explosionModel, glm::vec3(explosions[i].position.x, explosions[i].position.y, 0.0f));
+            explosionModel = glm::scale(explosionModel, glm::vec3(0.3f, 0.3f, 1.0f)); // Control explosion size
+            explosionFlipbookShader->setMat4("model", explosionModel);
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, g_explosionAtlasTexture);
+            glBindVertexArray(g_explosionVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glBindVertexArray(0);
+        } else if (explosions[i].isActive) {
             explosionShader->use();
             explosionShader->setMat4("view", view);
             explosionShader->setMat4("projection", projection);
@@ -2203,6 +2438,11 @@ static void renderGame() {
             glBindVertexArray(0);
         }
     }
+
+    // Debris, sparks and engine trail share the additive blend
+    if (particleSystem) {
+        particleSystem->render(view, projection, SCREEN_HEIGHT / (2.0f * WORLD_HALF_HEIGHT));
+    }
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Reset blending
 
     // Add HUD display
@@ -2216,7 +2456,7 @@ static void renderGame() {
 
     // blur loop for glow effect
     bool horizontal = true, first_iteration=true;
-    int amount=10;
+    int amount=g_quality.blurPasses;
     blurShader->use();
     for (unsigned int i=0; i<amount; i++) {
         glBindFramebuffer(GL_FRAMEBUFFER, g_pingpongFBO[horizontal]);
@@ -2264,6 +2504,20 @@ extern "C" JNIEXPORT void JNICALL
 Java_com_antash_invaders_MainActivity_nativeSetAssetManager(JNIEnv *env, jobject thiz, jobject assetManager) {
     g_assetManager = AAssetManager_fromJava(env, assetManager);
     LOGI("Asset manager set");
+
+    // Optional archive of the texture assets (tools/resource_pack.cpp). It is stored
+    // uncompressed in the APK (noCompress in build.gradle), so the buffer is a
+    // direct mapping of the APK rather than a copy.
+    if (!g_resourcePackAsset) {
+        AAsset* pack = AAssetManager_open(g_assetManager, "resources.pack", AASSET_MODE_BUFFER);
+        const unsigned char* buffer = pack ? (const unsigned char*)AAsset_getBuffer(pack) : nullptr;
+        if (buffer && ResourcePack::instance().mountMemory(buffer, AAsset_getLength(pack), "")) {
+            g_resourcePackAsset = pack;
+            LOGI("Mounted resources.pack (%zu entries)", ResourcePack::instance().entryCount());
+        } else if (pack) {
+            AAsset_close(pack);
+        }
+    }
 }
 
 extern "C" JNIEXPORT void JNICALL
@@ -2689,6 +2943,11 @@ Java_com_antash_invaders_MainActivity_nativeOnDestroy(JNIEnv *env, jobject thiz)
         glDeleteTextures(1, &g_enemyMissileTexture);
         g_enemyMissileTexture = 0;
     }
+
+    if (g_explosionAtlasTexture) {
+        glDeleteTextures(1, &g_explosionAtlasTexture);
+        g_explosionAtlasTexture = 0;
+    }
     
     if (g_rboDepth) {
         glDeleteRenderbuffers(1, &g_rboDepth);
@@ -2711,17 +2970,26 @@ Java_com_antash_invaders_MainActivity_nativeOnDestroy(JNIEnv *env, jobject thiz)
         textVBO = 0;
     }
     
+    // Cleanup particle system
+    if (particleSystem) {
+        delete particleSystem;
+        particleSystem = nullptr;
+    }
+
     // Cleanup shader objects
     delete enemyShader;
     delete explosionShader;
+    delete explosionFlipbookShader;
     delete backgroundShader;
     delete textShader;
     delete parallaxShader;
     delete blurShader;
     delete hdrShader;
     delete playerShader;
+    delete particleShader;
     enemyShader = nullptr;
     explosionShader = nullptr;
+    explosionFlipbookShader = nullptr;
     backgroundShader = nullptr;
     textShader = nullptr;
     parallaxShader = nullptr;
@@ -2729,6 +2997,7 @@ Java_com_antash_invaders_MainActivity_nativeOnDestroy(JNIEnv *env, jobject thiz)
     blurShader = nullptr;
     hdrShader = nullptr;
     playerShader = nullptr;
+    particleShader = nullptr;
     
     // Cleanup audio manager
     if (audioManager) {
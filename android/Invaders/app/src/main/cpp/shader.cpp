@@ -30,6 +30,16 @@ Shader::Shader(AAssetManager* assetManager, const char* vertexAssetPath, const c
   compileAndLinkShaders(vertexCode, fragmentCode);
 }
 
+Shader::Shader(const ShaderSource& source) {
+  if (!source.vertexCode || !source.fragmentCode) {
+    LOGE("Empty in-memory shader source");
+    ID = 0;
+    return;
+  }
+
+  compileAndLinkShaders(source.vertexCode, source.fragmentCode);
+}
+
 std::string Shader::loadShaderFromAssets(AAssetManager* assetManager, const char* filename) {
   if (!assetManager) {
     LOGE("Asset manager not initialized");
@@ -0,0 +1,527 @@
+// Micro-benchmarks of the game's simulation kernels and loaders: collision tests,
+// bullet and enemy updates on the shipped 10x3 formation and on scaled-up ones,
+// the Bezier dive path, stb_easy_font layout, WAV decoding and model import. The
+// game logic is the real one from main.cpp (see game_simulation.h), run without
+// a window, audio device or GL context.
+//
+// Results are written as JSON in Google Benchmark's layout, so the output of two
+// builds can be diffed with its tools/compare.py or any JSON diff.
+//
+// --sweep instead measures how the simulation scales: the formation and the
+// bullet, enemy bullet and explosion pools grow together from the game's 30
+// enemies to 100k, each size runs the same workload (a full formation under
+// constant fire), and a CSV reports ns per entity for each update and the tick
+// time. Growth faster than linear between two sizes is flagged.
+//
+// Usage: space_shooter_bench [--filter SUBSTRING] [--min-time SECONDS] [--output FILE] [--resources DIR]
+//        space_shooter_bench --sweep [--sweep-max ENEMIES] [--min-time SECONDS] [--output FILE]
+
+#include "game_simulation.h"
+#include "audio_manager.h"
+#include "model.h"
+#include "stb_easy_font.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Written with the result of every measured call so the work is not optimized away
+volatile float sink;
+
+// Game code logs to std::cout (hits, explosions, model import progress); that
+// output is dropped while benchmarks run so it neither floods the terminal nor
+// ends up in the timings as console I/O
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double nsPerIteration;
+    double itemsPerIteration;   // work units in one iteration (pairs, enemies, bytes, ...)
+};
+
+std::vector<Result> results;
+std::string filter;
+double minSeconds = 0.5;
+
+bool selected(const std::string& name) {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+// Runs setup() untimed and then body() `batch` times, until at least minSeconds
+// of body time is measured. Stateful benchmarks restore their state in setup, so
+// every batch sees the same workload; the first batch is a warm-up.
+template <typename Setup, typename Body>
+void run(const std::string& name, double items, uint64_t batch, Setup setup, Body body) {
+    if (!selected(name)) return;
+
+    setup();
+    for (uint64_t i = 0; i < batch; i++) body();
+
+    uint64_t iterations = 0;
+    double seconds = 0.0;
+    while (seconds < minSeconds) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < batch; i++) body();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        iterations += batch;
+    }
+    results.push_back({name, iterations, seconds * 1e9 / iterations, items});
+    std::cerr << name << ": " << results.back().nsPerIteration << " ns (" << iterations << " iterations)" << std::endl;
+}
+
+template <typename Body>
+void run(const std::string& name, double items, uint64_t batch, Body body) {
+    run(name, items, batch, [] {}, body);
+}
+
+// 0..1, the same sequence on every run
+float random01() {
+    static unsigned int state = 12345;
+    state = state * 1103515245u + 12345u;
+    return static_cast<float>((state >> 8) & 0xFFFF) / 65535.0f;
+}
+
+// Builds a columns x rows formation over the area of the game's one, with the
+// enemies shrunk to the spacing as in swarm mode; 10x3 is exactly the game's layout
+void layoutFormation(int columns, int rows) {
+    formation.columns = columns;
+    formation.rows = rows;
+    formation.spacingX = columns > 1 ? 4.5f / (columns - 1) : 0.0f;
+    formation.spacingY = rows > 1 ? 1.0f / (rows - 1) : 0.0f;
+    formation.startX = -3.0f;
+    formation.startY = 2.0f;
+    float spacing = std::min(columns > 1 ? formation.spacingX : 0.5f, rows > 1 ? formation.spacingY : 0.5f);
+    formation.enemySize = std::min(1.0f, spacing / 0.5f);
+    initializeEnemies();
+    aliveEnemyPositions.reserve(enemies.size());
+}
+
+// Game state at the start of level 1, with the enemies of layoutFormation
+void resetSimulation(int columns, int rows) {
+    layoutFormation(columns, rows);
+    for (Bullet& bullet : bullets) bullet = Bullet();
+    for (EnemyBullet& bullet : enemyBullets) bullet = EnemyBullet();
+    for (Explosion& explosion : explosions) explosion = Explosion();
+    gameState = GameState::PLAYING;
+    playerScore = 0;
+    playerLives = 3;
+    playerPosition = glm::vec3(0.0f, -2.5f, 0.0f);
+    simulationTime = 0.0;
+    currentLevelConfig = levelConfigs[0];
+    lastAttackTime = 0.0f;
+    lastNonAttackingShootTime = 0.0f;
+}
+
+struct Formation {
+    int columns, rows;
+};
+const Formation FORMATIONS[] = {{10, 3}, {40, 12}, {100, 30}};
+
+std::string formationName(const Formation& formation) {
+    return "enemies:" + std::to_string(formation.columns * formation.rows);
+}
+
+void benchmarkCollision() {
+    const int PAIRS = 4096;
+    std::vector<glm::vec2> positions(2 * PAIRS);
+    for (glm::vec2& position : positions) position = glm::vec2(random01() * 8.0f - 4.0f, random01() * 6.0f - 3.0f);
+
+    run("checkCollision/pairs:" + std::to_string(PAIRS), PAIRS, 64, [&] {
+        int hits = 0;
+        for (int i = 0; i < PAIRS; i++) {
+            hits += checkCollision(positions[2 * i], 0.05f, positions[2 * i + 1], 0.12f);
+        }
+        sink = static_cast<float>(hits);
+    });
+}
+
+void benchmarkBullets() {
+    for (const Formation& formation : FORMATIONS) {
+        resetSimulation(formation.columns, formation.rows);
+        // every bullet in flight below the formation; with deltaTime 0 they stay
+        // there, so each call tests every bullet against every enemy (no hit ends
+        // a scan early), the most a tick can cost
+        for (size_t i = 0; i < bullets.size(); i++) {
+            bullets[i].position = glm::vec2(-3.5f + 7.0f * i / bullets.size(), -1.5f);
+            bullets[i].velocity = glm::vec2(0.0f, 6.0f);
+            bullets[i].isActive = true;
+        }
+        double pairs = static_cast<double>(bullets.size()) * enemies.size();
+        run("updateBullets/" + formationName(formation), pairs, 64, [] {
+            updateBullets(0.0f);
+            sink = bullets[0].position.y;
+        });
+    }
+}
+
+void benchmarkEnemies() {
+    // 10 seconds of level 1 per batch at the game's 120 Hz tick: dives, shots
+    // and the formation sway, restarted from the same state every batch
+    const float TICK = 1.0f / 120.0f;
+    for (const Formation& formation : FORMATIONS) {
+        run("updateEnemies/" + formationName(formation), formation.columns * formation.rows, 1200,
+            [&] { resetSimulation(formation.columns, formation.rows); },
+            [&] {
+                simulationTime += TICK;
+                updateEnemies(TICK);
+                sink = static_cast<float>(aliveEnemyPositions.size());
+            });
+    }
+}
+
+void benchmarkAttackCurve() {
+    // divers of all three patterns, spread over the curve and the straight exit after it
+    const int DIVERS = 1024;
+    std::vector<Enemy> divers(DIVERS);
+    for (int i = 0; i < DIVERS; i++) {
+        divers[i].attackPattern = i % 3;
+        divers[i].attackTimer = 4.5f * i / DIVERS;
+        divers[i].attackStartPos = glm::vec2(random01() * 6.0f - 3.0f, 1.0f + random01());
+        divers[i].attackTargetPos = glm::vec2(random01() * 2.0f - 1.0f, -3.5f);
+        divers[i].attackSpeed = 0.8f;
+    }
+    playerPosition = glm::vec3(0.0f, -2.5f, 0.0f);
+
+    run("calculateCurvedAttackPosition/divers:" + std::to_string(DIVERS), DIVERS, 64, [&] {
+        glm::vec2 sum(0.0f);
+        for (const Enemy& diver : divers) sum += calculateCurvedAttackPosition(diver);
+        sink = sum.x + sum.y;
+    });
+}
+
+void benchmarkTextLayout() {
+    // what the HUD and the menu lay out when their text changes
+    const char* const HUD[] = {"LEVEL: 10", "SCORE: 123450", "LIVES: 3"};
+    const char* const MENU[] = {"INVADERS 1999", "CLICK TO START", "PRESS ESC TO QUIT"};
+    static char buffer[64 * 1024];
+
+    auto layout = [](const char* const* strings, int count) {
+        int characters = 0;
+        for (int i = 0; i < count; i++) characters += static_cast<int>(strlen(strings[i]));
+        return characters;
+    };
+    run("stb_easy_font_print/hud", layout(HUD, 3), 256, [&] {
+        int quads = 0;
+        for (const char* text : HUD) quads += stb_easy_font_print(0.0f, 0.0f, const_cast<char*>(text), nullptr, buffer, sizeof(buffer));
+        sink = static_cast<float>(quads);
+    });
+    run("stb_easy_font_print/menu", layout(MENU, 3), 256, [&] {
+        int quads = 0;
+        for (const char* text : MENU) quads += stb_easy_font_print(0.0f, 0.0f, const_cast<char*>(text), nullptr, buffer, sizeof(buffer));
+        sink = static_cast<float>(quads);
+    });
+}
+
+void benchmarkWavDecode(const std::string& resources) {
+    // the sound effects the game loads; AudioManager::loadSound is decodeWAV plus
+    // an alBufferData upload, which needs an audio device and is not timed here
+    const char* const SOUNDS[] = {
+        "Explosion/Retro Explosion Short 01.wav",
+        "Weapon/laser/Retro Gun Laser SingleShot 01.wav",
+        "Impact/Retro Impact LoFi 09.wav",
+    };
+    for (const char* sound : SOUNDS) {
+        std::string path = resources + "/audio/FreeSFX/GameSFX/" + sound;
+        std::error_code error;
+        uintmax_t bytes = fs::file_size(path, error);
+        if (error) {
+            std::cerr << "WARNING::BENCH::Skipping decodeWAV, " << path << " not found" << std::endl;
+            continue;
+        }
+        run("AudioManager::decodeWAV/" + fs::path(sound).filename().string(), static_cast<double>(bytes), 16, [&] {
+            SoundData data;
+            AudioManager::decodeWAV(path, data);
+            sink = static_cast<float>(data.size());
+        });
+    }
+}
+
+void benchmarkModelImport(const std::string& resources) {
+    // Model::processMesh is private and needs an aiScene, so the whole import is
+    // timed the way a loader thread runs it: Assimp parse, processMesh for every
+    // mesh and the optional mesh optimizer, no cache and no GL upload
+    const std::string NAME = "Model::import/MeteorSlicer.obj";
+    std::string path = resources + "/Package/MeteorSlicer.obj";
+    if (!selected(NAME) && !selected(NAME + "/optimized")) return;
+    if (!fs::exists(path)) {
+        std::cerr << "WARNING::BENCH::Skipping model import, " << path << " not found" << std::endl;
+        return;
+    }
+    try {
+        ModelImportOptions options;
+        options.deferUpload = true;
+        Model model(path, false, options);
+    } catch (const std::exception& e) {
+        std::cerr << "WARNING::BENCH::Skipping model import, " << path << " failed to load: " << e.what() << std::endl;
+        return;
+    }
+    for (bool optimize : {false, true}) {
+        ModelImportOptions options;
+        options.deferUpload = true;
+        options.optimize = optimize;
+        run(optimize ? NAME + "/optimized" : NAME, 1, 1, [&] {
+            Model model(path, false, options);
+            sink = static_cast<float>(model.loadMilliseconds);
+        });
+    }
+}
+
+// ===== SCALING SWEEP =====
+const int SWEEP_SIZES[] = {30, 100, 300, 1000, 3000, 10000, 30000, 100000};
+const int SWEEP_MAX_TICKS = 600;
+// log-log slope between two sizes above which an update counts as super-linear
+const double SUPERLINEAR_EXPONENT = 1.25;
+
+enum SweepSystem { SWEEP_ENEMIES, SWEEP_BULLETS, SWEEP_ENEMY_BULLETS, SWEEP_EXPLOSIONS, SWEEP_TICK, SWEEP_SYSTEMS };
+const char* const SWEEP_SYSTEM_NAMES[SWEEP_SYSTEMS] = {"enemies", "bullets", "enemy_bullets", "explosions", "tick"};
+
+struct SweepRow {
+    int ticks;
+    size_t entities[SWEEP_SYSTEMS];     // pool sizes; the tick's is their sum
+    double nsPerTick[SWEEP_SYSTEMS];
+};
+
+// Refills whatever the last tick used up, so every tick sees the same load:
+// dead enemies back in formation, every bullet and enemy bullet in flight
+void refillSweepWorkload() {
+    gameState = GameState::PLAYING;
+    playerLives = 3;
+    for (Enemy& enemy : enemies) {
+        if (!enemy.isAlive) {
+            enemy.isAlive = true;
+            enemy.isAttacking = false;
+            enemy.position = enemy.formationPosition;
+        }
+    }
+    for (Bullet& bullet : bullets) {
+        if (bullet.isActive) continue;
+        bullet.position = glm::vec2(random01() * 8.0f - 4.0f, -2.5f);
+        bullet.velocity = glm::vec2(0.0f, 6.0f);
+        bullet.isActive = true;
+    }
+    for (EnemyBullet& bullet : enemyBullets) {
+        if (bullet.isActive) continue;
+        bullet.position = glm::vec2(random01() * 8.0f - 4.0f, 1.0f + random01());
+        bullet.velocity = glm::vec2(random01() - 0.5f, -3.0f);
+        bullet.isActive = true;
+    }
+}
+
+SweepRow sweepSize(int size) {
+    // the game's proportions: 10 bullets, 20 enemy bullets and 20 explosions per 30 enemies
+    int columns = std::max(1, static_cast<int>(std::lround(std::sqrt(size * 10.0 / 3.0))));
+    int rows = std::max(1, static_cast<int>(std::lround(static_cast<double>(size) / columns)));
+    resetSimulation(columns, rows);
+    bullets.assign(std::max(1, size / 3), Bullet());
+    enemyBullets.assign(std::max(1, size * 2 / 3), EnemyBullet());
+    explosions.assign(std::max(1, size * 2 / 3), Explosion());
+
+    SweepRow row = {};
+    row.entities[SWEEP_ENEMIES] = enemies.size();
+    row.entities[SWEEP_BULLETS] = bullets.size();
+    row.entities[SWEEP_ENEMY_BULLETS] = enemyBullets.size();
+    row.entities[SWEEP_EXPLOSIONS] = explosions.size();
+    row.entities[SWEEP_TICK] = enemies.size() + bullets.size() + enemyBullets.size() + explosions.size();
+
+    const float TICK = 1.0f / 120.0f;
+    double elapsed[SWEEP_SYSTEMS] = {};
+    auto tick = [&] {
+        refillSweepWorkload();
+        simulationTime += TICK;
+        auto t0 = std::chrono::steady_clock::now();
+        updateEnemies(TICK);
+        auto t1 = std::chrono::steady_clock::now();
+        updateBullets(TICK);
+        auto t2 = std::chrono::steady_clock::now();
+        updateEnemyBullets(TICK);
+        auto t3 = std::chrono::steady_clock::now();
+        updateExplosions(TICK);
+        auto t4 = std::chrono::steady_clock::now();
+        elapsed[SWEEP_ENEMIES] += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        elapsed[SWEEP_BULLETS] += std::chrono::duration<double, std::nano>(t2 - t1).count();
+        elapsed[SWEEP_ENEMY_BULLETS] += std::chrono::duration<double, std::nano>(t3 - t2).count();
+        elapsed[SWEEP_EXPLOSIONS] += std::chrono::duration<double, std::nano>(t4 - t3).count();
+        elapsed[SWEEP_TICK] += std::chrono::duration<double, std::nano>(t4 - t0).count();
+    };
+
+    // warm up until the bullets are spread over their whole flight (one second
+    // of play), or for at most --min-time on the large sizes
+    for (int i = 0; i < 120 && elapsed[SWEEP_TICK] < minSeconds * 1e9; i++) tick();
+    std::fill(std::begin(elapsed), std::end(elapsed), 0.0);
+    while (row.ticks < SWEEP_MAX_TICKS && (row.ticks == 0 || elapsed[SWEEP_TICK] < minSeconds * 1e9)) {
+        tick();
+        row.ticks++;
+    }
+    for (int system = 0; system < SWEEP_SYSTEMS; system++) row.nsPerTick[system] = elapsed[system] / row.ticks;
+    return row;
+}
+
+void writeSweepCSV(std::ostream& out, const std::vector<SweepRow>& rows) {
+    out << "entities";
+    for (int system = 0; system < SWEEP_TICK; system++) out << "," << SWEEP_SYSTEM_NAMES[system];
+    out << ",ticks";
+    for (int system = 0; system < SWEEP_TICK; system++) out << "," << SWEEP_SYSTEM_NAMES[system] << "_ns_per_entity";
+    out << ",tick_us";
+    for (const char* name : SWEEP_SYSTEM_NAMES) out << "," << name << "_exponent";
+    out << ",superlinear\n";
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const SweepRow& row = rows[i];
+        out << row.entities[SWEEP_TICK];
+        for (int system = 0; system < SWEEP_TICK; system++) out << "," << row.entities[system];
+        out << "," << row.ticks;
+        for (int system = 0; system < SWEEP_TICK; system++) out << "," << row.nsPerTick[system] / row.entities[system];
+        out << "," << row.nsPerTick[SWEEP_TICK] / 1000.0;
+
+        // growth of the time per tick against growth of the entities since the
+        // previous size: 1 is linear, 2 quadratic
+        std::string superlinear;
+        for (int system = 0; system < SWEEP_SYSTEMS; system++) {
+            out << ",";
+            if (i == 0) continue;
+            const SweepRow& previous = rows[i - 1];
+            double exponent = std::log(row.nsPerTick[system] / previous.nsPerTick[system]) /
+                              std::log(static_cast<double>(row.entities[system]) / previous.entities[system]);
+            out << exponent;
+            if (exponent > SUPERLINEAR_EXPONENT) {
+                superlinear += (superlinear.empty() ? "" : ";") + std::string(SWEEP_SYSTEM_NAMES[system]);
+                std::cerr << "WARNING::SWEEP::" << SWEEP_SYSTEM_NAMES[system] << " grows super-linearly from "
+                          << previous.entities[SWEEP_TICK] << " to " << row.entities[SWEEP_TICK] << " entities (exponent "
+                          << exponent << ")" << std::endl;
+            }
+        }
+        out << "," << (superlinear.empty() ? "-" : superlinear) << "\n";
+    }
+}
+
+std::vector<SweepRow> runSweep(int maxEnemies) {
+    std::vector<SweepRow> rows;
+    for (int size : SWEEP_SIZES) {
+        if (size > maxEnemies) break;
+        rows.push_back(sweepSize(size));
+        const SweepRow& row = rows.back();
+        std::cerr << "Sweep " << row.entities[SWEEP_TICK] << " entities (" << row.entities[SWEEP_ENEMIES]
+                  << " enemies): " << row.nsPerTick[SWEEP_TICK] / 1000.0 << " us/tick over " << row.ticks << " ticks"
+                  << std::endl;
+    }
+    return rows;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+void writeJSON(std::ostream& out, const char* executable) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": " << jsonString(date) << ",\n"
+        << "    \"executable\": " << jsonString(executable) << ",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+        << "    \"library_build_type\": \"release\",\n"
+#else
+        << "    \"library_build_type\": \"debug\",\n"
+#endif
+        << "    \"min_time\": " << minSeconds << "\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        // single-threaded, so CPU time is reported as the measured wall time
+        out << (i ? "," : "") << "\n    {\n"
+            << "      \"name\": " << jsonString(result.name) << ",\n"
+            << "      \"run_name\": " << jsonString(result.name) << ",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"repetitions\": 1,\n"
+            << "      \"repetition_index\": 0,\n"
+            << "      \"threads\": 1,\n"
+            << "      \"iterations\": " << result.iterations << ",\n"
+            << "      \"real_time\": " << result.nsPerIteration << ",\n"
+            << "      \"cpu_time\": " << result.nsPerIteration << ",\n"
+            << "      \"time_unit\": \"ns\",\n"
+            << "      \"items_per_second\": " << result.itemsPerIteration * 1e9 / result.nsPerIteration << "\n"
+            << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    // resources/ next to the working directory, as the game looks for it
+    std::string resources = (fs::current_path().parent_path() / "resources").string();
+    std::string outputPath;
+    bool sweep = false;
+    int sweepMax = SWEEP_SIZES[std::size(SWEEP_SIZES) - 1];
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sweep") sweep = true;
+        else if (arg == "--sweep-max" && i + 1 < argc) sweepMax = std::atoi(argv[++i]);
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) minSeconds = std::atof(argv[++i]);
+        else if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+        else if (arg == "--resources" && i + 1 < argc) resources = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter SUBSTRING] [--min-time SECONDS] [--output FILE]"
+                      << " [--resources DIR]\n       " << argv[0] << " --sweep [--sweep-max ENEMIES]"
+                      << " [--min-time SECONDS] [--output FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+    std::vector<SweepRow> sweepRows;
+    if (sweep) {
+        sweepRows = runSweep(sweepMax);
+    } else {
+        benchmarkCollision();
+        benchmarkBullets();
+        benchmarkEnemies();
+        benchmarkAttackCurve();
+        benchmarkTextLayout();
+        benchmarkWavDecode(resources);
+        benchmarkModelImport(resources);
+    }
+    std::cout.rdbuf(coutBuffer);
+
+    std::ofstream file;
+    if (!outputPath.empty()) file.open(outputPath);
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+    if (sweep) writeSweepCSV(out, sweepRows);
+    else writeJSON(out, argv[0]);
+    if (!outputPath.empty()) {
+        if (!file) {
+            std::cerr << "ERROR::BENCH::Failed to write " << outputPath << std::endl;
+            return 1;
+        }
+        std::cerr << "Wrote " << (sweep ? sweepRows.size() : results.size()) << " results to " << outputPath << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+# Converts every *.vs / *.fs file in SHADER_DIR into a header of constexpr
+# string tables, so shader sources are compiled into the executable.
+#
+# Usage: cmake -DSHADER_DIR=<dir> -DOUTPUT=<header> -P EmbedShaders.cmake
+
+if(NOT SHADER_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "EmbedShaders.cmake needs SHADER_DIR and OUTPUT")
+endif()
+
+file(GLOB SHADER_FILES "${SHADER_DIR}/*.vs" "${SHADER_DIR}/*.fs")
+list(SORT SHADER_FILES)
+
+set(CONTENT "// Generated by EmbedShaders.cmake from the shader directory - do not edit.\n")
+string(APPEND CONTENT "#ifndef EMBEDDED_SHADERS_H\n#define EMBEDDED_SHADERS_H\n\n#include <cstring>\n\n")
+string(APPEND CONTENT "struct EmbeddedShader {\n    const char* name;   // file name, e.g. \"enemy.vs\"\n    const char* source;\n};\n\n")
+string(APPEND CONTENT "inline constexpr EmbeddedShader EMBEDDED_SHADERS[] = {\n")
+
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(SHADER_NAME "${SHADER_FILE}" NAME)
+    file(READ "${SHADER_FILE}" SHADER_SOURCE)
+    string(APPEND CONTENT "    {\"${SHADER_NAME}\", R\"SHADER(${SHADER_SOURCE})SHADER\"},\n")
+endforeach()
+
+string(APPEND CONTENT "};\n\n")
+string(APPEND CONTENT "inline constexpr int EMBEDDED_SHADER_COUNT = sizeof(EMBEDDED_SHADERS) / sizeof(EMBEDDED_SHADERS[0]);\n\n")
+string(APPEND CONTENT "// Returns the embedded source for a shader file name, or nullptr if it was not embedded\n")
+string(APPEND CONTENT "inline const char* findEmbeddedShader(const char* name) {\n")
+string(APPEND CONTENT "    for (int i = 0; i < EMBEDDED_SHADER_COUNT; i++) {\n")
+string(APPEND CONTENT "        if (std::strcmp(EMBEDDED_SHADERS[i].name, name) == 0) return EMBEDDED_SHADERS[i].source;\n")
+string(APPEND CONTENT "    }\n    return nullptr;\n}\n\n#endif\n")
+
+# Only touch the header when it changed so dependents are not rebuilt needlessly
+set(TMP_OUTPUT "${OUTPUT}.tmp")
+file(WRITE "${TMP_OUTPUT}" "${CONTENT}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${TMP_OUTPUT}" "${OUTPUT}")
+file(REMOVE "${TMP_OUTPUT}")
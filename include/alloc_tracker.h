@@ -0,0 +1,31 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Counts heap allocations made through operator new, separately for every
+// thread. alloc_tracker.cpp replaces the global operator new/delete family, so
+// linking it into an executable is all it takes; each counter is a thread_local
+// increment, cheap enough to leave on in release builds. Memory allocated with
+// malloc directly (C libraries, drivers) is not seen.
+class AllocationTracker {
+public:
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Everything the calling thread has allocated since it started; take the
+    // difference of two calls to count a frame
+    static Counts thisThread();
+};
+
+inline AllocationTracker::Counts operator-(const AllocationTracker::Counts& a, const AllocationTracker::Counts& b) {
+    AllocationTracker::Counts difference;
+    difference.allocations = a.allocations - b.allocations;
+    difference.bytes = a.bytes - b.bytes;
+    return difference;
+}
+
+#endif
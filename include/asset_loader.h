@@ -0,0 +1,81 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "model.h"
+#include "texture_cache.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AudioManager;
+
+// Loads assets on a pool of worker threads. A job does the CPU side of a load
+// (file reads, image/WAV decoding, model import) on a worker and returns the
+// step that still needs the GL (or AL) context; pumpUploads() runs those steps
+// on the calling thread in completion order, within a per-frame time budget.
+// enqueue, the load* helpers and pumpUploads must all be called from the GL thread.
+class AssetLoader {
+public:
+    using UploadStep = std::function<void()>;
+    using Job = std::function<UploadStep()>;   // an empty UploadStep means the load failed
+
+    // 0 workers runs each job inside enqueue() (serial loading, uploads still go through pumpUploads)
+    explicit AssetLoader(unsigned int workerCount = defaultWorkerCount());
+    // waits for running jobs; queued jobs and pending uploads are dropped
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // one worker per hardware thread, leaving one for the GL thread
+    static unsigned int defaultWorkerCount();
+
+    void enqueue(const std::string& name, Job job);
+
+    // onLoaded runs on the GL thread with the acquired TextureCache reference
+    void loadTexture(const std::string& path, const TextureLoadOptions& options,
+                     std::function<void(unsigned int)> onLoaded);
+    // imports on a worker (ModelImportOptions::deferUpload) and calls Model::upload() before onLoaded
+    void loadModel(const std::string& path, bool gamma, const ModelImportOptions& options,
+                   std::function<void(Model*)> onLoaded);
+    void loadSound(AudioManager& audio, const std::string& name, const std::string& path,
+                   std::function<void()> onLoaded = nullptr);
+
+    // Runs finished upload steps until budgetMilliseconds is spent (always at
+    // least one if any is ready); returns how many ran
+    int pumpUploads(double budgetMilliseconds);
+
+    // Blocks until every enqueued job has been uploaded
+    void finish();
+
+    int totalCount() const { return total; }
+    int completedCount() const { return completed; }
+    bool isFinished() const { return completed == total; }
+    unsigned int workerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    struct Finished {
+        std::string name;
+        UploadStep upload;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<std::pair<std::string, Job>> jobs;
+    std::deque<Finished> finished;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+    bool stopping = false;
+    int total = 0;          // GL thread only
+    int completed = 0;
+
+    void workerLoop();
+    static Finished runJob(const std::string& name, Job& job);
+    void runUpload(Finished& item);
+};
+
+#endif
@@ -7,6 +7,18 @@
 #include <unordered_map>
 #include <vector>
 
+// PCM samples of a decoded WAV file, ready for alBufferData
+struct SoundData {
+    ALenum format = AL_FORMAT_MONO16;
+    std::vector<char> samples;              // copied out of a loose WAV file
+    const char* mappedSamples = nullptr;    // or left in the mounted ResourcePack
+    size_t mappedSize = 0;
+    ALsizei sampleRate = 0;
+
+    const char* data() const { return mappedSamples ? mappedSamples : samples.data(); }
+    size_t size() const { return mappedSamples ? mappedSize : samples.size(); }
+};
+
 class AudioManager {
 private:
     ALCdevice* device;
@@ -22,6 +34,10 @@ public:
     bool initialize();
     void cleanup();
     bool loadSound(const std::string& name, const std::string& filepath);
+    // decodeWAV only touches the file and may run on a loader thread; the buffer
+    // is created by loadSound(name, sound) on the thread that owns the AL context
+    static bool decodeWAV(const std::string& filepath, SoundData& sound);
+    bool loadSound(const std::string& name, const SoundData& sound);
     void playSound(const std::string& name, float volume = 1.0f, float pitch = 1.0f, bool loop = false);
     void stopSound(const std::string& name);
     void stopAllSounds();
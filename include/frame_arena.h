@@ -0,0 +1,50 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// Lets GCC and Clang check format() calls against their arguments (-Wformat);
+// the implicit this pointer is argument 1
+#if defined(__GNUC__) || defined(__clang__)
+#define FRAME_ARENA_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define FRAME_ARENA_PRINTF_FORMAT
+#endif
+
+// Linear allocator for temporaries that live until the end of a frame (text
+// vertices, formatted HUD strings). allocate() bumps an offset into one block and
+// reset() at the start of the next frame releases everything at once. A frame
+// that outgrows the block falls back to the heap, and the next reset() grows the
+// block to what that frame needed, so after warm-up a frame never allocates.
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // printf into the arena; the string is valid until reset()
+    const char* format(const char* fmt, ...) FRAME_ARENA_PRINTF_FORMAT;
+
+    void reset();
+
+    size_t capacity() const { return blockSize; }
+    size_t used() const { return demand; }      // bytes handed out this frame
+
+private:
+    unsigned char* block;
+    size_t blockSize;
+    size_t offset;
+    size_t demand;
+    std::vector<void*> overflow;    // heap blocks for this frame's requests past the end of block
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <functional>
+
+// Caps the frame rate of the main loop. Deadlines advance by a fixed period
+// from one frame to the next, so the average rate holds even when single frames
+// run late; a frame more than a period behind restarts the schedule instead of
+// bursting to catch up.
+//
+// waitForNextFrame() sleeps while more than SPIN_THRESHOLD_SECONDS remain (OS
+// sleeps overshoot by up to a scheduler tick) and spins for the rest. When
+// precision matters less than waking for input, as in the menu, pass a blocking
+// wait such as glfwWaitEventsTimeout instead; it can end the wait early.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double SPIN_THRESHOLD_SECONDS = 0.002;
+    static constexpr double REPORT_INTERVAL_SECONDS = 60.0;
+
+    // Power-relevant counters over one report interval
+    struct Report {
+        double seconds;         // wall time covered
+        int frames;             // frames rendered
+        double cpuSeconds;      // process CPU time (all threads)
+        double waitedSeconds;   // time spent blocked in waitForNextFrame
+    };
+
+    FramePacer();
+    ~FramePacer();
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // 0 renders uncapped
+    void setTargetRate(double framesPerSecond);
+    double targetRate() const { return rate; }
+
+    // Seconds until the next frame is due, 0 if uncapped or already late
+    double timeUntilNextFrame() const;
+    void waitForNextFrame();
+    // Calls block(seconds left) until the deadline; block may return early, and
+    // returning true ends the wait so the next frame starts now (e.g. on input)
+    void waitForNextFrame(const std::function<bool(double)>& block);
+
+    // Call when a frame starts; schedules the one after it
+    void beginFrame();
+
+    // Process CPU time in seconds, user plus system
+    static double processCpuSeconds();
+
+    // True once every REPORT_INTERVAL_SECONDS, with the counters since the last report
+    bool takeReport(Report& report);
+
+private:
+    double rate = 0.0;
+    Clock::duration period = Clock::duration::zero();
+    Clock::time_point deadline;
+
+    Clock::time_point reportStart;
+    double reportCpuStart;
+    int reportFrames = 0;
+    double reportWaited = 0.0;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef GAME_SIMULATION_H
+#define GAME_SIMULATION_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Game logic shared by the game (main.cpp, which defines everything declared
+// here) and bench/space_shooter_bench.cpp, which drives the update functions
+// without a window.
+
+enum EnemyType {
+    GRUNT = 0,
+    SERGEANT = 1,
+    CAPTAIN = 2
+};
+
+struct Enemy {
+    glm::vec2 position;
+    glm::vec2 previousPosition;  // at the previous simulation tick, for render interpolation
+    glm::vec2 velocity;
+    bool isAlive;
+    EnemyType type;
+    float health;
+    float scale;
+    float animationTimer;
+    bool isAttacking;
+    glm::vec2 formationPosition; // Original formation position
+    
+    // Curved attack variables (Galaxian style)
+    float attackTimer;           // Time since attack started
+    glm::vec2 attackStartPos;    // Position where attack began
+    glm::vec2 attackTargetPos;   // Target position for attack
+    int attackPattern;           // 0=left curve, 1=right curve, 2=direct
+    float attackSpeed;           // Speed of attack movement
+    bool hasFired;              // Whether the enemy has already fired in the current attack
+    int bulletsFired;           // Number of bullets fired during current attack
+
+    Enemy() : position(0.0f), previousPosition(0.0f), velocity(0.0f), isAlive(true), type(GRUNT),
+              health(1.0f), scale(1.0f), animationTimer(0.0f),
+              isAttacking(false), formationPosition(0.0f),
+              attackTimer(0.0f), attackStartPos(0.0f), attackTargetPos(0.0f),
+              attackPattern(0), attackSpeed(0.7f), hasFired(false), bulletsFired(0) {}
+};
+
+struct Bullet {
+    glm::vec2 position;
+    glm::vec2 previousPosition;
+    glm::vec2 velocity;
+    bool isActive;
+    
+    Bullet() : position(0.0f), previousPosition(0.0f), velocity(0.0f), isActive(false) {}
+};
+
+struct EnemyBullet {
+    glm::vec2 position;
+    glm::vec2 previousPosition;
+    glm::vec2 velocity;
+    bool isActive;
+    
+    EnemyBullet() : position(0.0f), previousPosition(0.0f), velocity(0.0f), isActive(false) {}
+};
+
+struct Explosion {
+    glm::vec2 position;
+    float timer;
+    float duration;
+    bool isActive;
+    
+    Explosion() : position(0.0f), timer(0.0f), duration(1.0f), isActive(false) {}
+};
+
+// Level difficulty parameters
+struct LevelConfig {
+    float enemySpeed;           // Base enemy movement speed
+    float formationSwaySpeed;   // How fast formation moves side to side
+    float formationSwayAmount; // How far formation moves side to side
+    float attackInterval;      // Time between enemy attacks
+    float attackSpeed;         // Speed of attacking enemies
+    int maxSimultaneousAttacks; // Max enemies attacking at once
+    float bulletSpeedMultiplier; // Enemy bullet speed (if you add enemy bullets)
+    
+    LevelConfig(float speed = 1.0f, float swaySpeed = 0.5f, float swayAmount = 0.3f,
+                float interval = 2.0f, float attackSpd = 0.8f, int maxAttacks = 2)
+        : enemySpeed(speed), formationSwaySpeed(swaySpeed), formationSwayAmount(swayAmount),
+          attackInterval(interval), attackSpeed(attackSpd), maxSimultaneousAttacks(maxAttacks),
+          bulletSpeedMultiplier(1.0f) {}
+};
+
+enum class GameState { 
+    MENU, 
+    PLAYING, 
+    LEVEL_COMPLETE,
+    GAME_OVER, 
+    GAME_WON 
+};
+
+// Enemy grid built by initializeEnemies, row by row from (startX, startY)
+struct FormationConfig {
+    int columns;
+    int rows;
+    float spacingX;
+    float spacingY;
+    float startX;
+    float startY;
+    float enemySize;    // sprite and collision scale; 1 is the classic formation's
+
+    int count() const { return columns * rows; }
+};
+
+// ===== STATE =====
+extern GameState gameState;
+extern int playerScore;
+extern int playerLives;
+extern glm::vec3 playerPosition;
+extern double simulationTime;           // end of the last tick; updateEnemies reads the clock from it
+extern std::vector<LevelConfig> levelConfigs;
+extern LevelConfig currentLevelConfig;
+extern float lastAttackTime;
+extern float lastNonAttackingShootTime;
+extern FormationConfig formation;
+
+// Updates run over whole vectors, so the pool capacities are their sizes;
+// initializeEnemies sizes enemies to the formation
+extern std::vector<Enemy> enemies;
+extern std::vector<Bullet> bullets;
+extern std::vector<EnemyBullet> enemyBullets;
+extern std::vector<Explosion> explosions;
+extern std::vector<glm::vec2> aliveEnemyPositions;
+
+// ===== UPDATES =====
+bool checkCollision(glm::vec2 pos1, float radius1, glm::vec2 pos2, float radius2);
+glm::vec2 calculateCurvedAttackPosition(const Enemy& enemy);
+void initializeEnemies();
+void initializeLevel(int level);
+void updateBullets(float deltaTime);
+void updateEnemies(float deltaTime);
+void updateEnemyBullets(float deltaTime);
+void updateExplosions(float deltaTime);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <string>
+#include <vector>
+
+// Command line options for --headless runs
+struct HeadlessOptions {
+    bool enabled = false;
+    int frames = 600;                   // number of frames to render before exiting
+    float timestep = 1.0f / 60.0f;      // virtual seconds advanced per frame (deterministic)
+    std::string outputDir = "headless_out";
+    std::vector<int> dumpFrames;        // frame indices written as PNG
+    int starfieldBenchFrames = 0;       // > 0 runs the starfield benchmark instead of the game
+    int particleBenchCount = 0;         // > 0 runs the particle benchmark with this many particles
+    int textBenchFrames = 0;            // > 0 runs the bitmap vs SDF text benchmark instead of the game
+    bool checkAllocations = false;      // fail the run if a PLAYING frame allocates after warm-up
+    int allocationWarmupFrames = 120;   // PLAYING frames --check-allocations lets allocate first
+};
+
+// Parses --headless, --frames N, --timestep S, --output-dir DIR, --dump-frames a,b,c
+// --bench-starfield N, --bench-particles N, --bench-text N, --check-allocations and --allocation-warmup N.
+// Returns false (after printing the reason) on malformed arguments.
+bool parseHeadlessArgs(int argc, char *argv[], HeadlessOptions& options);
+
+// Offscreen OpenGL 3.3 core context without a window. Uses EGL (surfaceless
+// platform when available, otherwise a pbuffer) so it also works with Mesa
+// llvmpipe on machines without a GPU or display server.
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    bool create(int width, int height);
+    void destroy();
+
+    // Loader for gladLoadGLLoader
+    static void* getProcAddress(const char* name);
+
+    // Offscreen framebuffer standing in for the window's default framebuffer
+    unsigned int framebuffer() const { return fbo; }
+
+    // Reads the offscreen framebuffer as top-down RGBA8 rows
+    void readPixels(std::vector<unsigned char>& rgba) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    void* display;
+    void* context;
+    void* surface;
+    unsigned int fbo;
+    unsigned int colorRenderbuffer;
+    unsigned int depthRenderbuffer;
+    int width;
+    int height;
+
+    bool createFramebuffer();
+};
+
+// Writes an RGBA8 image as an (uncompressed deflate) PNG file
+bool writePNG(const std::string& path, int width, int height, const unsigned char* rgba);
+
+#endif
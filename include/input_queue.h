@@ -0,0 +1,46 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A key change or a click on a menu button, stamped with the time the window
+// system delivered it (same clock as the game's frame timing). Clicks are hit
+// tested where the menu is laid out, so the simulation only sees what was hit.
+struct InputEvent {
+    enum Type : uint8_t { KEY, START_GAME };
+    Type type;
+    int code;           // GLFW key
+    int action;         // GLFW_PRESS / GLFW_RELEASE
+    double time;        // seconds
+};
+
+// Fixed-size single-producer single-consumer ring of input events. The window
+// callbacks push; the simulation reads events in order with peek() and retires
+// them with pop(), so a consumer can look at events without taking them (late
+// latching reads ahead of the simulation tick). Neither side locks or allocates.
+class InputQueue {
+public:
+    static const size_t CAPACITY = 256;    // power of two
+
+    // false (and the event is dropped) if the consumer has fallen CAPACITY events behind
+    bool push(const InputEvent& event);
+
+    // Events pushed and not yet popped; index 0 is the oldest
+    size_t pending() const;
+    const InputEvent& peek(size_t index) const;
+    void pop(size_t count);
+
+    // Events accepted so far; it changes whenever new input arrives
+    size_t pushedCount() const { return head.load(std::memory_order_acquire); }
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    InputEvent slots[CAPACITY];
+    std::atomic<size_t> head{0};    // next slot the producer writes
+    std::atomic<size_t> tail{0};    // oldest slot the consumer has not popped
+    std::atomic<size_t> dropped{0};
+};
+
+#endif
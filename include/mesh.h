@@ -5,9 +5,13 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/packing.hpp>
 
 #include "shader.h"
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 using namespace std;
@@ -31,6 +35,32 @@ struct Vertex {
 	float m_Weights[MAX_BONE_INFLUENCE];
 };
 
+// GPU-side vertex layout (see Mesh::setupMesh). Vertex above is the import format;
+// on upload it is packed to
+//   location 0: position   3 x float                      12 bytes
+//   location 1: normal     2 x snorm16, octahedral         4 bytes
+//   location 2: texcoords  2 x half float                  4 bytes
+//   location 3: tangent    2 x snorm16 octahedral + sign   8 bytes (meshes with a normal map only)
+// i.e. 20 or 28 bytes instead of 88. Shaders decode the normal with
+//   vec3 n = vec3(o, 1.0 - abs(o.x) - abs(o.y));
+//   if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+//   n = normalize(n);
+const size_t PACKED_VERTEX_BASE_SIZE = 20;
+const size_t PACKED_VERTEX_TANGENT_SIZE = 8;
+
+// Octahedral mapping of a unit vector onto [-1, 1]^2
+inline glm::vec2 octahedralEncode(glm::vec3 n) {
+    float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (sum == 0.0f) return glm::vec2(0.0f);
+    n /= sum;
+    glm::vec2 o(n.x, n.y);
+    if (n.z < 0.0f) {
+        o = (glm::vec2(1.0f) - glm::abs(glm::vec2(n.y, n.x))) *
+            glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return o;
+}
+
 struct Texture {
     unsigned int id;
     string type;
@@ -40,21 +70,83 @@ struct Texture {
 
 class Mesh {
 public:
-    // mesh Data
+    // mesh Data (vertices/indices are emptied after upload unless keepCPUData)
     vector<Vertex>       vertices;
     vector<unsigned int> indices;
     vector<Texture>      textures;
     unsigned int VAO;
+    unsigned int indexCount;
+    GLenum indexType;           // GL_UNSIGNED_SHORT when every index fits in 16 bits
+    bool hasTangents;           // tangent frame uploaded (only meshes with a normal map)
+    size_t gpuBytes;            // vertex + index buffer size
 
     // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures,
+         bool hasNormalMap = false, bool keepCPUData = false)
     {
-        this->vertices = vertices;
-        this->indices = indices;
-        this->textures = textures;
+        this->vertices = std::move(vertices);
+        this->indices = std::move(indices);
+        this->textures = std::move(textures);
+        this->hasTangents = hasNormalMap;
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
         setupMesh();
+
+        if (!keepCPUData) {
+            vector<Vertex>().swap(this->vertices);
+            vector<unsigned int>().swap(this->indices);
+        }
+    }
+
+    // packs vertices into the GPU layout described above (20 or 28 bytes each)
+    static vector<unsigned char> packVertices(const vector<Vertex>& vertices, bool withTangents)
+    {
+        size_t stride = PACKED_VERTEX_BASE_SIZE + (withTangents ? PACKED_VERTEX_TANGENT_SIZE : 0);
+        vector<unsigned char> packed(vertices.size() * stride);
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            const Vertex& vertex = vertices[i];
+            unsigned char* out = &packed[i * stride];
+
+            uint32_t normal = glm::packSnorm2x16(octahedralEncode(vertex.Normal));
+            uint32_t texCoords = glm::packHalf2x16(vertex.TexCoords);
+            std::memcpy(out, &vertex.Position, 12);
+            std::memcpy(out + 12, &normal, 4);
+            std::memcpy(out + 16, &texCoords, 4);
+
+            if (withTangents)
+            {
+                // the bitangent is rebuilt in the shader as sign * cross(normal, tangent)
+                uint32_t tangent = glm::packSnorm2x16(octahedralEncode(vertex.Tangent));
+                float handedness = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f ? -1.0f : 1.0f;
+                uint32_t sign = glm::packSnorm2x16(glm::vec2(handedness, 0.0f));
+                std::memcpy(out + 20, &tangent, 4);
+                std::memcpy(out + 24, &sign, 4);
+            }
+        }
+        return packed;
+    }
+
+    // 16-bit indices halve the index buffer whenever the mesh is small enough
+    static vector<unsigned char> packIndices(const vector<unsigned int>& indices, size_t vertexCount, GLenum& type)
+    {
+        type = vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        vector<unsigned char> packed;
+        if (type == GL_UNSIGNED_SHORT)
+        {
+            packed.resize(indices.size() * sizeof(uint16_t));
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                uint16_t index = static_cast<uint16_t>(indices[i]);
+                std::memcpy(&packed[i * sizeof(uint16_t)], &index, sizeof(uint16_t));
+            }
+        }
+        else
+        {
+            packed.resize(indices.size() * sizeof(unsigned int));
+            std::memcpy(packed.data(), indices.data(), packed.size());
+        }
+        return packed;
     }
 
     // render the mesh
@@ -63,6 +155,7 @@ public:
         // bind appropriate textures
         unsigned int diffuseNr  = 1;
         unsigned int specularNr = 1;
+        unsigned int normalNr   = 1;
 
         for(unsigned int i = 0; i < textures.size(); i++)
         {
@@ -75,6 +168,8 @@ public:
                 number = std::to_string(diffuseNr++);
             else if(name == "texture_specular")
                 number = std::to_string(specularNr++); // transfer unsigned int to string
+            else if(name == "texture_normal")
+                number = std::to_string(normalNr++);
             
             // now set the sampler to the correct texture unit
             glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
@@ -86,7 +181,7 @@ public:
 
         // draw mesh
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, indexCount, indexType, 0);
         glBindVertexArray(0);
 
     }
@@ -95,9 +190,20 @@ private:
     // render data 
     unsigned int VBO, EBO;
 
-    // initializes all the buffer objects/arrays
+    // packs the vertices (see PACKED_VERTEX_BASE_SIZE) and initializes all the buffer objects/arrays
     void setupMesh()
     {
+        vector<unsigned char> packed = packVertices(vertices, hasTangents);
+        vector<unsigned char> packedIndices = packIndices(indices, vertices.size(), indexType);
+        indexCount = static_cast<unsigned int>(indices.size());
+        uploadBuffers(packed.data(), packed.size(), packedIndices.data(), packedIndices.size());
+    }
+
+    void uploadBuffers(const void* vertexData, size_t vertexBytes, const void* indexData, size_t indexBytes)
+    {
+        size_t stride = PACKED_VERTEX_BASE_SIZE + (hasTangents ? PACKED_VERTEX_TANGENT_SIZE : 0);
+        gpuBytes = vertexBytes + indexBytes;
+
         // create buffers/arrays
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -106,24 +212,27 @@ private:
         glBindVertexArray(VAO);
         // load data into vertex buffers
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        // A great thing about structs is that their memory layout is sequential for all its items.
-        // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
-        // again translates to 3/2 floats which translates to a byte array.
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);  
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indexData, GL_STATIC_DRAW);
 
         // set the vertex attribute pointers
         // vertex Positions
         glEnableVertexAttribArray(0);	
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        // vertex normals
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        // vertex normals (octahedral)
         glEnableVertexAttribArray(1);	
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (void*)12);
         // vertex texture coords
         glEnableVertexAttribArray(2);	
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)16);
+        // vertex tangent (octahedral xy, handedness z)
+        if (hasTangents)
+        {
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 4, GL_SHORT, GL_TRUE, stride, (void*)20);
+        }
 
         glBindVertexArray(0);
     }
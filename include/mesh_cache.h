@@ -0,0 +1,98 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary mesh cache (.ivmesh): the GPU-ready output of Model's Assimp import, so
+// later launches skip Assimp entirely and upload straight from a memory mapping.
+//
+//   MeshCacheHeader
+//   MeshCacheMesh[meshCount]
+//   MeshCacheTexture[textureCount]
+//   string table (texture types and paths, not terminated)
+//   vertex / index blobs, each 16-byte aligned
+//
+// Vertex blobs use the packed layout from mesh.h; index blobs are uint16 or
+// uint32 (indexType). All integers are little-endian, which every target is.
+
+const uint32_t MESH_CACHE_VERSION = 1;
+const char MESH_CACHE_EXTENSION[] = ".ivmesh";
+
+struct MeshCacheHeader {
+    char magic[4];          // "IVMC"
+    uint32_t version;
+    uint64_t sourceKey;     // see meshCacheSourceKey
+    uint32_t meshCount;
+    uint32_t textureCount;
+    uint32_t stringBytes;
+    uint32_t reserved;
+};
+
+struct MeshCacheMesh {
+    uint64_t vertexOffset;  // from the start of the file
+    uint64_t indexOffset;
+    uint32_t vertexBytes;
+    uint32_t indexBytes;
+    uint32_t indexCount;
+    uint32_t indexType;     // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    uint32_t hasTangents;
+    uint32_t firstTexture;  // range in the texture table
+    uint32_t textureCount;
+    uint32_t reserved;
+};
+
+struct MeshCacheTexture {
+    uint32_t typeOffset;    // into the string table
+    uint32_t typeLength;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+
+// One mesh as it is written; Model fills these while importing through Assimp
+struct MeshCacheEntry {
+    std::vector<unsigned char> vertexData;
+    std::vector<unsigned char> indexData;
+    unsigned int indexCount;
+    unsigned int indexType;
+    bool hasTangents;
+    std::vector<std::pair<std::string, std::string>> textures;  // (type, path relative to the model)
+};
+
+// Key that invalidates the cache when the source file or, for OBJ models, one of
+// its .mtl libraries (size, modification time) or the import settings change.
+// Returns 0 if the source cannot be stat'ed.
+uint64_t meshCacheSourceKey(const std::string& sourcePath, uint32_t importFlags);
+
+// Cache file name for a source model inside cacheDir, unique per full source path
+std::string meshCachePath(const std::string& cacheDir, const std::string& sourcePath);
+
+// Writes through a temporary file and a rename so readers never see a partial file
+bool writeMeshCache(const std::string& path, uint64_t sourceKey, const std::vector<MeshCacheEntry>& meshes);
+
+// Validated, memory-mapped view of a cache file
+class MeshCacheFile {
+public:
+    // Fails (quietly for a missing file) if the file is absent, stale or malformed
+    bool open(const std::string& path, uint64_t sourceKey);
+
+    uint32_t meshCount() const { return header()->meshCount; }
+    const MeshCacheMesh& mesh(uint32_t index) const;
+    const unsigned char* blob(uint64_t offset) const { return file.data() + offset; }
+    std::string textureType(uint32_t index) const;
+    std::string texturePath(uint32_t index) const;
+    size_t size() const { return file.size(); }
+
+private:
+    MappedFile file;
+
+    const MeshCacheHeader* header() const { return reinterpret_cast<const MeshCacheHeader*>(file.data()); }
+    const MeshCacheTexture& texture(uint32_t index) const;
+    const char* strings() const;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "mesh.h"
+
+#include <cstddef>
+#include <vector>
+
+// Import-time index/vertex reordering for Model::processMesh. All passes keep the
+// triangle set intact; only the order of triangles and vertices changes (welding
+// merges bit-identical vertices).
+
+// Post-transform cache statistics for a FIFO cache of the given size:
+// ACMR = vertex shader invocations per triangle (0.5 is ideal for a regular grid, 3 is worst),
+// ATVR = invocations per unique vertex (1.0 is ideal)
+struct VertexCacheStats {
+    float acmr;
+    float atvr;
+};
+
+struct MeshOptimizationStats {
+    size_t verticesBefore;
+    size_t verticesAfter;
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+const int VERTEX_CACHE_STATS_SIZE = 16;   // conservative FIFO size for reporting
+
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                    int cacheSize = VERTEX_CACHE_STATS_SIZE);
+
+// Merges vertices whose attributes are bit-identical and rewrites the indices
+void weldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+// Tom Forsyth's linear-speed vertex cache optimisation (LRU cache model)
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+// Splits the cache-optimised triangle order into clusters and draws outward-facing
+// clusters first (Sander et al., "Tipsify"), so early depth test rejects more of the
+// inner surfaces. Keeps the result only if ACMR grows by less than `threshold`.
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+                      float threshold = 1.05f);
+
+// Renumbers vertices in order of first use so vertex fetch walks memory linearly;
+// unreferenced vertices are dropped
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+// Runs weld -> vertex cache -> overdraw -> vertex fetch and returns before/after statistics
+MeshOptimizationStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+#endif
@@ -11,8 +11,11 @@
 #include <assimp/postprocess.h>
 
 #include "mesh.h"
+#include "mesh_cache.h"
 #include "shader.h"
+#include "texture_cache.h"
 
+#include <memory>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -21,34 +24,135 @@
 #include <vector>
 using namespace std;
 
+// Import-time processing applied by Model::loadModel
+struct ModelImportOptions
+{
+    bool optimize = true;           // weld + vertex cache / overdraw / fetch reordering (mesh_optimizer.h)
+    bool assimpOptimize = false;    // also run Assimp's JoinIdenticalVertices and ImproveCacheLocality steps
+    bool keepCPUData = false;       // keep ModelSubmesh::vertices/indices after upload (nothing in the game reads them)
+    string cacheDir;                // binary mesh cache directory (mesh_cache.h); empty disables the cache
+    bool rebuildCache = false;      // import through Assimp and rewrite the cache even if it is current
+    bool deferUpload = false;       // constructor only imports (no GL calls, safe on a loader thread); call upload() on the GL thread
+};
+
+// One imported mesh inside the Model's shared buffers. Indices are relative to
+// baseVertex, so a submesh can be drawn on its own with glDrawElementsBaseVertex.
+struct ModelSubmesh
+{
+    GLint baseVertex;
+    unsigned int firstIndex;        // in elements of Model::indexType
+    unsigned int indexCount;
+    unsigned int vertexCount;
+    unsigned int material;          // index into Model::materials
+    vector<Vertex> vertices;        // only with ModelImportOptions::keepCPUData
+    vector<unsigned int> indices;
+};
+
+// Distinct texture set; every material is drawn with a single draw call
+struct ModelMaterial
+{
+    vector<Texture> textures;
+    vector<int> textureUnits;       // unit for each texture, fixed per sampler name model-wide
+    GLint baseVertex;
+    unsigned int firstIndex;
+    unsigned int indexCount;
+};
+
 class Model 
 {
 public:
     // model data 
-    vector<Texture> textures_loaded;	// stores all the textures loaded so far, optimization to make sure textures aren't loaded more than once.
-    vector<Mesh>    meshes;
+    vector<Texture> textures_loaded;	// one entry per TextureCache reference held by this model, released in the destructor
+    vector<ModelSubmesh>  submeshes;
+    vector<ModelMaterial> materials;
     string directory;
     bool gammaCorrection;
+    ModelImportOptions importOptions;
+    bool loadedFromCache = false;   // true when the meshes came from the binary mesh cache
+    double loadMilliseconds = 0.0;  // time spent in the constructor and upload()
+
+    // shared GPU storage (packed layout from mesh.h) for every submesh
+    unsigned int VAO = 0;
+    GLenum indexType = GL_UNSIGNED_SHORT;   // GL_UNSIGNED_INT when a material spans more than 65536 vertices
+    bool hasTangents = false;
+    size_t gpuBytes = 0;
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const &path, bool gamma = false);
+    Model(string const &path, bool gamma = false, const ModelImportOptions &options = ModelImportOptions());
+    ~Model();
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    // creates the GL buffers and textures for the imported meshes; the constructor
+    // calls it unless ModelImportOptions::deferUpload is set
+    void upload();
+    bool isUploaded() const { return uploaded; }
 
-    // draws the model, and thus all its meshes
+    // draws the model, one draw call per material
     void Draw(Shader &shader);
+
+    // draws one copy of the model per transform in a single instanced draw per
+    // material. The shader reads the transform from attribute locations 4-7
+    // (mat4 instanceModel); Draw uses the identity.
+    void DrawInstanced(Shader &shader, const vector<glm::mat4> &instanceTransforms);
     
 private:
-    // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
+    unsigned int VBO = 0, EBO = 0, instanceVBO = 0;
+    size_t instanceCapacity = 0;
+    bool instanceIdentity = false;      // instanceVBO holds just the identity (set by Draw)
+    unsigned int samplerProgram = 0;    // program whose sampler uniforms were last assigned
+    vector<string> samplerNames;        // texture unit -> sampler uniform (texture_diffuse1, ...)
+    bool uploaded = false;
+
+    // one packed mesh waiting to be merged into the shared buffers; the data lives
+    // in importedMeshes (Assimp path) or in the mapped cache file
+    struct PackedMesh
+    {
+        const unsigned char *vertexData;
+        size_t vertexBytes;
+        const unsigned char *indexData;
+        unsigned int indexCount;
+        GLenum indexType;
+        bool hasTangents;
+        vector<Texture> textures;
+    };
+
+    // meshes produced by processMesh, kept until they are uploaded and cached
+    vector<MeshCacheEntry> importedMeshes;
+    vector<vector<Vertex>> importedVertices;        // keepCPUData only
+    vector<vector<unsigned int>> importedIndices;
+    unique_ptr<MeshCacheFile> importedCache;        // mapped cache file when the meshes came from it
+    vector<DecodedImage> decodedTextures;           // deferUpload only: material images decoded during import
+
+    // loads the meshes from the cache or through Assimp, without touching GL
+    void import(string const &path);
+
+    // texture (type, path) pairs of imported mesh i
+    vector<pair<string, string>> importedTexturePaths(size_t mesh) const;
+
+    // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in importedMeshes.
     void loadModel(string const &path);
 
+    // maps a binary mesh cache file into importedCache; false if it is missing or stale
+    bool loadFromCache(string const &path, string const &cachePath, uint64_t sourceKey);
+
     // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
     void processNode(aiNode *node, const aiScene *scene);
 
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene);
+    void processMesh(aiMesh *mesh, const aiScene *scene);
+
+    // groups the meshes by material and uploads them into VBO/EBO
+    void buildBuffers(const vector<PackedMesh> &packedMeshes);
+
+    void drawBatches(Shader &shader, GLsizei instanceCount);
 
-    // checks all material textures of a given type and loads the textures if they're not loaded yet.
-    // the required info is returned as a Texture struct.
+    // acquires the texture (relative to directory) from the shared TextureCache,
+    // uploading the image decoded during import if there is one
+    bool loadTexture(const string &path, const string &typeName, Texture &texture);
+
+    // collects the material textures of a given type; the textures themselves are
+    // acquired in upload(), so only type and path are set
     std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName); 
 };
 
 #endif
-
@@ -0,0 +1,115 @@
+#ifndef RESOURCE_PACK_H
+#define RESOURCE_PACK_H
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Packed resource archive (.pack): the resources/ tree in one file that is
+// memory-mapped at startup, so loaders read entries in place instead of opening
+// and reading each file.
+//
+//   ResourcePackHeader
+//   entry data, each entry 64-byte aligned
+//   ResourcePackEntry[bucketCount]  open-addressed hash table (linear probing)
+//   name table (paths relative to the packed root, '/'-separated, not terminated)
+//
+// Entries are stored as is, or zlib-compressed when that saves enough to be
+// worth a decode (see writeResourcePack). All integers are little-endian.
+
+const uint32_t RESOURCE_PACK_VERSION = 1;
+const uint32_t RESOURCE_PACK_ALIGNMENT = 64;
+const uint32_t RESOURCE_PACK_COMPRESSED = 1;    // ResourcePackEntry::flags
+
+struct ResourcePackHeader {
+    char magic[4];          // "IVPK"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t bucketCount;   // power of two, at least twice entryCount
+    uint64_t directoryOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct ResourcePackEntry {
+    uint64_t nameHash;      // FNV-1a of the name
+    uint64_t offset;        // from the start of the file
+    uint64_t storedSize;    // bytes in the file
+    uint64_t size;          // bytes once decompressed
+    uint32_t nameOffset;    // into the name table
+    uint16_t nameLength;    // 0 marks an empty bucket
+    uint16_t flags;
+};
+
+// One file as it is written by the resource_pack tool
+struct ResourcePackInput {
+    std::string name;       // relative to the packed root, '/'-separated
+    std::vector<unsigned char> data;
+};
+
+struct ResourcePackStats {
+    size_t entries = 0;
+    size_t compressedEntries = 0;
+    size_t inputBytes = 0;
+    size_t fileBytes = 0;
+};
+
+// Writes through a temporary file and a rename. With compress, entries that
+// deflate to at most 7/8 of their size are stored compressed; everything else
+// (PNGs, KTX2 files) stays uncompressed so it can be used straight from the map.
+bool writeResourcePack(const std::string& path, const std::vector<ResourcePackInput>& inputs, bool compress,
+                       ResourcePackStats* stats = nullptr);
+
+// An entry found in the mounted pack. Stored entries point into the mapping and
+// stay valid while the pack is mounted; compressed ones are inflated into storage.
+struct ResourceData {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;    // data points into the pack rather than into storage
+    std::vector<unsigned char> storage;
+};
+
+// Process-wide pack that the texture and sound loaders look in before touching
+// the filesystem. Mount it once before loading starts; lookups are read-only and
+// may then run on any thread.
+class ResourcePack {
+public:
+    static ResourcePack& instance();
+
+    // Maps packPath; files under rootDir are then looked up in it by their path
+    // relative to rootDir. Fails quietly if the file does not exist.
+    bool mount(const std::string& packPath, const std::string& rootDir);
+    // Same over a buffer that outlives the pack (AAsset_getBuffer on Android);
+    // with an empty rootDir names are looked up as given
+    bool mountMemory(const unsigned char* bytes, size_t size, const std::string& rootDir);
+    void unmount();
+
+    bool isMounted() const { return bytes != nullptr; }
+    size_t entryCount() const { return header ? header->entryCount : 0; }
+
+    // Looks up a file by the path the loader would have opened; false if the pack
+    // is not mounted, the path is outside its root or has no entry, or the entry
+    // fails to inflate
+    bool find(const std::string& path, ResourceData& out) const;
+
+private:
+    MappedFile file;
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+    const ResourcePackHeader* header = nullptr;
+    const ResourcePackEntry* buckets = nullptr;
+    const char* names = nullptr;
+    std::string root;       // canonical, generic form with a trailing '/'; empty if names are used as given
+
+    bool validate(const std::string& description);
+    std::string entryName(const std::string& path) const;
+
+    ResourcePack() = default;
+    ResourcePack(const ResourcePack&) = delete;
+    ResourcePack& operator=(const ResourcePack&) = delete;
+};
+
+#endif
@@ -7,12 +7,28 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+
+// In-memory vertex/fragment source pair, e.g. from the embedded shader table
+struct ShaderSource {
+  const char* vertexCode;
+  const char* fragmentCode;
+  // vertex shader outputs captured (interleaved) by transform feedback, if any
+  std::vector<const char*> feedbackVaryings = {};
+};
 
 class Shader {
   public:
   unsigned int ID;
+  bool loadedFromCache = false; // true when the program came from the binary cache
+
+  Shader(const char* vertexPath, const char* fragmentPath,
+         const std::vector<const char*>& feedbackVaryings = {});
+  explicit Shader(const ShaderSource& source);
 
-  Shader(const char* vertexPath, const char* fragmentPath);
+  // Directory where linked program binaries are cached between runs.
+  // An empty string disables the cache (the default).
+  static void setBinaryCacheDir(const std::string &dir);
 
   void use();
 
@@ -28,6 +44,16 @@ class Shader {
   void setMat2(const std::string &name, const glm::mat2 &mat) const;
   void setMat3(const std::string &name, const glm::mat3 &mat) const;
   void setMat4(const std::string &name, const glm::mat4 &mat) const;
+
+private:
+  static std::string binaryCacheDir;
+
+  void build(const std::string& vertexCode, const std::string& fragmentCode,
+             const std::vector<const char*>& feedbackVaryings);
+  void compileAndLinkShaders(const std::string& vertexCode, const std::string& fragmentCode,
+                             const std::vector<const char*>& feedbackVaryings);
+  bool loadProgramBinary(const std::string& cachePath, unsigned long long key);
+  void saveProgramBinary(const std::string& cachePath, unsigned long long key);
 };
 
 #endif
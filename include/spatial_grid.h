@@ -0,0 +1,48 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Uniform grid of point indices over a rectangle for radius queries, rebuilt
+// from scratch whenever the points move. A rebuild is a counting sort into one
+// index array, so after the first one it allocates nothing. Points outside the
+// rectangle are kept in the border cells, where queries still find them.
+class SpatialGrid {
+public:
+    // Starts a rebuild; queries are cheapest with cellSize near the largest radius
+    void begin(glm::vec2 boundsMin, glm::vec2 boundsMax, float cellSize);
+    void insert(int index, glm::vec2 position);
+    void end();
+
+    // Calls visit(index) for every point in the cells the circle overlaps (a
+    // superset of the points inside it), in insertion order within each cell
+    template <typename Visit>
+    void query(glm::vec2 center, float radius, Visit visit) const {
+        int x0 = cellX(center.x - radius), x1 = cellX(center.x + radius);
+        int y0 = cellY(center.y - radius), y1 = cellY(center.y + radius);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                int cell = y * columns + x;
+                for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                    visit(indices[i]);
+                }
+            }
+        }
+    }
+
+private:
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    glm::vec2 origin = glm::vec2(0.0f);
+    float inverseCellSize = 1.0f;
+    int columns = 1;
+    int rows = 1;
+    std::vector<int> cellStart;     // columns * rows + 1 offsets into indices
+    std::vector<int> indices;
+    std::vector<int> pointCells;    // cell of each inserted point, in insertion order
+    std::vector<int> pointIndices;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shader.h"
+
+// Laid-out text: window pixels relative to the text origin, atlas coordinates
+// for the SDF font (unused by the bitmap one)
+struct TextVertex {
+    glm::vec2 position;
+    glm::vec2 uv;
+};
+
+// Text whose content changes from frame to frame (score, lives, counters). The
+// label keeps its own geometry and is laid out again only when the string, the
+// scale or the font differs from the last time it was drawn.
+struct TextLabel {
+    std::string text;
+    float scale = 0.0f;
+    int font = -1;          // TextRenderer::Font it was laid out for, -1 before the first time
+    std::vector<TextVertex> vertices;
+    glm::vec2 boundsMin = glm::vec2(0.0f);
+    glm::vec2 boundsMax = glm::vec2(0.0f);
+};
+
+// Collects every string of a frame into one vertex buffer with the colour per
+// vertex and draws them with a single call. Layouts are cached as triangles in
+// pixels: fixed strings by (text, scale), changing ones in their TextLabel, so
+// queueing text that was drawn before is a translate and copy.
+//
+// Two fonts draw the same stb_easy_font glyphs. BITMAP emits its quads as they
+// are, one per stroke segment. SDF (built with INVADERS_SDF_FONT, the atlas
+// generated by tools/font_atlas.cpp) draws one quad per character from a signed
+// distance field atlas, so large text costs a few vertices and keeps sharp edges.
+class TextRenderer {
+public:
+    enum Font { BITMAP, SDF };
+
+    // Totals since the last takeStats()
+    struct Stats {
+        int frames = 0;         // flushes that drew something
+        int strings = 0;
+        int vertices = 0;
+        int layouts = 0;        // strings laid out because they were new or changed
+    };
+
+    explicit TextRenderer(int maxVertices = 16384);
+    ~TextRenderer();
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    // bitmapShader is text.vs/text.fs, sdfShader text_sdf.vs/text_sdf.fs; starts with
+    // the SDF font when it was compiled in and sdfShader is given
+    bool initialize(Shader* bitmapShader, Shader* sdfShader);
+    void cleanup();
+
+    bool hasSdfFont() const { return atlasTexture != 0; }
+    Font font() const { return currentFont; }
+    // Falls back to BITMAP if the SDF font is not available
+    void setFont(Font font);
+
+    // Queue text with its stb_easy_font origin at (x, y) in window pixels
+    void add(const char* text, float x, float y, float scale, const glm::vec3& color);
+    void add(TextLabel& label, const char* text, float x, float y, float scale, const glm::vec3& color);
+
+    // Draws everything queued since the last flush into the bound framebuffer
+    void flush(int viewportWidth, int viewportHeight);
+
+    // Pixel width of the laid-out text
+    float width(const char* text, float scale);
+    // NDC rectangle (x0, y0, x1, y1) the text covers when drawn at (x, y)
+    glm::vec4 bounds(const char* text, float x, float y, float scale, int viewportWidth, int viewportHeight);
+
+    Stats takeStats();
+
+private:
+    struct Vertex {
+        glm::vec2 position;     // window pixels
+        glm::vec2 uv;
+        glm::vec3 color;
+    };
+
+    struct CachedLayout {
+        std::string text;
+        float scale;
+        size_t first;           // into cachedVertices
+        size_t count;
+        glm::vec2 boundsMin;
+        glm::vec2 boundsMax;
+    };
+
+    // Fixed strings past this many cached vertices start the cache over
+    static const size_t CACHE_VERTEX_LIMIT = 65536;
+
+    const CachedLayout& cachedLayout(const char* text, float scale);
+    // Appends the triangles of text in the current font to out and returns the
+    // extent of the glyphs' strokes (the same for both fonts)
+    void layout(const char* text, float scale, std::vector<TextVertex>& out, glm::vec2& boundsMin, glm::vec2& boundsMax);
+    void layoutSdf(const char* text, float scale, std::vector<TextVertex>& out);
+    void append(const TextVertex* vertices, size_t count, float x, float y, const glm::vec3& color);
+
+    int maxVertices;
+    Shader* bitmapShader;
+    Shader* sdfShader;
+    unsigned int vao;
+    unsigned int vbo;
+    unsigned int atlasTexture;
+    Font currentFont;
+
+    std::vector<Vertex> batch;
+    std::vector<TextVertex> cachedVertices;
+    std::unordered_map<uint64_t, CachedLayout> cache;   // by hash of (text, scale)
+    Stats stats;
+    bool overflowReported;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+
+#include "ktx2.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// How an image file becomes a GL texture. Part of the cache key: the same file
+// requested with different settings gets its own texture object, since wrap and
+// filter state lives on the texture.
+struct TextureLoadOptions {
+    bool flipVertically = true;     // stbi vertical flip (GL expects bottom-up rows)
+    bool mipmaps = true;
+    GLint wrapS = GL_REPEAT;
+    GLint wrapT = GL_REPEAT;
+    GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;  // use a non-mipmap filter when mipmaps is false
+    GLint magFilter = GL_LINEAR;
+    bool allowCompressed = true;    // load a <name>.bc/.etc2.ktx2 sibling instead when the context supports it
+};
+
+struct ImageDataDeleter {
+    void operator()(unsigned char* pixels) const;
+};
+
+// An image file decoded to 8-bit texels, or its block-compressed KTX2 sibling,
+// ready for upload (see TextureCache::decodeImage)
+struct DecodedImage {
+    std::string path;       // canonical path of the source image
+    std::unique_ptr<unsigned char, ImageDataDeleter> pixels;
+    int width = 0, height = 0, channels = 0;
+    Ktx2Texture compressed; // vkFormat != 0 when the KTX2 file is used instead of pixels
+};
+
+// Process-wide cache of textures loaded from image files, keyed by a hash of the
+// canonical path and the load options. Every acquire() takes a reference that
+// must be returned with release(); the GL texture is deleted with the last one.
+// Must be used from the thread that owns the GL context.
+class TextureCache {
+public:
+    static TextureCache& instance();
+
+    // Returns the GL texture for path, loading it on first use; 0 if the image
+    // cannot be loaded (failures are not cached, so a later call retries)
+    unsigned int acquire(const std::string& path, const TextureLoadOptions& options = TextureLoadOptions());
+
+    // The two halves of acquire() for loading on worker threads: decodeImage only
+    // reads and decodes the file and may run on any thread; acquireDecoded uploads
+    // the pixels (or takes a reference if the texture is already resident) and
+    // must run on the GL thread with the same options
+    static bool decodeImage(const std::string& path, const TextureLoadOptions& options, DecodedImage& image);
+    unsigned int acquireDecoded(const DecodedImage& image, const TextureLoadOptions& options);
+
+    // Queries which block-compressed formats the current context samples (BC
+    // through EXT_texture_compression_s3tc, ETC2 through OpenGL 4.3 or
+    // ARB_ES3_compatibility). Call once on the GL thread before loading; until
+    // then only the source images are used.
+    static void detectCompressedFormats();
+
+    // The path textures are keyed by: weakly canonical, or as given if it cannot be resolved
+    static std::string canonicalPath(const std::string& path);
+
+    // Takes another reference to a texture obtained from acquire()
+    void addReference(unsigned int texture);
+    void release(unsigned int texture);
+
+    // Estimated GPU memory of all resident textures (mip chain included)
+    size_t residentBytes() const { return totalBytes; }
+    size_t textureCount() const { return entries.size(); }
+    size_t getTextureBytes(unsigned int texture) const;
+
+    // Prints one line per resident texture with its size and reference count
+    void logUsage() const;
+
+private:
+    struct Entry {
+        std::string path;       // canonical
+        unsigned int texture;
+        int width, height, channels;
+        const char* format;     // ktx2FormatName, or "uncompressed"
+        size_t bytes;
+        int references;
+    };
+
+    // written once by detectCompressedFormats before any loader thread reads them
+    static bool bcSupported;
+    static bool etc2Supported;
+
+    static bool loadCompressed(const std::string& canonicalPath, const TextureLoadOptions& options, Ktx2Texture& texture);
+
+    std::unordered_map<uint64_t, Entry> entries;
+    std::unordered_map<unsigned int, uint64_t> keysByTexture;
+    size_t totalBytes = 0;
+
+    TextureCache() = default;
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef TEXTURE_COMPRESS_H
+#define TEXTURE_COMPRESS_H
+
+#include <cstdint>
+#include <vector>
+
+// Block encoders behind the texture_compress tool. Images are tightly packed
+// RGBA8 rows; every format works on 4x4 blocks (edge texels are repeated to
+// fill partial blocks at the right and bottom).
+
+enum class BlockFormat {
+    BC1,        // opaque RGB, 4 bpp (desktop S3TC)
+    BC3,        // RGBA with interpolated alpha, 8 bpp (desktop S3TC)
+    ETC2_RGB,   // opaque RGB, 4 bpp (core in OpenGL ES 3.0 and OpenGL 4.3)
+    ETC2_RGBA   // RGB + EAC alpha, 8 bpp
+};
+
+// KTX2 VkFormat of the encoded data (ktx2.h)
+uint32_t blockFormatVkFormat(BlockFormat format);
+
+// True if any texel is not fully opaque, i.e. the image needs BC3 / ETC2_RGBA
+bool imageHasAlpha(const unsigned char* rgba, int width, int height);
+
+// Encodes one mip level. squaredError, if given, receives the summed squared
+// error over all channels of visible texels (fully transparent texels only
+// count their alpha).
+std::vector<unsigned char> compressImage(const unsigned char* rgba, int width, int height, BlockFormat format,
+                                         double* squaredError = nullptr);
+
+// Next mip level with a 2x2 box filter (as glGenerateMipmap); odd edges repeat the last texel
+std::vector<unsigned char> downsampleImage(const unsigned char* rgba, int width, int height);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Hands the latest of a stream of values from one producer thread to one
+// consumer thread without either side waiting for the other. The producer fills
+// writeBuffer() and publishes it; the consumer acquires and reads readBuffer(),
+// which stays untouched until its next acquire. A published value the consumer
+// never acquired is simply replaced by the next one.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer side
+    T& writeBuffer() { return buffers[back]; }
+
+    // false if this replaced a value the consumer never acquired
+    bool publish() {
+        int previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+        {
+            // a consumer between checking for a value and waiting can't miss the notify
+            std::lock_guard<std::mutex> lock(waitMutex);
+        }
+        published.notify_one();
+        return (previous & FRESH) == 0;
+    }
+
+    // Consumer side: true if a newer value than readBuffer() was taken
+    bool acquire() {
+        if ((middle.load(std::memory_order_acquire) & FRESH) == 0) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& readBuffer() const { return buffers[front]; }
+
+    // Blocks until acquire() has something to take or the timeout passes
+    template <typename Rep, typename Period>
+    bool waitForPublish(const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(waitMutex);
+        return published.wait_for(lock, timeout, [this] {
+            return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+        });
+    }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;     // middle holds a value the consumer hasn't taken
+
+    T buffers[3];
+    int back = 0;                   // producer only
+    std::atomic<int> middle{1};
+    int front = 2;                  // consumer only
+
+    std::mutex waitMutex;
+    std::condition_variable published;
+};
+
+#endif
@@ -12,10 +12,12 @@ float hash(vec2 p) {
     return fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453);
 }
 
-// Simple star generation
-float stars(vec2 uv, float density) {
+// Simple star generation. Cell ids wrap every 1.0 in uv, so the sky repeats
+// exactly like the texture starfield_bake.fs bakes from it; uvOffset picks a
+// different set of cells for a layer.
+float stars(vec2 uv, float density, vec2 uvOffset) {
     vec2 grid = uv * density;
-    vec2 id = floor(grid);
+    vec2 id = mod(floor(grid), density) + uvOffset * density;
     vec2 gv = fract(grid) - 0.5;
     
     float starSeed = hash(id);
@@ -48,10 +50,10 @@ void main()
     float starField = 0.0;
     
     // Bright close stars
-    starField += stars(uv + vec2(0.0, time * 0.02), 20.0) * 1.0;
+    starField += stars(uv + vec2(0.0, time * 0.02), 20.0, vec2(0.0)) * 1.0;
     
     // Dimmer distant stars
-    starField += stars(uv + vec2(50.0, time * 0.01), 40.0) * 0.6;
+    starField += stars(uv + vec2(0.0, time * 0.01), 40.0, vec2(50.0, 0.0)) * 0.6;
     
     // White star color
     vec3 starColor = vec3(1.0, 0.95, 0.9);
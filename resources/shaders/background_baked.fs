@@ -0,0 +1,35 @@
+#version 330 core
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 BrightColor;
+
+in vec2 TexCoords;
+
+uniform float time;
+uniform float alpha;
+uniform sampler2D starTexture; // baked by starfield_bake.fs
+
+// Twinkle from the baked seed, matching background.fs (seed was stored as seed / 0.05)
+float twinkle(float seed) {
+    return 0.7 + 0.3 * sin(time + seed * 0.05 * 6.28);
+}
+
+void main()
+{
+    // Simple dark space background
+    vec3 spaceColor = vec3(0.01, 0.01, 0.05);
+
+    // Two scrolling layers, one texture fetch each
+    vec2 nearStar = texture(starTexture, TexCoords + vec2(0.0, time * 0.02)).rg;
+    vec2 farStar = texture(starTexture, TexCoords + vec2(0.0, time * 0.01)).ba;
+
+    float starField = nearStar.x * twinkle(nearStar.y) * 1.0 +
+                      farStar.x * twinkle(farStar.y) * 0.6;
+
+    // White star color
+    vec3 starColor = vec3(1.0, 0.95, 0.9);
+
+    vec3 finalColor = spaceColor + starColor * starField;
+
+    FragColor = vec4(finalColor, alpha);
+    BrightColor = vec4(0.0, 0.0, 0.0, 1.0); // No bloom for background
+}
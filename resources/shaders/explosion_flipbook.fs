@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 BrightColor;
+
+in vec2 screenPos;
+
+uniform sampler2D flipbook;
+uniform vec2 cell;       // (frame, variation) of the atlas cell to sample
+uniform vec2 cellScale;  // 1.0 / (frames, variations)
+uniform float cellInset; // half a texel in cell space, keeps bilinear taps inside the cell
+
+// Must match COLOR_RANGE in tools/explosion_atlas.cpp
+const float COLOR_RANGE = 2.0;
+
+void main()
+{
+    vec2 uv = (cell + clamp(screenPos, vec2(cellInset), vec2(1.0 - cellInset))) * cellScale;
+
+    // The atlas holds premultiplied colour * alpha of explosion.fs; with the additive
+    // (GL_SRC_ALPHA, GL_ONE) blend an alpha of 1.0 adds exactly that contribution
+    FragColor = vec4(texture(flipbook, uv).rgb * COLOR_RANGE, 1.0);
+    BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
+}
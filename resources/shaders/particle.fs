@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 BrightColor;
+
+in vec4 particleColor;
+
+void main()
+{
+    // Soft round point sprite
+    float falloff = 1.0 - smoothstep(0.2, 0.5, length(gl_PointCoord - vec2(0.5)));
+    FragColor = vec4(particleColor.rgb, particleColor.a * falloff);
+    BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
+}
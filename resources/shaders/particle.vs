@@ -0,0 +1,29 @@
+#version 330 core
+layout (location = 0) in vec2 aPosition;
+layout (location = 2) in vec2 aAgeLife;   // x = age, y = lifetime (seconds)
+layout (location = 3) in vec2 aSizeDrag;  // x = size (world units), y = drag
+layout (location = 4) in vec4 aColor;
+
+out vec4 particleColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float pointScale; // pixels per world unit
+
+void main()
+{
+    // Dead (or never spawned) particles land outside the clip volume
+    if (aAgeLife.x >= aAgeLife.y) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        gl_PointSize = 1.0;
+        particleColor = vec4(0.0);
+        return;
+    }
+
+    float t = aAgeLife.x / aAgeLife.y;
+    gl_Position = projection * view * vec4(aPosition, 0.0, 1.0);
+    gl_PointSize = max(aSizeDrag.x * (1.0 - 0.5 * t) * pointScale, 1.0);
+
+    // Cool towards red and fade out over the lifetime
+    particleColor = vec4(aColor.rgb * vec3(1.0, 1.0 - 0.5 * t, 1.0 - t), aColor.a * (1.0 - t));
+}
@@ -0,0 +1,9 @@
+#version 330 core
+// Never runs (the update pass discards rasterization); only here because
+// programs are built from a vertex/fragment pair
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(0.0);
+}
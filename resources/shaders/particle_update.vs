@@ -0,0 +1,26 @@
+#version 330 core
+// Particle simulation step, run with GL_RASTERIZER_DISCARD and the outputs
+// captured by transform feedback into the other ping-pong buffer
+layout (location = 0) in vec2 aPosition;
+layout (location = 1) in vec2 aVelocity;
+layout (location = 2) in vec2 aAgeLife;   // x = age, y = lifetime (seconds)
+layout (location = 3) in vec2 aSizeDrag;  // x = size (world units), y = drag
+layout (location = 4) in vec4 aColor;
+
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec2 outAgeLife;
+out vec2 outSizeDrag;
+out vec4 outColor;
+
+uniform float deltaTime;
+
+void main()
+{
+    // Semi-implicit Euler with linear drag (same as the CPU fallback)
+    outVelocity = aVelocity * max(1.0 - aSizeDrag.y * deltaTime, 0.0);
+    outPosition = aPosition + outVelocity * deltaTime;
+    outAgeLife = vec2(aAgeLife.x + deltaTime, aAgeLife.y);
+    outSizeDrag = aSizeDrag;
+    outColor = aColor;
+}
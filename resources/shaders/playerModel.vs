@@ -1,7 +1,8 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;   
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec2 aNormal;   // octahedral-encoded (see mesh.h)
 layout (location = 2) in vec2 aTexCoords;
+layout (location = 4) in mat4 instanceModel; // per instance (Model::DrawInstanced), identity for Model::Draw
 
 uniform mat4 model;
 uniform mat4 view;
@@ -12,5 +13,5 @@ out vec2 TexCoords;
 void main()
 {
     TexCoords = aTexCoords;
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+    gl_Position = projection * view * model * instanceModel * vec4(aPos, 1.0f);
 }  
\ No newline at end of file
@@ -0,0 +1,40 @@
+#version 330 core
+// Bakes the two star layers of background.fs into one tileable texture:
+// rg = near layer (intensity, twinkle seed), ba = far layer (intensity, twinkle seed)
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// Same hash as background.fs
+float hash(vec2 p) {
+    return fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+// Same star shape as background.fs, with cell ids wrapped to the grid density
+// so the texture repeats seamlessly when scrolled. uvOffset is the layer's
+// offset in background.fs; it only shifts the cell ids, as it does there.
+vec2 stars(vec2 uv, float density, vec2 uvOffset) {
+    vec2 grid = uv * density;
+    vec2 id = mod(floor(grid), density) + uvOffset * density;
+    vec2 gv = fract(grid) - 0.5;
+
+    float starSeed = hash(id);
+
+    if (starSeed < 0.05) { // 5% chance for a star
+        float dist = length(gv);
+        float starSize = 0.1;
+        float star = smoothstep(starSize, 0.0, dist);
+
+        // seed is < 0.05, stretch it to the full 8-bit range
+        return vec2(star, starSeed / 0.05);
+    }
+
+    return vec2(0.0);
+}
+
+void main()
+{
+    vec2 nearLayer = stars(TexCoords, 20.0, vec2(0.0));
+    vec2 farLayer = stars(TexCoords, 40.0, vec2(50.0, 0.0));
+    FragColor = vec4(nearLayer, farLayer);
+}
@@ -1,8 +1,8 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec3 color;
+in vec3 vColor;
 
 void main() {
-    FragColor = vec4(color, 1.0);
-} 
\ No newline at end of file
+    FragColor = vec4(vColor, 1.0);
+}
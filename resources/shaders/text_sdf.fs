@@ -0,0 +1,18 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 vColor;
+in vec2 vUV;
+
+// Distance to the glyph outline baked by tools/font_atlas.cpp: 0.5 on the
+// outline, larger inside
+uniform sampler2D fontAtlas;
+
+void main() {
+    float distance = texture(fontAtlas, vUV).r;
+    // about one screen pixel of antialiasing at any scale
+    float width = max(fwidth(distance), 1e-4);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    if (alpha <= 0.0) discard;
+    FragColor = vec4(vColor, alpha);
+}
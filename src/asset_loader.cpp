@@ -0,0 +1,167 @@
+#include "asset_loader.h"
+#include "audio_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <memory>
+
+AssetLoader::AssetLoader(unsigned int workerCount) {
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int AssetLoader::defaultWorkerCount() {
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 1;
+}
+
+void AssetLoader::enqueue(const std::string& name, Job job) {
+    total++;
+    if (workers.empty()) {
+        Finished item = runJob(name, job);
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(std::move(item));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.emplace_back(name, std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void AssetLoader::workerLoop() {
+    for (;;) {
+        std::pair<std::string, Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Finished item = runJob(job.first, job.second);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.push_back(std::move(item));
+        }
+        jobFinished.notify_one();
+    }
+}
+
+AssetLoader::Finished AssetLoader::runJob(const std::string& name, Job& job) {
+    Finished item{name, nullptr};
+    try {
+        item.upload = job();
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR::ASSET_LOADER::Failed to load " << name << ": " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "ERROR::ASSET_LOADER::Failed to load " << name << std::endl;
+    }
+    return item;
+}
+
+void AssetLoader::runUpload(Finished& item) {
+    if (item.upload) {
+        try {
+            item.upload();
+        } catch (const std::exception& e) {
+            std::cerr << "ERROR::ASSET_LOADER::Failed to upload " << item.name << ": " << e.what() << std::endl;
+        }
+    } else {
+        std::cerr << "WARNING::ASSET_LOADER::" << item.name << " was not loaded" << std::endl;
+    }
+    completed++;
+}
+
+int AssetLoader::pumpUploads(double budgetMilliseconds) {
+    auto start = std::chrono::steady_clock::now();
+    int uploads = 0;
+    for (;;) {
+        Finished item;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished.empty()) break;
+            item = std::move(finished.front());
+            finished.pop_front();
+        }
+        runUpload(item);
+        uploads++;
+
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= budgetMilliseconds) break;
+    }
+    return uploads;
+}
+
+void AssetLoader::finish() {
+    while (!isFinished()) {
+        Finished item;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobFinished.wait(lock, [this] { return !finished.empty(); });
+            item = std::move(finished.front());
+            finished.pop_front();
+        }
+        runUpload(item);
+    }
+}
+
+void AssetLoader::loadTexture(const std::string& path, const TextureLoadOptions& options,
+                              std::function<void(unsigned int)> onLoaded) {
+    enqueue(path, [path, options, onLoaded]() -> UploadStep {
+        std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+        if (!TextureCache::decodeImage(path, options, *image)) {
+            return nullptr;
+        }
+        return [image, options, onLoaded]() {
+            unsigned int texture = TextureCache::instance().acquireDecoded(*image, options);
+            if (onLoaded) onLoaded(texture);
+        };
+    });
+}
+
+void AssetLoader::loadModel(const std::string& path, bool gamma, const ModelImportOptions& options,
+                            std::function<void(Model*)> onLoaded) {
+    ModelImportOptions deferred = options;
+    deferred.deferUpload = true;
+    enqueue(path, [path, gamma, deferred, onLoaded]() -> UploadStep {
+        // the holder deletes the model if the upload step is dropped with the loader
+        std::shared_ptr<std::unique_ptr<Model>> model =
+            std::make_shared<std::unique_ptr<Model>>(new Model(path, gamma, deferred));
+        return [model, onLoaded]() {
+            (*model)->upload();
+            if (onLoaded) onLoaded(model->release());
+        };
+    });
+}
+
+void AssetLoader::loadSound(AudioManager& audio, const std::string& name, const std::string& path,
+                            std::function<void()> onLoaded) {
+    AudioManager* manager = &audio;
+    enqueue(path, [manager, name, path, onLoaded]() -> UploadStep {
+        std::shared_ptr<SoundData> sound = std::make_shared<SoundData>();
+        if (!AudioManager::decodeWAV(path, *sound)) {
+            return nullptr;
+        }
+        return [manager, name, sound, onLoaded]() {
+            if (manager->loadSound(name, *sound) && onLoaded) onLoaded();
+        };
+    });
+}
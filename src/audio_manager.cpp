@@ -1,4 +1,7 @@
 #include "audio_manager.h"
+#include "resource_pack.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -73,57 +76,69 @@ bool AudioManager::initialize() {
 }
 
 bool AudioManager::loadSound(const std::string& name, const std::string& filepath) {
+    SoundData sound;
+    return decodeWAV(filepath, sound) && loadSound(name, sound);
+}
+
+bool AudioManager::decodeWAV(const std::string& filepath, SoundData& sound) {
     std::cout << "Attempting to load sound: " << filepath << std::endl;
-    
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "ERROR: Failed to open audio file: " << filepath << std::endl;
-        std::cerr << "Current working directory: " << std::filesystem::current_path() << std::endl;
-        return false;
+
+    // Straight out of the mounted resource pack when it has the file, else read it whole
+    ResourceData file;
+    if (!ResourcePack::instance().find(filepath, file)) {
+        std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+        if (!stream.is_open()) {
+            std::cerr << "ERROR: Failed to open audio file: " << filepath << std::endl;
+            std::cerr << "Current working directory: " << std::filesystem::current_path() << std::endl;
+            return false;
+        }
+        file.storage.resize(static_cast<size_t>(stream.tellg()));
+        stream.seekg(0);
+        stream.read(reinterpret_cast<char*>(file.storage.data()), file.storage.size());
+        file.data = file.storage.data();
+        file.size = static_cast<size_t>(stream.gcount());
     }
 
     std::cout << "File opened successfully. Reading WAV header..." << std::endl;
 
     // Read RIFF header
     WAVHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
-    
-    if (file.gcount() != sizeof(header)) {
+    if (file.size < sizeof(header)) {
         std::cerr << "ERROR: Failed to read complete WAV header" << std::endl;
-        file.close();
         return false;
     }
+    std::memcpy(&header, file.data, sizeof(header));
 
     if (std::string(header.riff, 4) != "RIFF") {
         std::cerr << "ERROR: Invalid WAV file - RIFF header not found" << std::endl;
-        file.close();
         return false;
     }
     
     if (std::string(header.wave, 4) != "WAVE") {
         std::cerr << "ERROR: Invalid WAV file - WAVE format not found" << std::endl;
-        file.close();
         return false;
     }
 
     // Variables to store format info
     WAVFmtChunk fmtChunk;
-    std::vector<char> audioData;
+    const char* audioData = nullptr;
+    size_t audioSize = 0;
     bool foundFmt = false;
     bool foundData = false;
 
-    // Read chunks until we find both fmt and data
-    while (!file.eof() && (!foundFmt || !foundData)) {
+    // Walk the chunks until we find both fmt and data
+    size_t position = sizeof(header);
+    while (position + sizeof(WAVChunkHeader) <= file.size && (!foundFmt || !foundData)) {
         WAVChunkHeader chunkHeader;
-        file.read(reinterpret_cast<char*>(&chunkHeader), sizeof(chunkHeader));
-        
-        if (file.gcount() != sizeof(chunkHeader)) break;
+        std::memcpy(&chunkHeader, file.data + position, sizeof(chunkHeader));
+        position += sizeof(chunkHeader);
+        size_t chunkSize = std::min<size_t>(chunkHeader.size, file.size - position);
 
         std::string chunkId(chunkHeader.id, 4);
         std::cout << "Found chunk: " << chunkId << " with size: " << chunkHeader.size << std::endl;
 
-        if (chunkId == "fmt ") {
-            file.read(reinterpret_cast<char*>(&fmtChunk), sizeof(fmtChunk));
+        if (chunkId == "fmt " && chunkSize >= sizeof(fmtChunk)) {
+            std::memcpy(&fmtChunk, file.data + position, sizeof(fmtChunk));
             foundFmt = true;
             std::cout << "Format chunk found:" << std::endl
                       << "Audio format: " << fmtChunk.audioFormat << std::endl
@@ -132,34 +147,40 @@ bool AudioManager::loadSound(const std::string& name, const std::string& filepat
                       << "Bits per sample: " << fmtChunk.bitsPerSample << std::endl;
         }
         else if (chunkId == "data") {
-            audioData.resize(chunkHeader.size);
-            file.read(audioData.data(), chunkHeader.size);
+            audioData = reinterpret_cast<const char*>(file.data + position);
+            audioSize = chunkSize;
             foundData = true;
-            std::cout << "Data chunk found, size: " << chunkHeader.size << " bytes" << std::endl;
-        }
-        else {
-            // Skip other chunks (like LIST)
-            file.seekg(chunkHeader.size, std::ios::cur);
+            std::cout << "Data chunk found, size: " << chunkSize << " bytes" << std::endl;
         }
+        // other chunks (like LIST) are skipped; chunks are padded to an even size
+        position += chunkSize + (chunkSize & 1);
     }
 
-    file.close();
-
     if (!foundFmt || !foundData) {
         std::cerr << "ERROR: Failed to find required chunks in WAV file" << std::endl;
         return false;
     }
 
     // Determine OpenAL format
-    ALenum format;
     if (fmtChunk.numChannels == 1) {
-        format = (fmtChunk.bitsPerSample == 8) ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
+        sound.format = (fmtChunk.bitsPerSample == 8) ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
     } else {
-        format = (fmtChunk.bitsPerSample == 8) ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
+        sound.format = (fmtChunk.bitsPerSample == 8) ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
     }
+    // samples in the mapped pack stay valid while it is mounted, so they are not copied
+    if (file.mapped) {
+        sound.mappedSamples = audioData;
+        sound.mappedSize = audioSize;
+    } else {
+        sound.samples.assign(audioData, audioData + audioSize);
+    }
+    sound.sampleRate = static_cast<ALsizei>(fmtChunk.sampleRate);
 
-    std::cout << "Using OpenAL format: " << format << std::endl;
+    std::cout << "Using OpenAL format: " << sound.format << std::endl;
+    return true;
+}
 
+bool AudioManager::loadSound(const std::string& name, const SoundData& sound) {
     // Generate and fill buffer
     ALuint buffer;
     alGenBuffers(1, &buffer);
@@ -170,12 +191,12 @@ bool AudioManager::loadSound(const std::string& name, const std::string& filepat
         return false;
     }
 
-    alBufferData(buffer, format, audioData.data(), audioData.size(), fmtChunk.sampleRate);
+    alBufferData(buffer, sound.format, sound.data(), static_cast<ALsizei>(sound.size()), sound.sampleRate);
     
     error = alGetError();
     if (error != AL_NO_ERROR) {
         std::cerr << "ERROR: Failed to fill OpenAL buffer: " << error << std::endl;
-        std::cerr << "Format: " << format << ", Data size: " << audioData.size() << ", Sample rate: " << fmtChunk.sampleRate << std::endl;
+        std::cerr << "Format: " << sound.format << ", Data size: " << sound.size() << ", Sample rate: " << sound.sampleRate << std::endl;
         alDeleteBuffers(1, &buffer);
         return false;
     }
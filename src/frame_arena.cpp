@@ -0,0 +1,68 @@
+#include "frame_arena.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+// Blocks come from operator new rather than malloc so the allocation tracker
+// sees the arena grow
+FrameArena::FrameArena(size_t capacity)
+    : block(static_cast<unsigned char*>(::operator new(capacity, std::nothrow))), blockSize(block ? capacity : 0),
+      offset(0), demand(0) {}
+
+FrameArena::~FrameArena() {
+    for (void* pointer : overflow) ::operator delete(pointer);
+    ::operator delete(block);
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    // keep the running total aligned too, so the grown block fits the same requests
+    demand = (demand + alignment - 1) / alignment * alignment + size;
+
+    uintptr_t base = reinterpret_cast<uintptr_t>(block);
+    size_t start = ((base + offset + alignment - 1) / alignment * alignment) - base;
+    if (block && start + size <= blockSize) {
+        offset = start + size;
+        return block + start;
+    }
+
+    // operator new alignment covers every type the game puts in here
+    void* pointer = ::operator new(size ? size : 1, std::nothrow);
+    if (pointer) overflow.push_back(pointer);
+    return pointer;
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list measure;
+    va_copy(measure, args);
+    int length = std::vsnprintf(nullptr, 0, fmt, measure);
+    va_end(measure);
+
+    char* text = nullptr;
+    if (length >= 0) {
+        text = static_cast<char*>(allocate(static_cast<size_t>(length) + 1, 1));
+        if (text) std::vsnprintf(text, static_cast<size_t>(length) + 1, fmt, args);
+    }
+    va_end(args);
+    return text ? text : "";
+}
+
+void FrameArena::reset() {
+    if (!overflow.empty()) {
+        for (void* pointer : overflow) ::operator delete(pointer);
+        overflow.clear();
+        // room for the frame that overflowed plus some slack; nothing in the old block survives reset
+        size_t grown = demand + demand / 2;
+        void* larger = ::operator new(grown, std::nothrow);
+        if (larger) {
+            ::operator delete(block);
+            block = static_cast<unsigned char*>(larger);
+            blockSize = grown;
+        }
+    }
+    offset = 0;
+    demand = 0;
+}
@@ -0,0 +1,113 @@
+#include "frame_pacer.h"
+
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <mmsystem.h>
+#else
+#include <time.h>
+#endif
+
+FramePacer::FramePacer() {
+#ifdef _WIN32
+    // the default ~15.6 ms scheduler tick would overshoot every sleep by most of a frame
+    timeBeginPeriod(1);
+#endif
+    deadline = Clock::now();
+    reportStart = deadline;
+    reportCpuStart = processCpuSeconds();
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::setTargetRate(double framesPerSecond) {
+    if (framesPerSecond == rate) return;
+    rate = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+    period = rate > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate))
+                        : Clock::duration::zero();
+    // the old schedule means nothing at the new rate
+    deadline = Clock::now();
+}
+
+double FramePacer::timeUntilNextFrame() const {
+    if (rate <= 0.0) return 0.0;
+    double remaining = std::chrono::duration<double>(deadline - Clock::now()).count();
+    return remaining > 0.0 ? remaining : 0.0;
+}
+
+void FramePacer::waitForNextFrame() {
+    if (rate <= 0.0) return;
+
+    auto sleepStart = Clock::now();
+    auto spinThreshold = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(SPIN_THRESHOLD_SECONDS));
+    if (deadline - sleepStart > spinThreshold) {
+        std::this_thread::sleep_until(deadline - spinThreshold);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    reportWaited += std::chrono::duration<double>(Clock::now() - sleepStart).count();
+}
+
+void FramePacer::waitForNextFrame(const std::function<bool(double)>& block) {
+    auto waitStart = Clock::now();
+    for (double remaining = timeUntilNextFrame(); remaining > 0.0; remaining = timeUntilNextFrame()) {
+        if (block(remaining)) {
+            // the early frame takes this deadline's place, so the next one is a period after it
+            deadline = Clock::now();
+            break;
+        }
+    }
+    reportWaited += std::chrono::duration<double>(Clock::now() - waitStart).count();
+}
+
+void FramePacer::beginFrame() {
+    reportFrames++;
+    if (rate <= 0.0) return;
+
+    auto now = Clock::now();
+    if (deadline + period < now) {
+        deadline = now;
+    }
+    deadline += period;
+}
+
+double FramePacer::processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<unsigned long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return (ticks(kernel) + ticks(user)) * 1e-7;   // 100 ns units
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) return 0.0;
+    return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
+
+bool FramePacer::takeReport(Report& report) {
+    auto now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - reportStart).count();
+    if (seconds < REPORT_INTERVAL_SECONDS) return false;
+
+    double cpu = processCpuSeconds();
+    report.seconds = seconds;
+    report.frames = reportFrames;
+    report.cpuSeconds = cpu - reportCpuStart;
+    report.waitedSeconds = reportWaited;
+
+    reportStart = now;
+    reportCpuStart = cpu;
+    reportFrames = 0;
+    reportWaited = 0.0;
+    return true;
+}
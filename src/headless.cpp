@@ -0,0 +1,319 @@
+#include "headless.h"
+
+#include <glad/glad.h>
+
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool parseHeadlessArgs(int argc, char *argv[], HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--headless") {
+            options.enabled = true;
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::atoi(argv[++i]);
+        } else if (arg == "--timestep" && hasValue) {
+            options.timestep = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--output-dir" && hasValue) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--dump-frames" && hasValue) {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (!item.empty()) options.dumpFrames.push_back(std::atoi(item.c_str()));
+            }
+        } else if (arg == "--bench-starfield" && hasValue) {
+            options.starfieldBenchFrames = std::atoi(argv[++i]);
+        } else if (arg == "--bench-particles" && hasValue) {
+            options.particleBenchCount = std::atoi(argv[++i]);
+        } else if (arg == "--bench-text" && hasValue) {
+            options.textBenchFrames = std::atoi(argv[++i]);
+        } else if (arg == "--check-allocations") {
+            options.checkAllocations = true;
+        } else if (arg == "--allocation-warmup" && hasValue) {
+            options.allocationWarmupFrames = std::atoi(argv[++i]);
+        } else if (arg == "--frames" || arg == "--timestep" || arg == "--output-dir" || arg == "--dump-frames" ||
+                   arg == "--bench-starfield" || arg == "--bench-particles" || arg == "--bench-text" ||
+                   arg == "--allocation-warmup") {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.frames <= 0 || options.timestep <= 0.0f) {
+        std::cerr << "--frames and --timestep must be positive" << std::endl;
+        return false;
+    }
+    std::sort(options.dumpFrames.begin(), options.dumpFrames.end());
+    return true;
+}
+
+HeadlessContext::HeadlessContext()
+    : display(EGL_NO_DISPLAY), context(EGL_NO_CONTEXT), surface(EGL_NO_SURFACE),
+      fbo(0), colorRenderbuffer(0), depthRenderbuffer(0), width(0), height(0) {}
+
+HeadlessContext::~HeadlessContext() {
+    destroy();
+}
+
+bool HeadlessContext::create(int w, int h) {
+    width = w;
+    height = h;
+
+    // Prefer Mesa's surfaceless platform: no X11/Wayland connection is needed at all
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (extensions && std::strstr(extensions, "EGL_MESA_platform_surfaceless")) {
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "ERROR::HEADLESS::Failed to initialize EGL display" << std::endl;
+        return false;
+    }
+    display = eglDisplay;
+    std::cout << "Headless EGL " << major << "." << minor << " (" << eglQueryString(eglDisplay, EGL_VENDOR) << ")" << std::endl;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "ERROR::HEADLESS::EGL has no desktop OpenGL support" << std::endl;
+        destroy();
+        return false;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint numConfigs = 0;
+    bool haveConfig = eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs) && numConfigs > 0;
+    if (!haveConfig) {
+        // surfaceless displays may expose configs without pbuffer support
+        const EGLint anyConfigAttribs[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+        haveConfig = eglChooseConfig(eglDisplay, anyConfigAttribs, &config, 1, &numConfigs) && numConfigs > 0;
+    }
+    if (!haveConfig) {
+        std::cerr << "ERROR::HEADLESS::No suitable EGL config" << std::endl;
+        destroy();
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT) {
+        std::cerr << "ERROR::HEADLESS::Failed to create OpenGL 3.3 core context" << std::endl;
+        destroy();
+        return false;
+    }
+    context = eglContext;
+
+    // Bind without a surface when supported, otherwise through a small pbuffer;
+    // rendering always goes to our own framebuffer object either way
+    const char* displayExtensions = eglQueryString(eglDisplay, EGL_EXTENSIONS);
+    EGLSurface eglSurface = EGL_NO_SURFACE;
+    if (!displayExtensions || !std::strstr(displayExtensions, "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+        surface = eglSurface;
+    }
+    if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        std::cerr << "ERROR::HEADLESS::eglMakeCurrent failed" << std::endl;
+        destroy();
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress)) {
+        std::cerr << "ERROR::HEADLESS::Failed to initialize GLAD" << std::endl;
+        destroy();
+        return false;
+    }
+    std::cout << "Headless renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+
+    return createFramebuffer();
+}
+
+bool HeadlessContext::createFramebuffer() {
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!complete) {
+        std::cerr << "ERROR::HEADLESS::Offscreen framebuffer not complete" << std::endl;
+    }
+    return complete;
+}
+
+void HeadlessContext::destroy() {
+    if (context != EGL_NO_CONTEXT) {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (colorRenderbuffer) glDeleteRenderbuffers(1, &colorRenderbuffer);
+        if (depthRenderbuffer) glDeleteRenderbuffers(1, &depthRenderbuffer);
+        fbo = colorRenderbuffer = depthRenderbuffer = 0;
+
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        context = EGL_NO_CONTEXT;
+    }
+    if (surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+        surface = EGL_NO_SURFACE;
+    }
+    if (display != EGL_NO_DISPLAY) {
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY;
+    }
+}
+
+void* HeadlessContext::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+void HeadlessContext::readPixels(std::vector<unsigned char>& rgba) const {
+    rgba.resize(static_cast<size_t>(width) * height * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+    // GL rows are bottom-up, images are top-down
+    size_t rowSize = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> row(rowSize);
+    for (int y = 0; y < height / 2; y++) {
+        unsigned char* top = rgba.data() + y * rowSize;
+        unsigned char* bottom = rgba.data() + (height - 1 - y) * rowSize;
+        std::memcpy(row.data(), top, rowSize);
+        std::memcpy(top, bottom, rowSize);
+        std::memcpy(bottom, row.data(), rowSize);
+    }
+}
+
+// ===== PNG WRITER =====
+// Minimal encoder using stored (uncompressed) deflate blocks, so no zlib dependency
+
+static uint32_t crc32(uint32_t crc, const unsigned char* data, size_t length) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void appendBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back((value >> 24) & 0xff);
+    out.push_back((value >> 16) & 0xff);
+    out.push_back((value >> 8) & 0xff);
+    out.push_back(value & 0xff);
+}
+
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+bool writePNG(const std::string& path, int width, int height, const unsigned char* rgba) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::PNG::Cannot open " << path << std::endl;
+        return false;
+    }
+
+    const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<unsigned char> header;
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    header.push_back(8);  // bit depth
+    header.push_back(6);  // colour type RGBA
+    header.push_back(0);  // deflate
+    header.push_back(0);  // adaptive filtering
+    header.push_back(0);  // no interlace
+    writeChunk(file, "IHDR", header);
+
+    // raw scanlines, each prefixed with filter type 0
+    size_t rowSize = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowSize + 1) * height);
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + y * rowSize, rgba + (y + 1) * rowSize);
+    }
+
+    // zlib stream of stored blocks (max 65535 bytes each) + adler32
+    std::vector<unsigned char> zlib;
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    size_t offset = 0;
+    do {
+        size_t blockSize = std::min<size_t>(65535, raw.size() - offset);
+        bool last = offset + blockSize == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(blockSize & 0xff);
+        zlib.push_back((blockSize >> 8) & 0xff);
+        zlib.push_back(~blockSize & 0xff);
+        zlib.push_back((~blockSize >> 8) & 0xff);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", {});
+
+    return file.good();
+}
@@ -0,0 +1,26 @@
+#include "input_queue.h"
+
+bool InputQueue::push(const InputEvent& event) {
+    size_t position = head.load(std::memory_order_relaxed);
+    if (position - tail.load(std::memory_order_acquire) >= CAPACITY) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    slots[position & (CAPACITY - 1)] = event;
+    // publish the slot before the new head
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+size_t InputQueue::pending() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+}
+
+const InputEvent& InputQueue::peek(size_t index) const {
+    return slots[(tail.load(std::memory_order_relaxed) + index) & (CAPACITY - 1)];
+}
+
+void InputQueue::pop(size_t count) {
+    // the producer may reuse the slots once it sees the new tail
+    tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
@@ -7,6 +7,15 @@
 #include <string>
 #include <vector>
 #include <float.h>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstring>
+#include <type_traits>
+#include <sstream>
 
 #include "glm/detail/type_mat.hpp"
 #include "glm/detail/type_vec.hpp"
@@ -15,80 +24,41 @@
 #include "camera.h"
 #include "stb_image.h"
 #include "audio_manager.h"
-#include "stb_easy_font.h"
+#include "particle_system.h"
+#include "texture_cache.h"
+#include "asset_loader.h"
+#include "resource_pack.h"
+#include "frame_pacer.h"
+#include "input_queue.h"
+#include "triple_buffer.h"
+#include "alloc_tracker.h"
+#include "frame_arena.h"
+#include "text_renderer.h"
+#include "game_simulation.h"
+#include "spatial_grid.h"
+#ifdef INVADERS_EMBEDDED_SHADERS
+#include "embedded_shaders.h"
+#endif
+#ifdef INVADERS_HEADLESS
+#include "headless.h"
+#endif
 
 #include <filesystem>
 namespace fs = std::filesystem;
 
 // GLFW function declarations
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
-void processInput(GLFWwindow *window);
+void processInputEvents(GLFWwindow *window, double tickEnd);
+size_t applyInputEvents(GLFWwindow *window, size_t first, double tickEnd);
+void applyHeldInput(double tickStart, double tickEnd);
+void latchPlayerInput();
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
-unsigned int loadTexture(const std::string& path);
-
-// ===== ENEMY TRACKING SYSTEM =====
-enum EnemyType {
-    GRUNT = 0,
-    SERGEANT = 1,
-    CAPTAIN = 2
-};
+TextureLoadOptions spriteTextureOptions();
 
 // ===== EXPOSURE =====
 float exposure = 1.0f;
 
-struct Enemy {
-    glm::vec2 position;
-    glm::vec2 velocity;
-    bool isAlive;
-    EnemyType type;
-    float health;
-    float scale;
-    float animationTimer;
-    bool isAttacking;
-    glm::vec2 formationPosition; // Original formation position
-    
-    // Curved attack variables (Galaxian style)
-    float attackTimer;           // Time since attack started
-    glm::vec2 attackStartPos;    // Position where attack began
-    glm::vec2 attackTargetPos;   // Target position for attack
-    int attackPattern;           // 0=left curve, 1=right curve, 2=direct
-    float attackSpeed;           // Speed of attack movement
-    bool hasFired;              // Whether the enemy has already fired in the current attack
-    int bulletsFired;           // Number of bullets fired during current attack
-
-    Enemy() : position(0.0f), velocity(0.0f), isAlive(true), type(GRUNT),
-              health(1.0f), scale(1.0f), animationTimer(0.0f),
-              isAttacking(false), formationPosition(0.0f),
-              attackTimer(0.0f), attackStartPos(0.0f), attackTargetPos(0.0f),
-              attackPattern(0), attackSpeed(0.7f), hasFired(false), bulletsFired(0) {}
-};
- 
-// ===== BULLET SYSTEM =====
-struct Bullet {
-    glm::vec2 position;
-    glm::vec2 velocity;
-    bool isActive;
-    
-    Bullet() : position(0.0f), velocity(0.0f), isActive(false) {}
-};
-
-struct EnemyBullet {
-    glm::vec2 position;
-    glm::vec2 velocity;
-    bool isActive;
-    
-    EnemyBullet() : position(0.0f), velocity(0.0f), isActive(false) {}
-};
-
-struct Explosion {
-    glm::vec2 position;
-    float timer;
-    float duration;
-    bool isActive;
-    
-    Explosion() : position(0.0f), timer(0.0f), duration(1.0f), isActive(false) {}
-};
-
 
 // ===== PARALLAX BACKGROUND SYSTEM =====
 struct ParallaxLayer {
@@ -114,22 +84,6 @@ struct TextButton {
         : text(txt), pixelX(x), pixelY(y), scale(s), color(col), bounds(0.0f) {}
 };
 
-// Level difficulty parameters
-struct LevelConfig {
-    float enemySpeed;           // Base enemy movement speed
-    float formationSwaySpeed;   // How fast formation moves side to side
-    float formationSwayAmount; // How far formation moves side to side
-    float attackInterval;      // Time between enemy attacks
-    float attackSpeed;         // Speed of attacking enemies
-    int maxSimultaneousAttacks; // Max enemies attacking at once
-    float bulletSpeedMultiplier; // Enemy bullet speed (if you add enemy bullets)
-    
-    LevelConfig(float speed = 1.0f, float swaySpeed = 0.5f, float swayAmount = 0.3f,
-                float interval = 2.0f, float attackSpd = 0.8f, int maxAttacks = 2)
-        : enemySpeed(speed), formationSwaySpeed(swaySpeed), formationSwayAmount(swayAmount),
-          attackInterval(interval), attackSpeed(attackSpd), maxSimultaneousAttacks(maxAttacks),
-          bulletSpeedMultiplier(1.0f) {}
-};
 
 // ===== COLLISION DETECTION =====
 // Simple circular collision detection
@@ -144,27 +98,77 @@ const float ENEMY_RADIUS = 0.12f;       // Enemy collision radius
 const float BULLET_RADIUS = 0.05f;      // Bullet collision radius
 
 // ===== GAME STATE SYSTEM =====
-enum class GameState { 
-    MENU, 
-    PLAYING, 
-    LEVEL_COMPLETE,
-    GAME_OVER, 
-    GAME_WON 
-};
 GameState gameState = GameState::MENU;
 GameState prevGameState = GameState::MENU; // Track state changes for audio
 
 // Background music control
 const char* BACKGROUND_TRACK = "background"; // key for audio manager
 
+// ===== ASSET STREAMING =====
+// Textures, the player model and sounds decode on AssetLoader workers while the
+// menu is already running; the GL uploads get a slice of each frame
+const double ASSET_UPLOAD_BUDGET_MS = 4.0;
+bool assetsLoaded = false;  // the game can only be started once everything is resident
+
+// ===== FRAME PACING =====
+// Frame rate cap per GameState (0 = uncapped, indexed by the enum). The menu and
+// end screens only scroll the parallax layers and wait for a click, so they run
+// at a low rate and block in glfwWaitEventsTimeout between frames. An unfocused
+// window drops to unfocusedFrameRate and an iconified one stops rendering.
+const char* const GAME_STATE_NAMES[] = {"menu", "playing", "level_complete", "game_over", "game_won"};
+double frameRateLimits[] = {30.0, 0.0, 0.0, 30.0, 30.0};
+double unfocusedFrameRate = 10.0;
+const double ICONIFIED_WAIT_SECONDS = 0.25;
+FramePacer framePacer;
+
+bool isIdleState(GameState state) {
+    return state == GameState::MENU || state == GameState::GAME_OVER || state == GameState::GAME_WON;
+}
+
+// "--fps-limit playing=144", "--fps-limit unfocused=5"; false for an unknown name
+bool parseFrameRateLimit(const std::string& setting) {
+    size_t separator = setting.find('=');
+    if (separator == std::string::npos) return false;
+    std::string name = setting.substr(0, separator);
+    double rate = std::max(0.0, std::atof(setting.c_str() + separator + 1));
+    if (name == "unfocused") {
+        unfocusedFrameRate = rate;
+        return true;
+    }
+    for (size_t i = 0; i < sizeof(GAME_STATE_NAMES) / sizeof(GAME_STATE_NAMES[0]); i++) {
+        if (name == GAME_STATE_NAMES[i]) {
+            frameRateLimits[i] = rate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===== FRAME ALLOCATIONS =====
+// Temporaries that only live for one frame (formatted HUD strings) come from
+// frameArena, which is reset at the start of every frame. Heap allocations are
+// counted per thread (AllocationTracker) and logged with the frame pacing report
+// and in the headless frame_times.csv; a headless run with --check-allocations
+// fails if any PLAYING frame after the warm-up (--allocation-warmup) touches the
+// heap. The count includes the GL driver, and a software rasterizer allocates
+// while compiling a shader variant on first use, so the warm-up has to cover the
+// first explosion.
+FrameArena frameArena(64 * 1024);
+uint64_t reportAllocations = 0;     // render thread, since the last pacing report
+uint64_t reportAllocatedBytes = 0;
+
 // ===== TEXT RENDERING INITIALIZATION =====
 
 std::vector<TextButton> menuButtons;
 
-// Text rendering globals
-unsigned int textVAO = 0, textVBO = 0;
-const int MAX_TEXT_TRIANGLES = 1024;
-Shader* textShaderPtr = nullptr;
+// All text of a frame is queued with textRenderer.add and drawn by one flush
+TextRenderer textRenderer;
+
+// Strings that change while they are on screen
+TextLabel loadingLabel;
+TextLabel finalScoreLabel;
+TextLabel levelCompleteLabels[3];
+TextLabel hudLabels[3];
 
 // ===== GAME STATE =====
 int playerScore = 0;
@@ -202,7 +206,31 @@ std::vector<Bullet> bullets(MAX_BULLETS);
 const int MAX_EXPLOSIONS = 20;
 std::vector<Explosion> explosions(MAX_EXPLOSIONS);  // Explosion pool
 
+// Layout of resources/effects/explosion_atlas.png (see tools/explosion_atlas.cpp)
+const int EXPLOSION_FLIPBOOK_FRAMES = 16;
+const int EXPLOSION_FLIPBOOK_VARIATIONS = 4;
+
+// ===== QUALITY PROFILES =====
+// Selected with --quality low|medium|high
+struct QualityProfile {
+    const char* name;
+    bool flipbookExplosions;   // sample the pre-rendered explosion atlas instead of running explosion.fs
+    int blurPasses;            // bloom ping-pong passes (kept even)
+    int maxParticles;          // particle pool capacity
+};
+
+const QualityProfile QUALITY_PROFILES[] = {
+    {"low",    true,  4,  32768},
+    {"medium", true,  10, 65536},
+    {"high",   false, 10, 131072},
+};
+QualityProfile quality = QUALITY_PROFILES[2];
+
 AudioManager* audioManager = nullptr; // Audio manager for sound effects
+ParticleSystem* particleSystem = nullptr; // Debris, sparks and engine trails
+
+const float ENGINE_TRAIL_RATE = 240.0f;  // trail particles per second
+float engineTrailAccumulator = 0.0f;
 
 // Initial window dimensions
 const unsigned int SCREEN_WIDTH = 800;
@@ -213,9 +241,126 @@ int currentWindowWidth = SCREEN_WIDTH;
 int currentWindowHeight = SCREEN_HEIGHT;
 
 // Time
-float deltaTime = 0.0f;
+float deltaTime = 0.0f;     // simulation step; game logic only ever advances by this much
 float lastFrame = 0.0f;
 
+// ===== FIXED TIMESTEP =====
+// Game logic ticks at a fixed rate (--tick-rate) independent of the frame rate.
+// Each frame runs the ticks real time has covered and renders moving objects
+// interpolated between the last two ticks, one step behind. After a hitch at most
+// MAX_TICKS_PER_FRAME run and the rest of the time is dropped.
+const double DEFAULT_TICK_RATE = 120.0;
+const int MAX_TICKS_PER_FRAME = 8;
+double simulationStep = 1.0 / DEFAULT_TICK_RATE;
+double simulationTime = 0.0;    // end of the last tick, on the getCurrentTime() clock
+glm::vec3 previousPlayerPosition = glm::vec3(0.0f, -2.5f, 0.0f);
+bool autopilotMoving = false;   // headless autopilot moved the ship in the last tick
+
+// Set while run-ahead simulates ticks that will be thrown away: they must not
+// play sounds, spawn particles or log (see gameLog)
+bool speculating = false;
+
+// Log stream for game events
+std::ostream& gameLog() {
+    static std::ostream discard(nullptr);
+    return speculating ? discard : std::cout;
+}
+
+// ===== SIMULATION THREAD =====
+// With a window the ticks run on their own thread (--single-thread runs them in
+// turn with rendering, as headless runs always do). After each batch of ticks
+// the simulation captures a FrameSnapshot of everything the renderer needs and
+// publishes it through a triple buffer; the main thread owns the GL context and
+// the window, draws the newest snapshot and never reads the game state itself.
+// Particle bursts and the input latency bookkeeping cross over separately, since
+// a snapshot the renderer never picked up must not lose them.
+struct MovingSprite {
+    glm::vec2 previous;     // at the tick before, for interpolation
+    glm::vec2 current;
+};
+
+struct ExplosionSnapshot {
+    glm::vec2 position;
+    float timer;
+    float duration;
+    int slot;               // pool index, picks the flipbook variation
+};
+
+struct FrameSnapshot {
+    double time = 0.0;      // simulationTime when captured
+    GameState state = GameState::MENU;
+    int score = 0;
+    int lives = 0;
+    int level = 1;
+    MovingSprite player = {glm::vec2(0.0f, -2.5f), glm::vec2(0.0f, -2.5f)};
+    int playerDirection = 0;        // held movement keys, to extrapolate the ship
+    bool playerMoving = false;
+    size_t inputEventsApplied = 0;  // latencyEventsRecorded when captured
+    std::vector<MovingSprite> enemies;
+    std::vector<MovingSprite> bullets;
+    std::vector<MovingSprite> enemyBullets;
+    std::vector<ExplosionSnapshot> explosions;
+};
+
+bool simulationThreadEnabled = true;
+TripleBuffer<FrameSnapshot> frameSnapshots;
+std::atomic<bool> simulationRunning{false};
+std::atomic<bool> simulationPaused{false};  // window iconified: the game clock stops
+
+// Simulation thread counters, logged and reset with the frame pacing report
+struct SimulationStats {
+    int ticks = 0;
+    int snapshots = 0;
+    int droppedSnapshots = 0;   // replaced before the renderer picked them up
+    double busyMs = 0.0;
+    double worstBatchMs = 0.0;
+    int runAheadFrames = 0;     // snapshots captured ahead of the real state
+    double runAheadMs = 0.0;    // speculative ticks, snapshot included
+    double stateSaveUs = 0.0;
+    double stateRestoreUs = 0.0;
+    double worstStateCopyUs = 0.0;
+    uint64_t allocations = 0;   // heap allocations made by the simulation thread
+};
+std::mutex simulationStatsMutex;
+SimulationStats simulationStats;
+
+// Render thread counters for the same report
+int staleFrames = 0;            // frames that found no new snapshot
+double snapshotWaitMs = 0.0;    // time spent waiting for one
+std::vector<glm::vec2> enemyRenderPositions;
+
+std::mutex particleRequestMutex;
+std::vector<ParticleEmitter> particleRequests;  // bursts since the renderer last drained them
+const size_t MAX_PARTICLE_REQUESTS = 64;        // capacity reserved up front; more than a frame's worth
+bool particleClearRequested = false;
+
+void requestParticles(const ParticleEmitter& emitter) {
+    if (speculating) return;
+    std::lock_guard<std::mutex> lock(particleRequestMutex);
+    particleRequests.push_back(emitter);
+}
+
+// A clear also drops the bursts requested before it
+void requestParticleClear() {
+    if (speculating) return;
+    std::lock_guard<std::mutex> lock(particleRequestMutex);
+    particleRequests.clear();
+    particleClearRequested = true;
+}
+
+// ===== HEADLESS MODE =====
+// Without a window the game runs on a virtual clock advanced by a fixed step per
+// frame, so headless runs are deterministic and comparable between builds
+bool headlessMode = false;
+double headlessClock = 0.0;
+
+// Framebuffer that stands in for the window (0, or the offscreen target when headless)
+unsigned int screenFramebuffer = 0;
+
+double getCurrentTime() {
+    return headlessMode ? headlessClock : glfwGetTime();
+}
+
 // Player position
 glm::vec3 playerPosition = glm::vec3(0.0f, -2.5f, 0.0f);
 const float playerSpeed = 2.0f;
@@ -233,6 +378,75 @@ const float ENEMY_SPACING_Y = 0.5f;      // Fits 3 rows in upper bounds
 const float FORMATION_START_X = -3.0f;  // Centers formation in X bounds
 const float FORMATION_START_Y = 2.0f;    // Positions formation in upper Y area
 
+// Grid initializeEnemies builds: the one above unless --formation or --swarm
+// asks for another
+FormationConfig formation = {ENEMIES_PER_ROW, ENEMY_ROWS, ENEMY_SPACING_X, ENEMY_SPACING_Y,
+                             FORMATION_START_X, FORMATION_START_Y, 1.0f};
+
+// ===== SWARM MODE =====
+// Custom formations are centred across the top of the screen, squeezed into
+// the swarm area when they don't fit at the classic spacing, and their enemies
+// (sprite and collision radius) shrink with the spacing
+const int SWARM_COLUMNS = 96;
+const int SWARM_ROWS = 40;
+const float SWARM_AREA_WIDTH = 7.2f;
+const float SWARM_AREA_TOP = 2.6f;
+const float SWARM_AREA_HEIGHT = 2.2f;
+const int MAX_FORMATION_ENEMIES = 100000;
+
+// Formations at least this large test bullets against an enemy grid instead of every enemy
+const size_t ENEMY_GRID_MIN_ENEMIES = 128;
+SpatialGrid enemyGrid;
+
+// spacing <= 0 fits the formation into the swarm area; larger spacing than the
+// area allows is clamped, so rows never reach down to the player
+void configureFormation(int columns, int rows, float spacingX, float spacingY) {
+    float fitX = columns > 1 ? SWARM_AREA_WIDTH / (columns - 1) : FLT_MAX;
+    float fitY = rows > 1 ? SWARM_AREA_HEIGHT / (rows - 1) : FLT_MAX;
+    if (spacingX <= 0.0f) spacingX = std::min(ENEMY_SPACING_X, fitX);
+    if (spacingY <= 0.0f) spacingY = std::min(ENEMY_SPACING_Y, fitY);
+    if (spacingX > fitX || spacingY > fitY) {
+        spacingX = std::min(spacingX, fitX);
+        spacingY = std::min(spacingY, fitY);
+        std::cerr << "WARNING::FORMATION::" << columns << "x" << rows << " does not fit on screen at the given spacing, using "
+                  << spacingX << "," << spacingY << std::endl;
+    }
+
+    formation.columns = columns;
+    formation.rows = rows;
+    formation.spacingX = spacingX;
+    formation.spacingY = spacingY;
+    if (columns == ENEMIES_PER_ROW && rows == ENEMY_ROWS && spacingX == ENEMY_SPACING_X && spacingY == ENEMY_SPACING_Y) {
+        // asked for explicitly, the classic formation keeps its classic place
+        formation.startX = FORMATION_START_X;
+        formation.startY = FORMATION_START_Y;
+    } else {
+        formation.startX = -0.5f * (columns - 1) * spacingX;
+        formation.startY = SWARM_AREA_TOP;
+    }
+    formation.enemySize = std::min(1.0f, std::min(spacingX / ENEMY_SPACING_X, spacingY / ENEMY_SPACING_Y));
+}
+
+// "COLSxROWS", e.g. 96x40
+bool parseFormationSize(const std::string& text, int& columns, int& rows) {
+    char separator = 0;
+    std::istringstream stream(text);
+    if (!(stream >> columns >> separator >> rows) || separator != 'x' || !stream.eof()) return false;
+    return columns > 0 && rows > 0 && static_cast<long>(columns) * rows <= MAX_FORMATION_ENEMIES;
+}
+
+// "X" or "X,Y" in world units
+bool parseFormationSpacing(const std::string& text, float& spacingX, float& spacingY) {
+    char separator = 0;
+    std::istringstream stream(text);
+    if (!(stream >> spacingX) || spacingX <= 0.0f) return false;
+    spacingY = spacingX;
+    if (stream >> separator) {
+        if (separator != ',' || !(stream >> spacingY) || spacingY <= 0.0f) return false;
+    }
+    return stream.eof();
+}
+
 std::vector<Enemy> enemies(TOTAL_ENEMIES);
 std::vector<glm::vec2> aliveEnemyPositions;
 
@@ -244,6 +458,91 @@ const float ATTACK_INTERVAL = 2.0f;  // Time between attacks (2 seconds)
 float lastBulletTime = 0.0f;
 const float BULLET_COOLDOWN = 0.50f;  // 0.50 seconds between bullets
 
+// ===== INPUT =====
+// The GLFW callbacks only timestamp key changes and menu clicks into inputQueue.
+// Each tick consumes them in order, so a tap shorter than a frame still moves the
+// ship and a shot leaves at the moment it was pressed. Single-threaded, the queue
+// is polled again right before the ship is drawn and its movement latched up to
+// that instant; the render thread instead extrapolates the ship from the snapshot.
+InputQueue inputQueue;
+bool keysDown[GLFW_KEY_LAST + 1] = {};
+double playerInputTime = 0.0;   // held-key movement has been applied up to this time
+size_t latchedEventCount = 0;   // queued events already applied ahead of their tick (late latch or run-ahead)
+
+// --measure-latency: time from an input event to the end of the first frame
+// presented with it applied (glFinish after the swap stands in for scan-out)
+bool measureLatency = false;
+const double LATENCY_REPORT_INTERVAL_SECONDS = 5.0;
+std::mutex latencyMutex;
+std::vector<double> latencyEventTimes;  // guarded: applied events not yet presented, oldest first
+size_t latencyEventsRecorded = 0;       // guarded: events ever applied
+size_t latencyEventsPresented = 0;      // render thread: events ever presented
+std::vector<double> latencySamples;     // seconds, since the last report
+double lastLatencyReport = 0.0;
+
+void noteAppliedInput(double eventTime) {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    latencyEventTimes.push_back(eventTime);
+    latencyEventsRecorded++;
+}
+
+// +1 right, -1 left, 0 for neither or both
+int heldMoveDirection() {
+    return ((keysDown[GLFW_KEY_D] || keysDown[GLFW_KEY_RIGHT]) ? 1 : 0) -
+           ((keysDown[GLFW_KEY_A] || keysDown[GLFW_KEY_LEFT]) ? 1 : 0);
+}
+
+// Moves the ship for the keys held between playerInputTime and time
+void advancePlayerTo(double time) {
+    if (time <= playerInputTime) return;
+    if (gameState == GameState::PLAYING) {
+        playerPosition.x += playerSpeed * heldMoveDirection() * static_cast<float>(time - playerInputTime);
+        playerPosition.x = glm::clamp(playerPosition.x, -WORLD_HALF_WIDTH, WORLD_HALF_WIDTH);
+    }
+    playerInputTime = time;
+}
+
+// Idempotent, so events the late latch applied can be replayed by the tick
+void applyKeyState(const InputEvent& event) {
+    if (event.type == InputEvent::KEY) {
+        keysDown[event.code] = event.action == GLFW_PRESS;
+    }
+}
+
+void reportInputLatency() {
+    if (latencySamples.empty()) return;
+    std::vector<double> sorted = latencySamples;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double sample : sorted) sum += sample;
+    std::cout << "Input latency: " << sorted.size() << " events, avg " << 1000.0 * sum / sorted.size()
+              << " ms, p95 " << 1000.0 * sorted[(sorted.size() - 1) * 95 / 100]
+              << " ms, max " << 1000.0 * sorted.back() << " ms";
+    if (inputQueue.droppedCount() > 0) std::cout << " (" << inputQueue.droppedCount() << " events dropped)";
+    std::cout << std::endl;
+    latencySamples.clear();
+}
+
+// Call right after the swap with the number of events applied (ever) in the
+// frame just presented
+void recordInputLatency(size_t eventsApplied) {
+    glFinish();
+    double presented = glfwGetTime();
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        size_t count = std::min(eventsApplied - std::min(eventsApplied, latencyEventsPresented), latencyEventTimes.size());
+        for (size_t i = 0; i < count; i++) {
+            latencySamples.push_back(presented - latencyEventTimes[i]);
+        }
+        latencyEventTimes.erase(latencyEventTimes.begin(), latencyEventTimes.begin() + count);
+        latencyEventsPresented += count;
+    }
+    if (presented - lastLatencyReport >= LATENCY_REPORT_INTERVAL_SECONDS) {
+        reportInputLatency();
+        lastLatencyReport = presented;
+    }
+}
+
 // Enemy bullet constants
 const int MAX_ENEMY_BULLETS = 20;  // Maximum enemy bullets on screen
 const float ENEMY_BULLET_SPEED = 3.0f;  // Slightly slower than player bullets
@@ -254,6 +553,116 @@ const float NEAREST_SHOOT_INTERVAL = 3.0f;  // More frequent shooting for neares
 std::vector<EnemyBullet> enemyBullets(MAX_ENEMY_BULLETS);
 float lastNonAttackingShootTime = 0.0f;
 
+// Game logic draws from its own generator instead of rand(), so run-ahead can
+// save and restore it with the rest of the state
+unsigned int simulationRandomState = 1;
+
+// 0..32767, like rand()
+int simulationRandom() {
+    simulationRandomState = simulationRandomState * 1103515245u + 12345u;
+    return static_cast<int>((simulationRandomState >> 16) & 0x7FFF);
+}
+
+// ===== RUN-AHEAD =====
+// --run-ahead N hides N ticks of input latency: before each snapshot the world
+// is saved, simulated N ticks further on the input held right now, captured for
+// the renderer and restored. Everything a tick reads or writes lives in pools
+// sized at startup and scalars, so the whole world copies into one
+// SimulationState with a handful of memcpys (into vectors that keep their
+// capacity after the first save). aliveEnemyPositions is left out; every tick
+// that reads it rebuilds it first.
+const int MAX_RUN_AHEAD_TICKS = 8;
+int runAheadTicks = 0;
+
+struct SimulationState {
+    std::vector<Enemy> enemies;
+    std::vector<Bullet> bullets;
+    std::vector<EnemyBullet> enemyBullets;
+    std::vector<Explosion> explosions;
+    bool keysDown[GLFW_KEY_LAST + 1];
+    LevelConfig levelConfig;
+    glm::vec3 playerPosition;
+    glm::vec3 previousPlayerPosition;
+    GameState gameState;
+    int playerScore;
+    int playerLives;
+    int currentLevel;
+    bool levelComplete;
+    bool autopilotMoving;
+    float levelTransitionTimer;
+    float lastAttackTime;
+    float lastBulletTime;
+    float lastNonAttackingShootTime;
+    double simulationTime;
+    double playerInputTime;
+    unsigned int randomState;
+};
+static_assert(std::is_trivially_copyable<Enemy>::value && std::is_trivially_copyable<Bullet>::value &&
+              std::is_trivially_copyable<EnemyBullet>::value && std::is_trivially_copyable<Explosion>::value,
+              "pool entries must be memcpy-able");
+SimulationState runAheadState;
+
+// Copies a pool, reusing the destination's storage once it has the size
+template <typename T>
+void copyPool(std::vector<T>& destination, const std::vector<T>& source) {
+    destination.resize(source.size());
+    std::memcpy(destination.data(), source.data(), source.size() * sizeof(T));
+}
+
+// Bytes saveSimulationState copies
+size_t simulationStateBytes(const SimulationState& state) {
+    return sizeof(state) + state.enemies.size() * sizeof(Enemy) + state.bullets.size() * sizeof(Bullet) +
+           state.enemyBullets.size() * sizeof(EnemyBullet) + state.explosions.size() * sizeof(Explosion);
+}
+
+void saveSimulationState(SimulationState& state) {
+    copyPool(state.enemies, enemies);
+    copyPool(state.bullets, bullets);
+    copyPool(state.enemyBullets, enemyBullets);
+    copyPool(state.explosions, explosions);
+    std::memcpy(state.keysDown, keysDown, sizeof(state.keysDown));
+    state.levelConfig = currentLevelConfig;
+    state.playerPosition = playerPosition;
+    state.previousPlayerPosition = previousPlayerPosition;
+    state.gameState = gameState;
+    state.playerScore = playerScore;
+    state.playerLives = playerLives;
+    state.currentLevel = currentLevel;
+    state.levelComplete = levelComplete;
+    state.autopilotMoving = autopilotMoving;
+    state.levelTransitionTimer = levelTransitionTimer;
+    state.lastAttackTime = lastAttackTime;
+    state.lastBulletTime = lastBulletTime;
+    state.lastNonAttackingShootTime = lastNonAttackingShootTime;
+    state.simulationTime = simulationTime;
+    state.playerInputTime = playerInputTime;
+    state.randomState = simulationRandomState;
+}
+
+void restoreSimulationState(const SimulationState& state) {
+    copyPool(enemies, state.enemies);
+    copyPool(bullets, state.bullets);
+    copyPool(enemyBullets, state.enemyBullets);
+    copyPool(explosions, state.explosions);
+    std::memcpy(keysDown, state.keysDown, sizeof(state.keysDown));
+    currentLevelConfig = state.levelConfig;
+    playerPosition = state.playerPosition;
+    previousPlayerPosition = state.previousPlayerPosition;
+    gameState = state.gameState;
+    playerScore = state.playerScore;
+    playerLives = state.playerLives;
+    currentLevel = state.currentLevel;
+    levelComplete = state.levelComplete;
+    autopilotMoving = state.autopilotMoving;
+    levelTransitionTimer = state.levelTransitionTimer;
+    lastAttackTime = state.lastAttackTime;
+    lastBulletTime = state.lastBulletTime;
+    lastNonAttackingShootTime = state.lastNonAttackingShootTime;
+    simulationTime = state.simulationTime;
+    playerInputTime = state.playerInputTime;
+    simulationRandomState = state.randomState;
+}
+
 // Mouse initial position
 float lastX = SCREEN_WIDTH/2.0;
 float lastY = SCREEN_HEIGHT/2.0;
@@ -347,20 +756,23 @@ glm::vec2 calculateCurvedAttackPosition(const Enemy& enemy) {
 }
 
 void createExplosion(glm::vec2 position) {
-    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+    if (particleSystem) {
+        requestParticles(ParticleEmitter::explosionDebris(position));
+    }
+    for (size_t i = 0; i < explosions.size(); i++) {
         if (!explosions[i].isActive) {
             explosions[i].position = position;
             explosions[i].timer = 0.0f;
             explosions[i].duration = 1.2f; // Longer to enjoy the enhanced boom
             explosions[i].isActive = true;
-            std::cout << "Explosion created at (" << position.x << ", " << position.y << ")" << std::endl;
+            gameLog() << "Explosion created at (" << position.x << ", " << position.y << ")" << std::endl;
             break;
         }
     }
 }
 
 void updateExplosions(float deltaTime) {
-    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+    for (size_t i = 0; i < explosions.size(); i++) {
         if (explosions[i].isActive) {
             explosions[i].timer += deltaTime;
             if (explosions[i].timer >= explosions[i].duration) {
@@ -371,18 +783,20 @@ void updateExplosions(float deltaTime) {
 }
 
 void initializeEnemies() {
+    enemies.resize(formation.count());
     int index = 0;
-    for (int row=0; row<ENEMY_ROWS; row++) {
-        for (int col=0; col<ENEMIES_PER_ROW; col++) {
-            float x = FORMATION_START_X + col * ENEMY_SPACING_X;
-            float y = FORMATION_START_Y - row * ENEMY_SPACING_Y;
+    for (int row=0; row<formation.rows; row++) {
+        for (int col=0; col<formation.columns; col++) {
+            float x = formation.startX + col * formation.spacingX;
+            float y = formation.startY - row * formation.spacingY;
 
             enemies[index].position = glm::vec2(x, y);
+            enemies[index].previousPosition = enemies[index].position;
             enemies[index].formationPosition = glm::vec2(x, y);
             enemies[index].velocity = glm::vec2(0.0f, 0.0f);
             enemies[index].isAlive = true;
             enemies[index].health = 1.0f;
-            enemies[index].scale = 0.25f;
+            enemies[index].scale = 0.25f * formation.enemySize;
             enemies[index].animationTimer = 0.0f;
             enemies[index].isAttacking = false;
             enemies[index].hasFired = false;
@@ -394,12 +808,13 @@ void initializeEnemies() {
     }
 }
 
-// Create a new bullet at player position (from spaceship tip)
-void createBullet() {
-    for (int i = 0; i < MAX_BULLETS; i++) {
+// Create a new bullet at player position (from spaceship tip), already moved
+// travelTime seconds along its path
+void createBullet(float travelTime = 0.0f) {
+    for (size_t i = 0; i < bullets.size(); i++) {
         if (!bullets[i].isActive) {
             // PLAY LASER SOUND
-            if (audioManager) {
+            if (audioManager && !speculating) {
                 audioManager->playSound("laser", 0.5f, 1.0f);
             }
             
@@ -407,50 +822,91 @@ void createBullet() {
             // Since spaceship is rotated 90 degrees, the "tip" is in the +Y direction
             bullets[i].position = glm::vec2(playerPosition.x, playerPosition.y + 0.15f); // From spaceship tip
             bullets[i].velocity = glm::vec2(0.0f, BULLET_SPEED); // Move upward
+            bullets[i].position += bullets[i].velocity * travelTime;
+            bullets[i].previousPosition = bullets[i].position;
             bullets[i].isActive = true;
             break; // Only fire one bullet per call
         }
     }
 }
 
+// Rebuilds enemyGrid from the alive enemies; enemies don't move while bullets update
+void buildEnemyGrid() {
+    float enemyRadius = ENEMY_RADIUS * formation.enemySize;
+    enemyGrid.begin(glm::vec2(-WORLD_HALF_WIDTH, -WORLD_HALF_HEIGHT),
+                    glm::vec2(WORLD_HALF_WIDTH, WORLD_HALF_HEIGHT), 2.0f * (enemyRadius + BULLET_RADIUS));
+    for (int i = 0; i < static_cast<int>(enemies.size()); i++) {
+        if (enemies[i].isAlive) enemyGrid.insert(i, enemies[i].position);
+    }
+    enemyGrid.end();
+}
+
+// Index of the first alive enemy the bullet touches, or -1
+int findBulletHit(const Bullet& bullet, bool useGrid) {
+    float enemyRadius = ENEMY_RADIUS * formation.enemySize;
+    if (!useGrid) {
+        for (int j = 0; j < static_cast<int>(enemies.size()); j++) {
+            if (enemies[j].isAlive &&
+                checkCollision(bullet.position, BULLET_RADIUS, enemies[j].position, enemyRadius)) {
+                return j;
+            }
+        }
+        return -1;
+    }
+
+    // Cells are visited out of index order, so keep the lowest hit to match the scan above
+    int hit = -1;
+    enemyGrid.query(bullet.position, BULLET_RADIUS + enemyRadius, [&](int j) {
+        if ((hit < 0 || j < hit) && enemies[j].isAlive &&
+            checkCollision(bullet.position, BULLET_RADIUS, enemies[j].position, enemyRadius)) {
+            hit = j;
+        }
+    });
+    return hit;
+}
+
 // Update all active bullets
 void updateBullets(float deltaTime) {
-    for (int i = 0; i < MAX_BULLETS; i++) {
+    bool useGrid = enemies.size() >= ENEMY_GRID_MIN_ENEMIES;
+    bool gridBuilt = false;
+    for (size_t i = 0; i < bullets.size(); i++) {
         if (bullets[i].isActive) {
             // Move bullet upward
             bullets[i].position += bullets[i].velocity * deltaTime;
             
             // Check collision with enemies
-            for (int j = 0; j < TOTAL_ENEMIES; j++) {
-                if (enemies[j].isAlive && 
-                    checkCollision(bullets[i].position, BULLET_RADIUS, 
-                                 enemies[j].position, ENEMY_RADIUS)) {
-
-                    createExplosion(enemies[j].position);
-
-                    // PLAY EXPLOSION SOUND
-                    if (audioManager) {
-                        audioManager->play3DSound("explosion", 
-                                                enemies[j].position.x, 
-                                                enemies[j].position.y, 
-                                                0.0f, 
-                                                0.5f); // Volume
-                    }
+            if (useGrid && !gridBuilt) {
+                buildEnemyGrid();
+                gridBuilt = true;
+            }
+            int j = findBulletHit(bullets[i], useGrid);
+            if (j >= 0) {
+                createExplosion(enemies[j].position);
+                if (particleSystem) {
+                    requestParticles(ParticleEmitter::hitSparks(bullets[i].position, bullets[i].velocity));
+                }
 
-                    // Hit detected!
-                    enemies[j].isAlive = false;  // Destroy enemy
-                    bullets[i].isActive = false; // Destroy bullet
-                    
-                    // Add score based on enemy type
-                    switch(enemies[j].type) {
-                        case GRUNT: playerScore += 10; break;
-                        case SERGEANT: playerScore += 20; break;
-                        case CAPTAIN: playerScore += 50; break;
-                    }
-                    
-                    std::cout << "Enemy destroyed! Score: " << playerScore << std::endl;
-                    break; // Bullet can only hit one enemy
+                // PLAY EXPLOSION SOUND
+                if (audioManager && !speculating) {
+                    audioManager->play3DSound("explosion", 
+                                            enemies[j].position.x, 
+                                            enemies[j].position.y, 
+                                            0.0f, 
+                                            0.5f); // Volume
+                }
+
+                // Hit detected!
+                enemies[j].isAlive = false;  // Destroy enemy
+                bullets[i].isActive = false; // Destroy bullet
+                
+                // Add score based on enemy type
+                switch(enemies[j].type) {
+                    case GRUNT: playerScore += 10; break;
+                    case SERGEANT: playerScore += 20; break;
+                    case CAPTAIN: playerScore += 50; break;
                 }
+                
+                gameLog() << "Enemy destroyed! Score: " << playerScore << std::endl;
             }
             
             // Deactivate bullet if it goes off screen
@@ -463,14 +919,15 @@ void updateBullets(float deltaTime) {
 
 // Create enemy bullet at enemy position
 void createEnemyBullet(const Enemy& enemy) {
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
+    for (size_t i = 0; i < enemyBullets.size(); i++) {
         if (!enemyBullets[i].isActive) {
             // Play shoot sound (optional - use a different sound than player)
-            if (audioManager) {
+            if (audioManager && !speculating) {
                 audioManager->play3DSound("laser", enemy.position.x, enemy.position.y, 0.0f, 0.3f);
             }
             
             enemyBullets[i].position = enemy.position;
+            enemyBullets[i].previousPosition = enemy.position;
             
             // Calculate direction towards player
             glm::vec2 dirToPlayer = glm::normalize(
@@ -478,7 +935,7 @@ void createEnemyBullet(const Enemy& enemy) {
             );
             
             // Add slight randomness to shooting direction
-            float randomAngle = (rand() % 40 - 20) * 0.01f; // ±20 degrees
+            float randomAngle = (simulationRandom() % 40 - 20) * 0.01f; // ±20 degrees
             float cs = cos(randomAngle);
             float sn = sin(randomAngle);
             glm::vec2 randomizedDir = glm::vec2(
@@ -495,7 +952,7 @@ void createEnemyBullet(const Enemy& enemy) {
 
 // Update enemy bullets
 void updateEnemyBullets(float deltaTime) {
-    for (int i=0; i<MAX_ENEMY_BULLETS; i++) {
+    for (size_t i=0; i<enemyBullets.size(); i++) {
         if (enemyBullets[i].isActive) {
             // Move bullet towards player
             enemyBullets[i].position += enemyBullets[i].velocity * deltaTime;
@@ -504,7 +961,7 @@ void updateEnemyBullets(float deltaTime) {
             if (checkCollision(enemyBullets[i].position, BULLET_RADIUS, 
                                glm::vec2(playerPosition.x, playerPosition.y), PLAYER_RADIUS)) {
                 // PLAY EXPLOSION SOUND
-                if (audioManager) {
+                if (audioManager && !speculating) {
                     audioManager->play3DSound("explosion", 
                                               playerPosition.x, 
                                               playerPosition.y, 
@@ -512,12 +969,16 @@ void updateEnemyBullets(float deltaTime) {
                                               0.5f); // Volume
                 }
                 
+                if (particleSystem) {
+                    requestParticles(ParticleEmitter::hitSparks(enemyBullets[i].position, enemyBullets[i].velocity));
+                }
+
                 // Deactivate bullet
                 enemyBullets[i].isActive = false;
                 // Player hit!
                 playerLives--;
 
-                std::cout << "Player hit! Lives remaining: " << playerLives << std::endl;
+                gameLog() << "Player hit! Lives remaining: " << playerLives << std::endl;
 
                 // Create explosion at player position
                 createExplosion(enemyBullets[i].position);
@@ -525,7 +986,7 @@ void updateEnemyBullets(float deltaTime) {
                 // Check game over condition
                 if (playerLives <= 0) {
                     gameState = GameState::GAME_OVER;
-                    std::cout << "Game Over!" << std::endl;
+                    gameLog() << "Game Over!" << std::endl;
                 }
                 continue; // No need to check further
             }
@@ -543,176 +1004,52 @@ void updateEnemyBullets(float deltaTime) {
 
 
 // ===== TEXT RENDERING FUNCTIONS =====
-glm::vec4 calculateTextBounds(const char* text, float x, float y, float scale) {
-    char buffer[9999];
-    int numQuads = stb_easy_font_print(0, 0, (char*)text, nullptr, buffer, sizeof(buffer));
-    
-    if (numQuads == 0) return glm::vec4(0.0f);
-    
-    float minX = FLT_MAX, minY = FLT_MAX;
-    float maxX = -FLT_MAX, maxY = -FLT_MAX;
-    
-    // Find bounding box of all character quads
-    for (int q = 0; q < numQuads; ++q) {
-        // Each quad has 4 vertices, each vertex is 16 bytes
-        char* quadData = buffer + q * 4 * 16;
-        
-        for (int i = 0; i < 4; ++i) {
-            auto* vertex = reinterpret_cast<float*>(quadData + i * 16);
-            float px = x + vertex[0] * scale;  // vertex[0] is x
-            float py = y + vertex[1] * scale;  // vertex[1] is y
-            
-            minX = std::min(minX, px);
-            maxX = std::max(maxX, px);
-            minY = std::min(minY, py);
-            maxY = std::max(maxY, py);
-        }
-    }
-    
-    // Convert to NDC using current window dimensions
-    float ndcX0 =  minX / (currentWindowWidth  * 0.5f) - 1.0f;
-    float ndcX1 =  maxX / (currentWindowWidth  * 0.5f) - 1.0f;
-    float ndcY0 = -maxY / (currentWindowHeight * 0.5f) + 1.0f;  // flip Y
-    float ndcY1 = -minY / (currentWindowHeight * 0.5f) + 1.0f;
-    
-    return {ndcX0, ndcY0, ndcX1, ndcY1};  // x0,y0,x1,y1
-}
-
-void renderText(const char* txt, float x, float y, float scale, const glm::vec3& rgb) {
-    char buffer[9999];
-    int numQuads = stb_easy_font_print(0, 0, (char*)txt, nullptr, buffer, sizeof(buffer));
-    
-    if (numQuads == 0) return;
-
-    // Convert quads to triangles with proper vertex format parsing
-    // stb_easy_font vertex format: x(float), y(float), z(float), color(uint8[4]) = 16 bytes per vertex
-    std::vector<float> verts;
-    verts.reserve(numQuads * 6 * 2);   // 6 verts per quad, 2 floats each (x,y)
-
-    for (int q = 0; q < numQuads; ++q) {
-        // Each quad has 4 vertices, each vertex is 16 bytes
-        char* quadData = buffer + q * 4 * 16;
-        float vx[4], vy[4];
-        
-        // Extract x,y from each vertex (skip z and color)
-        for (int i = 0; i < 4; ++i) {
-            float* vertex = (float*)(quadData + i * 16);
-            
-            // Apply scaling and positioning 
-            vx[i] = x + vertex[0] * scale;  // vertex[0] is x
-            vy[i] = y + vertex[1] * scale;  // vertex[1] is y
-            
-            // Convert pixels to NDC using current window dimensions
-            vx[i] =  vx[i] / (currentWindowWidth  * 0.5f) - 1.0f;
-            vy[i] = -vy[i] / (currentWindowHeight * 0.5f) + 1.0f;  // flip Y
-        }
-        
-        // Convert quad to two triangles: (0,1,2) and (0,2,3)
-        int indices[6] = {0,1,2,0,2,3};
-        for (int i = 0; i < 6; ++i) {
-            verts.push_back(vx[indices[i]]);
-            verts.push_back(vy[indices[i]]);
-        }
-    }
-
-    if (verts.empty()) return;
-
-    // Check if textShaderPtr is valid
-    if (!textShaderPtr) {
-        std::cout << "ERROR: textShaderPtr is null!" << std::endl;
-        return;
-    }
-
-    // Upload vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    if (verts.size() * sizeof(float) <= MAX_TEXT_TRIANGLES * 3 * 2 * sizeof(float)) {
-        glBufferSubData(GL_ARRAY_BUFFER, 0, verts.size() * sizeof(float), verts.data());
-    } else {
-        std::cout << "Text buffer overflow!" << std::endl;
-        return;
-    }
-
-    // Render
-    textShaderPtr->use();
-    glm::mat4 I(1.0f);
-    textShaderPtr->setMat4("projection", I);      // already in clip space
-    textShaderPtr->setVec3("color", rgb);
-
-    // Ensure proper OpenGL state for text rendering
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-    glBindVertexArray(textVAO);
-    glDrawArrays(GL_TRIANGLES, 0, verts.size() / 2);
-    glBindVertexArray(0);
-}
-
-// Helper function to get text width for centering
-float getTextWidth(const char* text, float scale) {
-    char buffer[9999];
-    int numQuads = stb_easy_font_print(0, 0, (char*)text, nullptr, buffer, sizeof(buffer));
-    
-    if (numQuads == 0) return 0.0f;
-    
-    float minX = FLT_MAX, maxX = -FLT_MAX;
-    for (int q = 0; q < numQuads; ++q) {
-        // Each quad has 4 vertices, each vertex is 16 bytes
-        char* quadData = buffer + q * 4 * 16;
-        for (int i = 0; i < 4; ++i) {
-            float* vertex = (float*)(quadData + i * 16);
-            float px = vertex[0] * scale;  // vertex[0] is x coordinate
-            minX = std::min(minX, px);
-            maxX = std::max(maxX, px);
-        }
-    }
-    return maxX - minX;
-}
-
 void initMenuButtons() {
     menuButtons.clear();
     
     // Add GALAXIAN title (centered)
     const char* titleText = "INVADERS 1999";
     float titleScale = 4.0f;
-    float titleWidth = getTextWidth(titleText, titleScale);
+    float titleWidth = textRenderer.width(titleText, titleScale);
     float titleX = (currentWindowWidth - titleWidth) / 2.0f;
     TextButton titleButton(titleText, titleX, currentWindowHeight * 0.25f, titleScale, glm::vec3(1.0f, 1.0f, 1.0f));
-    titleButton.bounds = calculateTextBounds(titleButton.text.c_str(), titleButton.pixelX, titleButton.pixelY, titleButton.scale);
+    titleButton.bounds = textRenderer.bounds(titleButton.text.c_str(), titleButton.pixelX, titleButton.pixelY, titleButton.scale,
+                                          currentWindowWidth, currentWindowHeight);
     menuButtons.push_back(titleButton);
     
     // Add start button (centered)
     const char* startText = "CLICK TO START";
     float startScale = 2.5f;
-    float startWidth = getTextWidth(startText, startScale);
+    float startWidth = textRenderer.width(startText, startScale);
     float startX = (currentWindowWidth - startWidth) / 2.0f;
     TextButton startButton(startText, startX, currentWindowHeight/2.0f, startScale, glm::vec3(1.0f, 1.0f, 0.0f));
-    startButton.bounds = calculateTextBounds(startButton.text.c_str(), startButton.pixelX, startButton.pixelY, startButton.scale);
+    startButton.bounds = textRenderer.bounds(startButton.text.c_str(), startButton.pixelX, startButton.pixelY, startButton.scale,
+                                          currentWindowWidth, currentWindowHeight);
     menuButtons.push_back(startButton);
     
     // Add quit button (centered)
     const char* quitText = "PRESS ESC TO QUIT";
     float quitScale = 1.5f;
-    float quitWidth = getTextWidth(quitText, quitScale);
+    float quitWidth = textRenderer.width(quitText, quitScale);
     float quitX = (currentWindowWidth - quitWidth) / 2.0f;
     TextButton quitButton(quitText, quitX, currentWindowHeight/2.0f + 60.0f, quitScale, glm::vec3(0.8f, 0.8f, 1.0f));
-    quitButton.bounds = calculateTextBounds(quitButton.text.c_str(), quitButton.pixelX, quitButton.pixelY, quitButton.scale);
+    quitButton.bounds = textRenderer.bounds(quitButton.text.c_str(), quitButton.pixelX, quitButton.pixelY, quitButton.scale,
+                                          currentWindowWidth, currentWindowHeight);
     menuButtons.push_back(quitButton);
 }
 
 void updateEnemies(float deltaTime) {
-    // Update alive enemies list for rendering
+    // Update alive enemies list (empty once the level is cleared)
     aliveEnemyPositions.clear();
     
-    float currentTime = glfwGetTime();
+    float currentTime = simulationTime;
+    int enemyCount = static_cast<int>(enemies.size());
     int attackingCount = 0;
     float nearestDistance = FLT_MAX;
     Enemy* nearestEnemy = nullptr;
 
     // Count currently attacking enemies
-    for (int i = 0; i < TOTAL_ENEMIES; i++) {
+    for (int i = 0; i < enemyCount; i++) {
         if (enemies[i].isAlive) {
             float dist = glm::length(glm::vec2(playerPosition.x, playerPosition.y) - enemies[i].position);
             // Find nearest enemy
@@ -734,7 +1071,7 @@ void updateEnemies(float deltaTime) {
         float leftmostX = FLT_MAX;
         float rightmostX = -FLT_MAX;
 
-        for (int j=0; j<TOTAL_ENEMIES; j++) {
+        for (int j=0; j<enemyCount; j++) {
             if(!enemies[j].isAlive ||  enemies[j].isAttacking) continue;
 
             if (enemies[j].formationPosition.x < leftmostX) {
@@ -749,14 +1086,16 @@ void updateEnemies(float deltaTime) {
         }
     }
 
-    for (int i = 0; i < TOTAL_ENEMIES; i++) {
+    // The whole formation sways together
+    float formationSway = sin(currentTime * currentLevelConfig.formationSwaySpeed) * currentLevelConfig.formationSwayAmount;
+
+    for (int i = 0; i < enemyCount; i++) {
         if (!enemies[i].isAlive) continue;
 
         // Update animation timer
         enemies[i].animationTimer += deltaTime * currentLevelConfig.enemySpeed;
 
         // Formation movement (side-to-side like Galaxian)
-        float formationSway = sin(currentTime * currentLevelConfig.formationSwaySpeed) * currentLevelConfig.formationSwayAmount;
         enemies[i].position.x = enemies[i].formationPosition.x + formationSway;
 
         // Start dual attack if enough time has passed and no enemies are attacking 
@@ -773,7 +1112,7 @@ void updateEnemies(float deltaTime) {
                 
                 // Set target position (toward player with some randomness)
                 enemies[i].attackTargetPos = glm::vec2(
-                    playerPosition.x + (rand() % 200 - 100) / 300.0f, // Some randomness
+                    playerPosition.x + (simulationRandom() % 200 - 100) / 300.0f, // Some randomness
                     playerPosition.y - 1.0f // Slightly below player
                 );
                 
@@ -813,13 +1152,13 @@ void updateEnemies(float deltaTime) {
 
         // Check collision with player
         if (gameState == GameState::PLAYING &&
-            checkCollision(enemies[i].position, ENEMY_RADIUS, 
+            checkCollision(enemies[i].position, ENEMY_RADIUS * formation.enemySize, 
                          glm::vec2(playerPosition.x, playerPosition.y), PLAYER_RADIUS)) {
 
             createExplosion(enemies[i].position);
 
             // PLAY HIT SOUND
-            if (audioManager) {
+            if (audioManager && !speculating) {
                 audioManager->playSound("hit", 1.0f, 1.0f);
             }
 
@@ -827,7 +1166,7 @@ void updateEnemies(float deltaTime) {
             enemies[i].isAlive = false; // Destroy the enemy that hit player
             playerLives--;
             
-            std::cout << "Player hit! Lives remaining: " << playerLives << std::endl;
+            gameLog() << "Player hit! Lives remaining: " << playerLives << std::endl;
         }
 
         // Add to alive positions for rendering
@@ -856,13 +1195,13 @@ void updateEnemies(float deltaTime) {
 
                 if (&enemies[i] == nearestEnemy) {
                     if (currentTime - lastNonAttackingShootTime > NEAREST_SHOOT_INTERVAL &&
-                    (rand() % 100) < 40) {
+                    (simulationRandom() % 100) < 40) {
                         createEnemyBullet(enemies[i]);
                         lastNonAttackingShootTime = currentTime;
                     }
                 } else {
                     if (currentTime - lastNonAttackingShootTime > NON_ATTACKING_SHOOT_INTERVAL &&
-                        (rand() % 100) < 10) {
+                        (simulationRandom() % 100) < 10) {
                             createEnemyBullet(enemies[i]);
                             lastNonAttackingShootTime = currentTime;
                     }
@@ -875,9 +1214,17 @@ void updateEnemies(float deltaTime) {
     // Win condition will be checked in main loop
 }
 
+// Remember where everything was before a tick moves it
+void saveInterpolationState() {
+    previousPlayerPosition = playerPosition;
+    for (Enemy& enemy : enemies) enemy.previousPosition = enemy.position;
+    for (Bullet& bullet : bullets) bullet.previousPosition = bullet.position;
+    for (EnemyBullet& bullet : enemyBullets) bullet.previousPosition = bullet.position;
+}
+
 // Initialize level
 void initializeLevel(int level) {
-    std::cout << "Initializing level " << currentLevel << std::endl;
+    gameLog() << "Initializing level " << currentLevel << std::endl;
 
     // Get level config
     if (level <= (int)levelConfigs.size()) {
@@ -902,15 +1249,19 @@ void initializeLevel(int level) {
     lastBulletTime = 0.0f;
 
     // CLear any bullet
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        bullets[i].isActive = false;
+    for (Bullet& bullet : bullets) {
+        bullet.isActive = false;
+    }
+
+    for (Explosion& explosion : explosions) {
+        explosion.isActive = false;
     }
 
-    for (int i=0; i<MAX_EXPLOSIONS; i++) {
-        explosions[i].isActive = false;
+    if (particleSystem) {
+        requestParticleClear();
     }
 
-    std::cout << "Level " << level << " - Speed: " << currentLevelConfig.enemySpeed 
+    gameLog() << "Level " << level << " - Speed: " << currentLevelConfig.enemySpeed 
               << ", Attack Interval: " << currentLevelConfig.attackInterval << std::endl;
     
 }
@@ -922,7 +1273,7 @@ void completeLevel() {
     gameState = GameState::LEVEL_COMPLETE;
     int levelBonus = 1000 * currentLevel;
     playerScore += levelBonus;
-    std::cout << "Level " << currentLevel << " completed! Bonus: " << levelBonus << std::endl;
+    gameLog() << "Level " << currentLevel << " completed! Bonus: " << levelBonus << std::endl;
 
 }
 
@@ -933,7 +1284,7 @@ void advanceToNextLevel() {
     // Check if this is the last level
     if (maxLevel > 0 && currentLevel > maxLevel) {
         gameState = GameState::GAME_WON;
-        std::cout << "You Won! Final Score: " << playerScore << std::endl;
+        gameLog() << "You Won! Final Score: " << playerScore << std::endl;
     } else {
         initializeLevel(currentLevel);
         gameState = GameState::PLAYING;
@@ -947,11 +1298,12 @@ void resetGame() {
     levelComplete = false;
     levelTransitionTimer = 0.0f;
     playerPosition = glm::vec3(0.0f, -2.0f, 0.0f);
+    previousPlayerPosition = playerPosition;
     
     initializeLevel(currentLevel);
     gameState = GameState::PLAYING;
     
-    std::cout << "Game reset to Level 1" << std::endl;
+    gameLog() << "Game reset to Level 1" << std::endl;
 }
 
 void renderQuad() {
@@ -981,7 +1333,222 @@ void renderQuad() {
     glBindVertexArray(0);
 }
 
-int main(int argc, char *argv[])
+// ===== STARFIELD =====
+const int STARFIELD_TEXTURE_SIZE = 1024;
+
+// Render the procedural star layers once into a tileable RGBA texture, so the per-frame
+// background is two texture fetches instead of hashing both star grids for every pixel
+unsigned int bakeStarfieldTexture(Shader& bakeShader, unsigned int vao, int size) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    // Nearest filtering: the g and a channels hold twinkle seeds, which must not blend
+    // with a neighbouring cell's. The texture is close to screen resolution, so the
+    // star shapes still match background.fs to within a few percent.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    unsigned int fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Starfield bake framebuffer not complete, using procedural starfield" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+
+    glViewport(0, 0, size, size);
+    glDisable(GL_BLEND);
+    bakeShader.use();
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glEnable(GL_BLEND);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+    glViewport(0, 0, currentWindowWidth, currentWindowHeight);
+    glDeleteFramebuffers(1, &fbo);
+
+    std::cout << "Baked starfield texture " << size << "x" << size << std::endl;
+    return texture;
+}
+
+// Draw the full-screen starfield; starTexture is 0 for the procedural shader
+void renderStarfield(Shader& shader, unsigned int vao, unsigned int starTexture, float time) {
+    shader.use();
+    shader.setFloat("time", time);
+    shader.setFloat("alpha", 1.0f); // Full alpha for starfield visibility
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, starTexture);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+}
+
+// Time the procedural and baked starfield shaders in isolation (meant for headless
+// runs on the software rasterizer, where fragment cost dominates)
+void benchmarkStarfield(Shader& proceduralShader, Shader& bakedShader, unsigned int vao,
+                        unsigned int starTexture, unsigned int fbo, int frames) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glDisable(GL_DEPTH_TEST);
+
+    double msPerFrame[2];
+    for (int variant = 0; variant < 2; variant++) {
+        Shader& shader = variant == 0 ? proceduralShader : bakedShader;
+        unsigned int texture = variant == 0 ? 0 : starTexture;
+
+        // warm up so shader compilation and texture residency are not measured
+        for (int i = 0; i < 5; i++) renderStarfield(shader, vao, texture, i / 60.0f);
+        glFinish();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) renderStarfield(shader, vao, texture, i / 60.0f);
+        glFinish();
+        msPerFrame[variant] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+    }
+
+    std::cout << "Starfield benchmark on " << glGetString(GL_RENDERER) << " (" << SCREEN_WIDTH << "x" << SCREEN_HEIGHT
+              << ", " << frames << " frames): procedural " << msPerFrame[0] << " ms/frame, baked "
+              << msPerFrame[1] << " ms/frame (" << msPerFrame[0] / msPerFrame[1] << "x)" << std::endl;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+}
+
+// Draw the menu, HUD and level complete text with each font and report the
+// vertices and GPU time per frame (headless only)
+void benchmarkText(unsigned int fbo, int frames) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glDisable(GL_DEPTH_TEST);
+
+    auto queueFrame = [](int i) {
+        for (const auto& button : menuButtons) {
+            textRenderer.add(button.text.c_str(), button.pixelX, button.pixelY, button.scale, button.color);
+        }
+        textRenderer.add(hudLabels[0], frameArena.format("LEVEL: %d", 1 + i / 60), 20.0f, 20.0f, 1.5f, glm::vec3(1.0f));
+        textRenderer.add(hudLabels[1], frameArena.format("SCORE: %d", i * 10), 20.0f, 50.0f, 1.5f, glm::vec3(1.0f));
+        textRenderer.add(hudLabels[2], frameArena.format("LIVES: %d", 3), 20.0f, 80.0f, 1.5f, glm::vec3(1.0f));
+        textRenderer.add(levelCompleteLabels[0], frameArena.format("LEVEL %d COMPLETE!", 1 + i / 60),
+                         SCREEN_WIDTH/2.0f - 150.0f, SCREEN_HEIGHT/2.0f - 50.0f, 3.0f, glm::vec3(1.0f));
+        textRenderer.add(levelCompleteLabels[1], frameArena.format("SCORE: %d", i * 10), SCREEN_WIDTH/2.0f - 100.0f,
+                         SCREEN_HEIGHT/2.0f, 2.5f, glm::vec3(1.0f, 1.0f, 0.5f));
+        textRenderer.add(levelCompleteLabels[2], frameArena.format("ADVANCING TO LEVEL %d", 2 + i / 60),
+                         SCREEN_WIDTH/2.0f - 150.0f, SCREEN_HEIGHT/2.0f + 50.0f, 2.5f, glm::vec3(1.0f));
+        textRenderer.flush(SCREEN_WIDTH, SCREEN_HEIGHT);
+        frameArena.reset();
+    };
+
+    unsigned int query;
+    glGenQueries(1, &query);
+    TextRenderer::Font fonts[2] = {TextRenderer::BITMAP, TextRenderer::SDF};
+    for (TextRenderer::Font font : fonts) {
+        textRenderer.setFont(font);
+        if (textRenderer.font() != font) {
+            std::cout << "Text benchmark: SDF font not built in, skipped" << std::endl;
+            continue;
+        }
+        // warm up so layouts and shader compilation are not measured
+        for (int i = 0; i < 5; i++) queueFrame(i);
+        glFinish();
+        textRenderer.takeStats();
+
+        uint64_t gpuNs = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            queueFrame(i);
+            glEndQuery(GL_TIME_ELAPSED);
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            gpuNs += elapsed;
+        }
+        glFinish();
+        double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+        TextRenderer::Stats stats = textRenderer.takeStats();
+        std::cout << "Text benchmark (" << (font == TextRenderer::SDF ? "sdf" : "bitmap") << ", " << frames
+                  << " frames): " << static_cast<double>(stats.vertices) / stats.frames << " vertices, "
+                  << gpuNs / 1e6 / frames << " ms GPU, " << cpuMs << " ms wall per frame" << std::endl;
+    }
+    glDeleteQueries(1, &query);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+}
+
+// ===== PARTICLES =====
+// Time update + draw of `count` long-lived particles on each backend (headless only)
+void benchmarkParticles(Shader& updateShader, Shader& renderShader, int count, unsigned int fbo,
+                        const glm::mat4& view, const glm::mat4& projection) {
+    const int frames = 120;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+    for (int gpu = 1; gpu >= 0; gpu--) {
+        ParticleSystem system(count);
+        system.initialize(&updateShader, &renderShader, gpu == 1);
+
+        // spread over the whole screen so fill cost resembles a busy frame
+        ParticleEmitter emitter;
+        emitter.speedMin = 0.5f;
+        emitter.speedMax = 5.0f;
+        emitter.lifeMin = emitter.lifeMax = 1000.0f;
+        emitter.drag = 0.5f;
+        emitter.count = count;
+        system.emit(emitter);
+        system.update(0.0f);
+        glFinish();
+
+        double updateMs = 0.0, renderMs = 0.0;
+        for (int i = 0; i < frames; i++) {
+            auto start = std::chrono::steady_clock::now();
+            system.update(1.0f / 60.0f);
+            glFinish();
+            auto updated = std::chrono::steady_clock::now();
+            system.render(view, projection, SCREEN_HEIGHT / (2.0f * WORLD_HALF_HEIGHT));
+            glFinish();
+            auto rendered = std::chrono::steady_clock::now();
+            updateMs += std::chrono::duration<double, std::milli>(updated - start).count();
+            renderMs += std::chrono::duration<double, std::milli>(rendered - updated).count();
+        }
+
+        std::cout << "Particle benchmark (" << count << " particles, "
+                  << (system.getBackend() == ParticleSystem::GPU_TRANSFORM_FEEDBACK ? "GPU" : "CPU SIMD")
+                  << " on " << glGetString(GL_RENDERER) << "): update " << updateMs / frames
+                  << " ms/frame, render " << renderMs / frames << " ms/frame" << std::endl;
+    }
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+}
+
+// Build a shader program from the sources compiled into the executable, falling back
+// to resources/shaders on disk for builds without EMBED_SHADERS
+Shader loadShaderProgram(const std::string& shaderDir, const char* vertexName, const char* fragmentName,
+                         const std::vector<const char*>& feedbackVaryings = {}) {
+#ifdef INVADERS_EMBEDDED_SHADERS
+    const char* vertexCode = findEmbeddedShader(vertexName);
+    const char* fragmentCode = findEmbeddedShader(fragmentName);
+    if (vertexCode && fragmentCode) {
+        return Shader(ShaderSource{vertexCode, fragmentCode, feedbackVaryings});
+    }
+    std::cout << "Shader " << vertexName << "/" << fragmentName << " not embedded, reading from disk" << std::endl;
+#endif
+    return Shader((shaderDir + vertexName).c_str(), (shaderDir + fragmentName).c_str(), feedbackVaryings);
+}
+
+// Create the game window and load all OpenGL function pointers (nullptr on failure)
+GLFWwindow* createGameWindow()
 {
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -997,11 +1564,12 @@ int main(int argc, char *argv[])
     {
       std::cout << "Failed to create GLFW window" << std::endl;
       glfwTerminate();
-      return -1;
+      return nullptr;
     }
 
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetKeyCallback(window, keyCallback);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     // glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -1010,8 +1578,255 @@ int main(int argc, char *argv[])
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
         std::cout << "Failed to initialize GLAD" << std::endl;
+        return nullptr;
+    }
+
+    return window;
+}
+
+// Scripted input for headless runs: sweep the player across the screen, fire on
+// cooldown and restart after game over so the workload never stalls on a menu
+bool headlessAutopilot() {
+    float currentTime = simulationTime;
+
+    if (gameState == GameState::GAME_OVER || gameState == GameState::GAME_WON) {
+        resetGame();
+        return false;
+    }
+    if (gameState != GameState::PLAYING) return false;
+
+    float targetX = sin(currentTime * 0.7f) * (WORLD_HALF_WIDTH - 0.5f);
+    float step = glm::clamp(targetX - playerPosition.x, -playerSpeed * deltaTime, playerSpeed * deltaTime);
+    playerPosition.x += step;
+
+    if (currentTime - lastBulletTime >= BULLET_COOLDOWN) {
+        createBullet();
+        lastBulletTime = currentTime;
+    }
+    return step != 0.0f;
+}
+
+// Everything a tick does after its input
+void updateGame() {
+    // Only update game objects if game is active
+    if (gameState == GameState::PLAYING) {
+        updateEnemies(deltaTime);
+        updateBullets(deltaTime);
+        updateEnemyBullets(deltaTime);
+        updateExplosions(deltaTime);
+
+        // Check win/lose conditions
+        if (playerLives <= 0) {
+            gameState = GameState::GAME_OVER;
+            gameLog() << "Game Over! Final Score: " << playerScore << std::endl;
+        } else if (aliveEnemyPositions.empty() && !levelComplete) {
+            completeLevel();
+        }
+    }
+
+    // Handle level transition state
+    if (gameState == GameState::LEVEL_COMPLETE) {
+        levelTransitionTimer += deltaTime;
+        if (levelTransitionTimer >= LEVEL_TRANSITION_DURATION) { // 2 seconds for transition
+            advanceToNextLevel();
+        }
+    }
+}
+
+// Run the ticks real time has covered up to until; returns how many ran
+int runSimulationTicks(GLFWwindow* window, double until) {
+    deltaTime = static_cast<float>(simulationStep);
+    if (until - simulationTime > MAX_TICKS_PER_FRAME * simulationStep) {
+        simulationTime = until - MAX_TICKS_PER_FRAME * simulationStep;
+    }
+    int ticks = 0;
+    while (simulationTime + simulationStep <= until) {
+        simulationTime += simulationStep;
+        ticks++;
+        saveInterpolationState();
+
+        if (window) {
+            processInputEvents(window, simulationTime);
+        } else {
+            autopilotMoving = headlessAutopilot();
+        }
+        updateGame();
+    }
+    return ticks;
+}
+
+void captureSnapshot(FrameSnapshot& snapshot) {
+    snapshot.time = simulationTime;
+    snapshot.state = gameState;
+    snapshot.score = playerScore;
+    snapshot.lives = playerLives;
+    snapshot.level = currentLevel;
+    snapshot.player = {glm::vec2(previousPlayerPosition), glm::vec2(playerPosition)};
+    snapshot.playerDirection = heldMoveDirection();
+    snapshot.playerMoving = headlessMode ? autopilotMoving : snapshot.playerDirection != 0;
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        snapshot.inputEventsApplied = latencyEventsRecorded;
+    }
+
+    // Room for every pool slot, so each buffer allocates the first time it is used and never again
+    snapshot.enemies.reserve(enemies.size());
+    snapshot.bullets.reserve(bullets.size());
+    snapshot.enemyBullets.reserve(enemyBullets.size());
+    snapshot.explosions.reserve(explosions.size());
+
+    snapshot.enemies.clear();
+    for (const Enemy& enemy : enemies) {
+        if (enemy.isAlive) snapshot.enemies.push_back({enemy.previousPosition, enemy.position});
+    }
+    snapshot.bullets.clear();
+    for (const Bullet& bullet : bullets) {
+        if (bullet.isActive) snapshot.bullets.push_back({bullet.previousPosition, bullet.position});
+    }
+    snapshot.enemyBullets.clear();
+    for (const EnemyBullet& bullet : enemyBullets) {
+        if (bullet.isActive) snapshot.enemyBullets.push_back({bullet.previousPosition, bullet.position});
+    }
+    snapshot.explosions.clear();
+    for (int i = 0; i < static_cast<int>(explosions.size()); i++) {
+        if (explosions[i].isActive) {
+            snapshot.explosions.push_back({explosions[i].position, explosions[i].timer, explosions[i].duration, i});
+        }
+    }
+}
+
+// Capture the world runAheadTicks ticks from now instead: the queued input is
+// applied at the first of them and the held keys carry it on. The events are
+// left queued for the real ticks, which won't count them for latency again.
+void captureRunAhead(GLFWwindow* window, FrameSnapshot& snapshot) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    saveSimulationState(runAheadState);
+    auto saved = Clock::now();
+
+    speculating = true;
+    size_t speculatedEvents = 0;
+    for (int i = 0; i < runAheadTicks; i++) {
+        simulationTime += simulationStep;
+        saveInterpolationState();
+        if (window) {
+            speculatedEvents = applyInputEvents(window, speculatedEvents, simulationTime);
+            applyHeldInput(simulationTime - deltaTime, simulationTime);
+        } else {
+            autopilotMoving = headlessAutopilot();
+        }
+        updateGame();
+    }
+    speculating = false;
+    latchedEventCount = std::max(latchedEventCount, speculatedEvents);
+    captureSnapshot(snapshot);
+    // stamped with the real time, so the renderer paces and interpolates as usual
+    snapshot.time = runAheadState.simulationTime;
+
+    auto restoreStart = Clock::now();
+    restoreSimulationState(runAheadState);
+    auto end = Clock::now();
+
+    double saveUs = std::chrono::duration<double, std::micro>(saved - start).count();
+    double restoreUs = std::chrono::duration<double, std::micro>(end - restoreStart).count();
+    std::lock_guard<std::mutex> lock(simulationStatsMutex);
+    simulationStats.runAheadFrames++;
+    simulationStats.runAheadMs += std::chrono::duration<double, std::milli>(end - start).count();
+    simulationStats.stateSaveUs += saveUs;
+    simulationStats.stateRestoreUs += restoreUs;
+    simulationStats.worstStateCopyUs = std::max(simulationStats.worstStateCopyUs, std::max(saveUs, restoreUs));
+}
+
+// Returns false if the previous snapshot was never drawn
+bool publishSnapshot(GLFWwindow* window) {
+    if (runAheadTicks > 0 && gameState == GameState::PLAYING) {
+        captureRunAhead(window, frameSnapshots.writeBuffer());
+    } else {
+        captureSnapshot(frameSnapshots.writeBuffer());
+    }
+    return frameSnapshots.publish();
+}
+
+void reportRunAhead(const SimulationStats& stats) {
+    if (stats.runAheadFrames == 0) return;
+    std::cout << "Run-ahead: " << runAheadTicks << " ticks in " << stats.runAheadFrames << " snapshots, avg "
+              << stats.runAheadMs / stats.runAheadFrames << " ms; state (" << simulationStateBytes(runAheadState)
+              << " bytes) save avg " << stats.stateSaveUs / stats.runAheadFrames << " us, restore avg "
+              << stats.stateRestoreUs / stats.runAheadFrames << " us, worst " << stats.worstStateCopyUs << " us"
+              << std::endl;
+}
+
+void simulationThreadMain(GLFWwindow* window) {
+    while (simulationRunning) {
+        if (simulationPaused) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(simulationStep));
+            simulationTime = getCurrentTime();
+            playerInputTime = simulationTime;
+            continue;
+        }
+
+        auto batchStart = std::chrono::steady_clock::now();
+        AllocationTracker::Counts allocationStart = AllocationTracker::thisThread();
+        int ticks = runSimulationTicks(window, getCurrentTime());
+        if (ticks > 0) {
+            bool drawn = publishSnapshot(window);
+            double busyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+            uint64_t allocations = (AllocationTracker::thisThread() - allocationStart).allocations;
+
+            std::lock_guard<std::mutex> lock(simulationStatsMutex);
+            simulationStats.allocations += allocations;
+            simulationStats.ticks += ticks;
+            simulationStats.snapshots++;
+            if (!drawn) simulationStats.droppedSnapshots++;
+            simulationStats.busyMs += busyMs;
+            simulationStats.worstBatchMs = std::max(simulationStats.worstBatchMs, busyMs);
+        }
+
+        // sleep until the next tick is due
+        double wait = simulationTime + simulationStep - getCurrentTime();
+        if (wait > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+}
+
+// space_shooter_bench links this file for the game logic and brings its own main
+#ifndef INVADERS_NO_MAIN
+int main(int argc, char *argv[])
+{
+#ifdef INVADERS_HEADLESS
+    HeadlessOptions headlessOptions;
+    if (!parseHeadlessArgs(argc, argv, headlessOptions)) {
         return -1;
     }
+    headlessMode = headlessOptions.enabled;
+    HeadlessContext headlessContext;
+#else
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--headless") {
+            std::cout << "This build has no headless support (configure with -D HEADLESS=ON)" << std::endl;
+            return -1;
+        }
+    }
+#endif
+
+    GLFWwindow *window = nullptr;
+#ifdef INVADERS_HEADLESS
+    if (headlessMode) {
+        // Offscreen context; gladLoadGLLoader runs inside create()
+        if (!headlessContext.create(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+            return -1;
+        }
+        screenFramebuffer = headlessContext.framebuffer();
+        gameState = GameState::PLAYING;
+    }
+#endif
+    if (!headlessMode) {
+        window = createGameWindow();
+        if (window == NULL) {
+            return -1;
+        }
+    }
 
     // OpenGL configuration
     // --------------------
@@ -1023,42 +1838,132 @@ int main(int argc, char *argv[])
     std::string parentDir = (fs::current_path().fs::path::parent_path()).string();
     std::cout << "Parent directory: " << parentDir << std::endl;
 
-    // Initialize audio manager
-    audioManager = new AudioManager(16);
-    if (!audioManager->initialize()) {
+    // Initialize audio manager (headless runs are silent)
+    audioManager = headlessMode ? nullptr : new AudioManager(16);
+    if (audioManager && !audioManager->initialize()) {
         std::cerr << "Failed to initialize audio manager!" << std::endl;
         // Continue without audio (don't exit)
         delete audioManager;
         audioManager = nullptr;
-    } else {
-        // Load sound effects
-        std::string audioDir = parentDir + "/resources/audio/FreeSFX/GameSFX/";
-        std::string backgroundDir = parentDir + "/resources/audio/";
-        audioManager->loadSound("hit", audioDir + "Explosion/Retro Explosion Short 01.wav");
-        audioManager->loadSound("laser", audioDir + "Weapon/laser/Retro Gun Laser SingleShot 01.wav");
-        audioManager->loadSound("explosion", audioDir + "Impact/Retro Impact LoFi 09.wav");
+    } else if (audioManager) {
+        // sounds are streamed in with the other assets below
+        std::cout << "Audio system initialized successfully" << std::endl;
+    }
 
-        // Load background music track (ensure file exists)
-        audioManager->loadSound(BACKGROUND_TRACK, parentDir + "/resources/audio/background1.wav");
-        // Start menu background music immediately and loop it
-        audioManager->playSound(BACKGROUND_TRACK, 0.5f, 1.0f, true);
-        std::cout << "Audio system loaded successfully" << std::endl;
+    // Load shaders (linked programs are cached in the working directory unless --no-shader-cache)
+    bool useShaderCache = true;
+    bool useBakedStarfield = true;
+    bool useGPUParticles = true;
+    bool useCompressedTextures = true;
+    bool useResourcePack = true;
+    bool useSdfFont = true;
+    unsigned int loaderThreads = AssetLoader::defaultWorkerCount();
+    ModelImportOptions modelOptions;
+    modelOptions.cacheDir = (fs::current_path() / "mesh_cache").string();
+    bool swarm = false;
+    bool customFormation = false;
+    bool formationSizeGiven = false;
+    int formationColumns = ENEMIES_PER_ROW, formationRows = ENEMY_ROWS;
+    float formationSpacingX = 0.0f, formationSpacingY = 0.0f;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--no-shader-cache") useShaderCache = false;
+        if (arg == "--procedural-starfield") useBakedStarfield = false;
+        if (arg == "--cpu-particles") useGPUParticles = false;
+        if (arg == "--no-mesh-optimize") modelOptions.optimize = false;
+        if (arg == "--assimp-mesh-optimize") modelOptions.assimpOptimize = true;
+        if (arg == "--no-mesh-cache") modelOptions.cacheDir.clear();
+        if (arg == "--no-compressed-textures") useCompressedTextures = false;
+        if (arg == "--no-resource-pack") useResourcePack = false;
+        if (arg == "--bitmap-font") useSdfFont = false;
+        if (arg == "--measure-latency") measureLatency = true;
+        if (arg == "--single-thread") simulationThreadEnabled = false;
+        if (arg == "--run-ahead" && i + 1 < argc) {
+            int ticks = std::atoi(argv[++i]);
+            if (ticks >= 0 && ticks <= MAX_RUN_AHEAD_TICKS) runAheadTicks = ticks;
+            else std::cerr << "Ignoring --run-ahead " << argv[i] << " (expected 0 to " << MAX_RUN_AHEAD_TICKS
+                           << " ticks)" << std::endl;
+        }
+        if (arg == "--tick-rate" && i + 1 < argc) {
+            double rate = std::atof(argv[++i]);
+            if (rate > 0.0) simulationStep = 1.0 / rate;
+            else std::cerr << "Ignoring --tick-rate " << argv[i] << " (expected ticks per second)" << std::endl;
+        }
+        if (arg == "--no-frame-limit") {
+            std::fill(std::begin(frameRateLimits), std::end(frameRateLimits), 0.0);
+            unfocusedFrameRate = 0.0;
+        }
+        if (arg == "--fps-limit" && i + 1 < argc && !parseFrameRateLimit(argv[++i])) {
+            std::cerr << "Ignoring --fps-limit " << argv[i] << " (expected STATE=FPS with STATE one of menu, playing, "
+                      << "level_complete, game_over, game_won, unfocused)" << std::endl;
+        }
+        if (arg == "--loader-threads" && i + 1 < argc) loaderThreads = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+        if (arg == "--swarm") swarm = true;
+        if (arg == "--formation" && i + 1 < argc) {
+            if (parseFormationSize(argv[++i], formationColumns, formationRows)) customFormation = formationSizeGiven = true;
+            else std::cerr << "Ignoring --formation " << argv[i] << " (expected COLSxROWS, at most "
+                           << MAX_FORMATION_ENEMIES << " enemies)" << std::endl;
+        }
+        if (arg == "--formation-spacing" && i + 1 < argc) {
+            if (parseFormationSpacing(argv[++i], formationSpacingX, formationSpacingY)) customFormation = true;
+            else std::cerr << "Ignoring --formation-spacing " << argv[i] << " (expected X or X,Y)" << std::endl;
+        }
+        if (arg == "--quality" && i + 1 < argc) {
+            std::string name = argv[++i];
+            bool known = false;
+            for (const QualityProfile& profile : QUALITY_PROFILES) {
+                if (name == profile.name) {
+                    quality = profile;
+                    known = true;
+                }
+            }
+            if (!known) std::cerr << "Unknown quality profile '" << name << "', using " << quality.name << std::endl;
+        }
     }
+    std::cout << "Quality profile: " << quality.name << std::endl;
+    if (swarm || customFormation) {
+        if (swarm && !formationSizeGiven) {
+            formationColumns = SWARM_COLUMNS;
+            formationRows = SWARM_ROWS;
+        }
+        configureFormation(formationColumns, formationRows, formationSpacingX, formationSpacingY);
+        std::cout << "Formation: " << formation.columns << "x" << formation.rows << " (" << formation.count()
+                  << " enemies, spacing " << formation.spacingX << "," << formation.spacingY << ")" << std::endl;
+    }
+    Shader::setBinaryCacheDir(useShaderCache ? (fs::current_path() / "shader_cache").string() : "");
 
-    // Load shaders
+    auto shaderSetupStart = std::chrono::steady_clock::now();
     std::string shaderDir = parentDir + "/resources/shaders/";
-    Shader playerShader((shaderDir + "playerModel.vs").c_str(), (shaderDir + "playerModel.fs").c_str());
-    Shader enemyShader((shaderDir + "enemy.vs").c_str(), (shaderDir + "enemy.fs").c_str());
-    Shader backgroundShader((shaderDir + "background.vs").c_str(), (shaderDir + "background.fs").c_str());
-    Shader parallaxShader((shaderDir + "parallax.vs").c_str(), (shaderDir + "parallax.fs").c_str());
-    Shader explosionShader((shaderDir + "explosion.vs").c_str(), (shaderDir + "explosion.fs").c_str());
-    Shader textShader((shaderDir + "text.vs").c_str(), (shaderDir + "text.fs").c_str());
-    Shader blurShader((shaderDir + "background.vs").c_str(), (shaderDir + "blur.fs").c_str());
-    Shader hdrShader((shaderDir + "background.vs").c_str(), (shaderDir + "hdr.fs").c_str());
-    textShaderPtr = &textShader;
-
-    // load player model
-    Model* player = new Model(parentDir + "/resources/Package/MeteorSlicer.obj");
+    Shader playerShader = loadShaderProgram(shaderDir, "playerModel.vs", "playerModel.fs");
+    Shader enemyShader = loadShaderProgram(shaderDir, "enemy.vs", "enemy.fs");
+    Shader backgroundShader = loadShaderProgram(shaderDir, "background.vs", "background.fs");
+    Shader parallaxShader = loadShaderProgram(shaderDir, "parallax.vs", "parallax.fs");
+    Shader explosionShader = loadShaderProgram(shaderDir, "explosion.vs", "explosion.fs");
+    Shader explosionFlipbookShader = loadShaderProgram(shaderDir, "explosion.vs", "explosion_flipbook.fs");
+    Shader particleUpdateShader = loadShaderProgram(shaderDir, "particle_update.vs", "particle_update.fs",
+                                                    ParticleSystem::feedbackVaryings());
+    Shader particleShader = loadShaderProgram(shaderDir, "particle.vs", "particle.fs");
+    Shader textShader = loadShaderProgram(shaderDir, "text.vs", "text.fs");
+    Shader textSdfShader = loadShaderProgram(shaderDir, "text_sdf.vs", "text_sdf.fs");
+    Shader blurShader = loadShaderProgram(shaderDir, "background.vs", "blur.fs");
+    Shader hdrShader = loadShaderProgram(shaderDir, "background.vs", "hdr.fs");
+    Shader starfieldBakeShader = loadShaderProgram(shaderDir, "background.vs", "starfield_bake.fs");
+    Shader bakedBackgroundShader = loadShaderProgram(shaderDir, "background.vs", "background_baked.fs");
+
+    const Shader* loadedShaders[] = {&playerShader, &enemyShader, &backgroundShader, &parallaxShader,
+                                     &explosionShader, &textShader, &blurShader, &hdrShader,
+                                     &starfieldBakeShader, &bakedBackgroundShader, &explosionFlipbookShader,
+                                     &particleUpdateShader, &particleShader, &textSdfShader};
+    int cachedShaders = 0;
+    for (const Shader* shader : loadedShaders) {
+        if (shader->loadedFromCache) cachedShaders++;
+    }
+    std::cout << "Shader setup took "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderSetupStart).count() << " ms ("
+              << cachedShaders << "/" << std::size(loadedShaders) << " from binary cache)" << std::endl;
+
+    // player model, streamed in by the asset loader below
+    Model* player = nullptr;
 
     // Generate enemy formation positions (Galaxian style)
     initializeEnemies();
@@ -1069,16 +1974,11 @@ int main(int argc, char *argv[])
     // Initialize level system
     initializeLevel(currentLevel);
     
-    // Setup text rendering VAO
-    glGenVertexArrays(1, &textVAO);
-    glGenBuffers(1, &textVBO);
-    
-    glBindVertexArray(textVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    glBufferData(GL_ARRAY_BUFFER, MAX_TEXT_TRIANGLES * 3 * 2 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glBindVertexArray(0);
+    // Setup text rendering
+    textRenderer.initialize(&textShader, &textSdfShader);
+    if (!useSdfFont) textRenderer.setFont(TextRenderer::BITMAP);
+    std::cout << "Text font: " << (textRenderer.font() == TextRenderer::SDF ? "signed distance field" : "bitmap")
+              << std::endl;
 
     // Setup background VAO
     unsigned int backgroundVAO, backgroundVBO;
@@ -1094,6 +1994,18 @@ int main(int argc, char *argv[])
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glBindVertexArray(0);
 
+    // Bake the starfield layers (the benchmark needs the texture even with --procedural-starfield)
+    bool benchmarkingStarfield = false;
+#ifdef INVADERS_HEADLESS
+    benchmarkingStarfield = headlessMode && headlessOptions.starfieldBenchFrames > 0;
+#endif
+    unsigned int starfieldTexture = 0;
+    if (useBakedStarfield || benchmarkingStarfield) {
+        starfieldTexture = bakeStarfieldTexture(starfieldBakeShader, backgroundVAO, STARFIELD_TEXTURE_SIZE);
+    }
+    Shader& starfieldShader = (useBakedStarfield && starfieldTexture) ? bakedBackgroundShader : backgroundShader;
+    unsigned int activeStarfieldTexture = (useBakedStarfield && starfieldTexture) ? starfieldTexture : 0;
+
 
     // Load enemy with instanced rendering
     unsigned int enemyVAO, enemyVBO, instanceVBO;
@@ -1113,7 +2025,7 @@ int main(int argc, char *argv[])
 
     // Instance data
     glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * TOTAL_ENEMIES, nullptr, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * formation.count(), nullptr, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glVertexAttribDivisor(2, 1); // Tell OpenGL this is an instanced vertex attribute
@@ -1161,29 +2073,94 @@ int main(int argc, char *argv[])
     glBindVertexArray(0);
     
 
-    // Load parallax background layers (from back to front)
-    stbi_set_flip_vertically_on_load(true); // Keep images right-side up for backgrounds
+    // Parallax background layers (from back to front); textures arrive from the asset loader
     std::string layerDir = parentDir + "/resources/background/Super Mountain Dusk Files/Assets/version A/Layers/";
     
     parallaxLayers.clear();
-    parallaxLayers.push_back(ParallaxLayer(loadTexture(layerDir + "sky.png"), 0.0f, "sky"));              // Static sky
-    parallaxLayers.push_back(ParallaxLayer(loadTexture(layerDir + "far-clouds.png"), 0.1f, "far-clouds"));   // Very slow
-    parallaxLayers.push_back(ParallaxLayer(loadTexture(layerDir + "far-mountains.png"), 0.2f, "far-mountains")); // Slow
-    parallaxLayers.push_back(ParallaxLayer(loadTexture(layerDir + "near-clouds.png"), 0.3f, "near-clouds"));  // Medium slow
-    parallaxLayers.push_back(ParallaxLayer(loadTexture(layerDir + "mountains.png"), 0.5f, "mountains"));    // Medium
-    parallaxLayers.push_back(ParallaxLayer(loadTexture(layerDir + "trees.png"), 0.8f, "trees"));          // Fast
-    
-    std::cout << "Loaded " << parallaxLayers.size() << " parallax layers" << std::endl;
+    parallaxLayers.push_back(ParallaxLayer(0, 0.0f, "sky"));              // Static sky
+    parallaxLayers.push_back(ParallaxLayer(0, 0.1f, "far-clouds"));       // Very slow
+    parallaxLayers.push_back(ParallaxLayer(0, 0.2f, "far-mountains"));    // Slow
+    parallaxLayers.push_back(ParallaxLayer(0, 0.3f, "near-clouds"));      // Medium slow
+    parallaxLayers.push_back(ParallaxLayer(0, 0.5f, "mountains"));        // Medium
+    parallaxLayers.push_back(ParallaxLayer(0, 0.8f, "trees"));            // Fast
+
+    // Enemy, missile and enemy missile sprites
+    unsigned int enemyTexture = 0;
+    unsigned int missileTexture = 0;
+    unsigned int enemyMissileTexture = 0;
+
+    // Decode everything on worker threads; uploads are pumped from the main loop
+    // so the menu shows up immediately
+    auto assetStreamStart = std::chrono::steady_clock::now();
+    // resources.pack (tools/resource_pack.cpp) is mapped once; files missing from it are read from resources/
+    if (useResourcePack) {
+        ResourcePack::instance().mount(parentDir + "/resources.pack", parentDir + "/resources");
+    }
+    // Block-compressed .ktx2 siblings are only picked once the context reports support
+    if (useCompressedTextures) {
+        TextureCache::detectCompressedFormats();
+    }
+    AssetLoader assetLoader(loaderThreads);
+    TextureLoadOptions spriteOptions = spriteTextureOptions();
+    for (size_t i = 0; i < parallaxLayers.size(); i++) {
+        assetLoader.loadTexture(layerDir + parallaxLayers[i].name + ".png", spriteOptions,
+                                [i](unsigned int texture) { parallaxLayers[i].texture = texture; });
+    }
+    std::string spriteDir = parentDir + "/resources/spaceship-pack/";
+    assetLoader.loadTexture(spriteDir + "ship_4.png", spriteOptions, [&](unsigned int texture) { enemyTexture = texture; });
+    assetLoader.loadTexture(spriteDir + "missiles.png", spriteOptions, [&](unsigned int texture) { missileTexture = texture; });
+    assetLoader.loadTexture(spriteDir + "shot-2.png", spriteOptions, [&](unsigned int texture) { enemyMissileTexture = texture; });
+    assetLoader.loadModel(parentDir + "/resources/Package/MeteorSlicer.obj", false, modelOptions, [&](Model* model) {
+        player = model;
+        std::cout << "Player model took " << player->loadMilliseconds << " ms ("
+                  << (player->loadedFromCache ? "binary mesh cache" : "Assimp import") << ")" << std::endl;
+    });
+    if (audioManager) {
+        std::string audioDir = parentDir + "/resources/audio/FreeSFX/GameSFX/";
+        assetLoader.loadSound(*audioManager, "hit", audioDir + "Explosion/Retro Explosion Short 01.wav");
+        assetLoader.loadSound(*audioManager, "laser", audioDir + "Weapon/laser/Retro Gun Laser SingleShot 01.wav");
+        assetLoader.loadSound(*audioManager, "explosion", audioDir + "Impact/Retro Impact LoFi 09.wav");
+        // Menu background music starts looping as soon as it is decoded
+        assetLoader.loadSound(*audioManager, BACKGROUND_TRACK, parentDir + "/resources/audio/background1.wav", [] {
+            audioManager->playSound(BACKGROUND_TRACK, 0.5f, 1.0f, true);
+        });
+    }
+    // headless runs start straight in the game and must render the same frames every time
+    if (headlessMode) {
+        assetLoader.finish();
+    }
 
-    // Load enemy texture
-    stbi_set_flip_vertically_on_load(true);
-    unsigned int enemyTexture = loadTexture(parentDir + "/resources/spaceship-pack/ship_4.png");
-    
-    // Load missile texture
-    unsigned int missileTexture = loadTexture(parentDir + "/resources/spaceship-pack/missiles.png");
+    // Particle pool sized by the quality profile (CPU simulation without transform feedback)
+    particleSystem = new ParticleSystem(quality.maxParticles);
+    if (!particleSystem->initialize(&particleUpdateShader, &particleShader, useGPUParticles)) {
+        delete particleSystem;
+        particleSystem = nullptr;
+    }
 
-    // Load enemy missile texture
-    unsigned int enemyMissileTexture = loadTexture(parentDir + "/resources/spaceship-pack/shot-2.png");
+    // Explosion flipbook atlas for the lower quality profiles
+    unsigned int explosionAtlasTexture = 0;
+    int explosionAtlasCell = 0;
+    if (quality.flipbookExplosions) {
+        // Cells sit edge to edge, so no repeat and no mips bleeding neighbours in
+        TextureLoadOptions atlasOptions;
+        atlasOptions.mipmaps = false;
+        atlasOptions.wrapS = GL_CLAMP_TO_EDGE;
+        atlasOptions.wrapT = GL_CLAMP_TO_EDGE;
+        atlasOptions.minFilter = GL_LINEAR;
+        explosionAtlasTexture = TextureCache::instance().acquire(parentDir + "/resources/effects/explosion_atlas.png", atlasOptions);
+        int atlasWidth = 0, atlasHeight = 0;
+        glBindTexture(GL_TEXTURE_2D, explosionAtlasTexture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &atlasWidth);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &atlasHeight);
+        explosionAtlasCell = atlasHeight / EXPLOSION_FLIPBOOK_VARIATIONS;
+
+        if (explosionAtlasCell == 0 || atlasWidth != explosionAtlasCell * EXPLOSION_FLIPBOOK_FRAMES) {
+            std::cerr << "Explosion atlas missing or not " << EXPLOSION_FLIPBOOK_FRAMES << "x"
+                      << EXPLOSION_FLIPBOOK_VARIATIONS << " cells, using procedural explosions" << std::endl;
+            TextureCache::instance().release(explosionAtlasTexture);
+            explosionAtlasTexture = 0;
+        }
+    }
 
     // create hdr fbo
     unsigned int hdrFBO;
@@ -1256,38 +2233,243 @@ int main(int argc, char *argv[])
     blurShader.use();
     blurShader.setInt("image", 0);
 
+    bakedBackgroundShader.use();
+    bakedBackgroundShader.setInt("starTexture", 0);
+
+    explosionFlipbookShader.use();
+    explosionFlipbookShader.setInt("flipbook", 0);
+    explosionFlipbookShader.setVec2("cellScale", glm::vec2(1.0f / EXPLOSION_FLIPBOOK_FRAMES, 1.0f / EXPLOSION_FLIPBOOK_VARIATIONS));
+    explosionFlipbookShader.setFloat("cellInset", explosionAtlasCell > 0 ? 0.5f / explosionAtlasCell : 0.0f);
+
+
+    // Per-frame timings collected in headless mode
+    struct FrameTiming {
+        int frame;
+        double simulationMs;
+        double renderMs;
+        uint64_t allocations;
+        uint64_t allocatedBytes;
+    };
+    std::vector<FrameTiming> frameTimings;
+    int checkedFrames = 0;          // --check-allocations: PLAYING frames after the warm-up
+    int allocatingFrames = 0;
+    int playingFrames = 0;
+    int frameIndex = 0;
+    auto frameStart = std::chrono::steady_clock::now();
+    auto simulationEnd = frameStart;
+    size_t nextDumpFrame = 0;
+
+    // Finish the frame: present to the window, or when headless wait for the GPU,
+    // record timings, dump requested frames and advance the virtual clock
+    size_t frameInputEvents = 0;    // input events applied (ever) in the frame being drawn
+    AllocationTracker::Counts frameAllocationStart;
+    auto endFrame = [&]() {
+        GameState shownState = frameSnapshots.readBuffer().state;
+        if (window) {
+            glfwSwapBuffers(window);
+            if (measureLatency) {
+                recordInputLatency(frameInputEvents);
+            }
+            AllocationTracker::Counts allocated = AllocationTracker::thisThread() - frameAllocationStart;
+            reportAllocations += allocated.allocations;
+            reportAllocatedBytes += allocated.bytes;
+
+            // Cap the rate for the current state; idle screens and unfocused windows
+            // block on window events instead of spinning out the last milliseconds
+            bool focused = glfwGetWindowAttrib(window, GLFW_FOCUSED);
+            double limit = frameRateLimits[static_cast<int>(shownState)];
+            if (!focused && unfocusedFrameRate > 0.0 && (limit <= 0.0 || unfocusedFrameRate < limit)) {
+                limit = unfocusedFrameRate;
+            }
+            framePacer.setTargetRate(limit);
+            if (!focused || isIdleState(shownState)) {
+                // A key press or menu click renders its frame right away; mouse motion alone doesn't
+                size_t inputBefore = inputQueue.pushedCount();
+                framePacer.waitForNextFrame([inputBefore](double seconds) {
+                    glfwWaitEventsTimeout(seconds);
+                    return inputQueue.pushedCount() != inputBefore;
+                });
+            } else {
+                framePacer.waitForNextFrame();
+            }
+            glfwPollEvents();
 
-    while (!glfwWindowShouldClose(window))
+            FramePacer::Report report;
+            if (framePacer.takeReport(report)) {
+                std::cout << "Frame pacing: " << report.frames << " frames in " << report.seconds << " s ("
+                          << report.frames / report.seconds << " fps, " << GAME_STATE_NAMES[static_cast<int>(shownState)]
+                          << (focused ? "" : ", unfocused") << "), CPU " << report.cpuSeconds << " s ("
+                          << 100.0 * report.cpuSeconds / report.seconds << "% of a core), waiting "
+                          << report.waitedSeconds << " s, " << static_cast<double>(reportAllocations) / report.frames
+                          << " heap allocations (" << reportAllocatedBytes / report.frames << " bytes) per frame"
+                          << std::endl;
+                reportAllocations = 0;
+                reportAllocatedBytes = 0;
+                SimulationStats stats;
+                {
+                    std::lock_guard<std::mutex> lock(simulationStatsMutex);
+                    std::swap(stats, simulationStats);
+                }
+                reportRunAhead(stats);
+                if (simulationRunning) {
+                    std::cout << "Simulation thread: " << stats.ticks << " ticks in " << stats.snapshots << " snapshots ("
+                              << stats.droppedSnapshots << " never drawn), busy " << stats.busyMs << " ms, worst batch "
+                              << stats.worstBatchMs << " ms, " << stats.allocations << " heap allocations; render thread: " << staleFrames << " frames without a new "
+                              << "snapshot, " << snapshotWaitMs << " ms waiting for one" << std::endl;
+                    staleFrames = 0;
+                    snapshotWaitMs = 0.0;
+                }
+            }
+            return;
+        }
+#ifdef INVADERS_HEADLESS
+        glFinish();
+        auto renderEnd = std::chrono::steady_clock::now();
+        AllocationTracker::Counts allocated = AllocationTracker::thisThread() - frameAllocationStart;
+        frameTimings.push_back({frameIndex,
+                                std::chrono::duration<double, std::milli>(simulationEnd - frameStart).count(),
+                                std::chrono::duration<double, std::milli>(renderEnd - simulationEnd).count(),
+                                allocated.allocations, allocated.bytes});
+
+        if (headlessOptions.checkAllocations && shownState == GameState::PLAYING &&
+            ++playingFrames > headlessOptions.allocationWarmupFrames) {
+            checkedFrames++;
+            if (allocated.allocations > 0 && ++allocatingFrames <= 10) {
+                std::cerr << "ERROR::ALLOCATIONS::Frame " << frameIndex << " made " << allocated.allocations
+                          << " heap allocations (" << allocated.bytes << " bytes)" << std::endl;
+            }
+        }
+
+        while (nextDumpFrame < headlessOptions.dumpFrames.size() &&
+               headlessOptions.dumpFrames[nextDumpFrame] <= frameIndex) {
+            if (headlessOptions.dumpFrames[nextDumpFrame] == frameIndex) {
+                std::vector<unsigned char> pixels;
+                headlessContext.readPixels(pixels);
+                char name[32];
+                snprintf(name, sizeof(name), "/frame_%05d.png", frameIndex);
+                writePNG(headlessOptions.outputDir + name, headlessContext.getWidth(), headlessContext.getHeight(), pixels.data());
+            }
+            nextDumpFrame++;
+        }
+        headlessClock += headlessOptions.timestep;
+#endif
+        frameIndex++;
+    };
+
+    int headlessFrames = 0;
+#ifdef INVADERS_HEADLESS
+    if (benchmarkingStarfield) {
+        benchmarkStarfield(backgroundShader, bakedBackgroundShader, backgroundVAO, starfieldTexture,
+                           hdrFBO, headlessOptions.starfieldBenchFrames);
+    } else if (headlessMode && headlessOptions.textBenchFrames > 0) {
+        benchmarkText(hdrFBO, headlessOptions.textBenchFrames);
+    } else if (headlessMode && headlessOptions.particleBenchCount > 0) {
+        glm::mat4 benchView = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+        glm::mat4 benchProjection = glm::ortho(-WORLD_HALF_WIDTH, WORLD_HALF_WIDTH, -WORLD_HALF_HEIGHT, WORLD_HALF_HEIGHT,
+                                               0.1f, 100.0f);
+        benchmarkParticles(particleUpdateShader, particleShader, headlessOptions.particleBenchCount, hdrFBO,
+                           benchView, benchProjection);
+    } else if (headlessMode) {
+        headlessFrames = headlessOptions.frames;
+        fs::create_directories(headlessOptions.outputDir);
+        frameTimings.reserve(headlessOptions.frames);
+    }
+#endif
+
+    simulationTime = getCurrentTime();
+    // The pools never outgrow these, so the vectors rebuilt every tick and frame never reallocate
+    aliveEnemyPositions.reserve(formation.count());
+    enemyRenderPositions.reserve(formation.count());
+    particleRequests.reserve(MAX_PARTICLE_REQUESTS);
+    publishSnapshot(window);
+    std::thread simulationThread;
+    if (window && simulationThreadEnabled) {
+        simulationRunning = true;
+        simulationThread = std::thread(simulationThreadMain, window);
+    }
+
+    while (window ? !glfwWindowShouldClose(window) : frameIndex < headlessFrames)
     {
+        // Nothing to show while minimized: sleep on window events and keep the
+        // game clock from running on
+        if (window && glfwGetWindowAttrib(window, GLFW_ICONIFIED)) {
+            simulationPaused = true;
+            glfwWaitEventsTimeout(ICONIFIED_WAIT_SECONDS);
+            lastFrame = static_cast<float>(getCurrentTime());
+            if (!simulationRunning) {
+                playerInputTime = lastFrame;
+                simulationTime = getCurrentTime();
+            }
+            continue;
+        }
+        simulationPaused = false;
+        frameStart = std::chrono::steady_clock::now();
+        frameAllocationStart = AllocationTracker::thisThread();
+        frameArena.reset();
+        framePacer.beginFrame();
 
         // calculate delta time
         // --------------------
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
+        double frameTime = getCurrentTime();
+        float currentFrame = static_cast<float>(frameTime);
+        float frameDeltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // Upload whatever the loader threads finished, within this frame's budget
+        if (!assetsLoaded) {
+            assetLoader.pumpUploads(ASSET_UPLOAD_BUDGET_MS);
+            if (assetLoader.isFinished()) {
+                assetsLoaded = true;
+                std::cout << "Streamed " << assetLoader.totalCount() << " assets in "
+                          << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - assetStreamStart).count()
+                          << " ms (" << assetLoader.workerCount() << " loader threads)" << std::endl;
+                TextureCache::instance().logUsage();
+            }
+        }
+
+        // fixed-step simulation
+        // ---------------------
+        if (!simulationRunning) {
+            runSimulationTicks(window, frameTime);
+            publishSnapshot(window);
+        }
+        simulationEnd = std::chrono::steady_clock::now();
+
+        // Take the newest snapshot. The simulation thread only has a new one once per
+        // tick; a frame that has already shown the last tick in full waits for the next
+        bool freshSnapshot = frameSnapshots.acquire();
+        if (!freshSnapshot && simulationRunning && getCurrentTime() - frameSnapshots.readBuffer().time >= simulationStep) {
+            auto waitStart = std::chrono::steady_clock::now();
+            freshSnapshot = frameSnapshots.waitForPublish(std::chrono::duration<double>(simulationStep)) &&
+                            frameSnapshots.acquire();
+            snapshotWaitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+        }
+        if (!freshSnapshot) {
+            staleFrames++;
+        }
+        const FrameSnapshot& frame = frameSnapshots.readBuffer();
+        double renderTime = simulationRunning ? getCurrentTime() : frameTime;
+        // where the frame lies between the snapshot's last two ticks
+        float interpolation = glm::clamp(static_cast<float>((renderTime - frame.time) / simulationStep), 0.0f, 1.0f);
+
         // Handle background music volume on state change
-        if (gameState != prevGameState) {
+        if (frame.state != prevGameState) {
             if (audioManager) {
                 float volume = 0.4f; // default
-                if (gameState == GameState::PLAYING) volume = 0.25f;
-                else if (gameState == GameState::MENU) volume = 0.5f;
-                else if (gameState == GameState::GAME_OVER || gameState == GameState::GAME_WON) volume = 0.35f;
+                if (frame.state == GameState::PLAYING) volume = 0.25f;
+                else if (frame.state == GameState::MENU) volume = 0.5f;
+                else if (frame.state == GameState::GAME_OVER || frame.state == GameState::GAME_WON) volume = 0.35f;
 
                 // Just adjust volume; track is already looping
                 audioManager->setSoundVolume(BACKGROUND_TRACK, volume);
             }
-            prevGameState = gameState;
+            prevGameState = frame.state;
         }
 
-        // process input
-        // -------------
-        processInput(window);
-
         // Update parallax layers only when they're being rendered (menu and game over states)
-        if (gameState == GameState::MENU || gameState == GameState::GAME_OVER || gameState == GameState::GAME_WON) {
+        if (frame.state == GameState::MENU || frame.state == GameState::GAME_OVER || frame.state == GameState::GAME_WON) {
             for (auto& layer : parallaxLayers) {
-                layer.offsetX += layer.scrollSpeed * deltaTime * 0.1f; // Slow down the effect
+                layer.offsetX += layer.scrollSpeed * frameDeltaTime * 0.1f; // Slow down the effect
                 // Wrap around when offset gets too large
                 if (layer.offsetX > 1.0f) {
                     layer.offsetX -= 1.0f;
@@ -1295,32 +2477,54 @@ int main(int argc, char *argv[])
             }
         }
 
-        // Only update game objects if game is active
-        if (gameState == GameState::PLAYING) {
-            updateEnemies(deltaTime);
-            updateBullets(deltaTime);
-            updateEnemyBullets(deltaTime);
-            updateExplosions(deltaTime);
-            
-            // Check win/lose conditions
-            if (playerLives <= 0) {
-                gameState = GameState::GAME_OVER;
-                std::cout << "Game Over! Final Score: " << playerScore << std::endl;
-            } else if (aliveEnemyPositions.empty() && !levelComplete) {
-                completeLevel();
+        // The ship is drawn where input has put it by now, everything else one tick
+        // behind. Single-threaded the queued input is latched right here; the render
+        // thread extrapolates from the keys held at the last tick. A run-ahead
+        // snapshot is already ahead of the input and is interpolated like the rest.
+        glm::vec3 playerRenderPosition(frame.player.current, 0.0f);
+        frameInputEvents = frame.inputEventsApplied;
+        if (window && frame.state == GameState::PLAYING && runAheadTicks == 0) {
+            if (!simulationRunning) {
+                latchPlayerInput();
+                playerRenderPosition = playerPosition;
+                std::lock_guard<std::mutex> lock(latencyMutex);
+                frameInputEvents = latencyEventsRecorded;
+            } else {
+                float ahead = static_cast<float>(glm::clamp(renderTime - frame.time, 0.0, simulationStep));
+                playerRenderPosition.x = glm::clamp(playerRenderPosition.x + playerSpeed * frame.playerDirection * ahead,
+                                                    -WORLD_HALF_WIDTH, WORLD_HALF_WIDTH);
             }
+        } else if (!window || runAheadTicks > 0) {
+            playerRenderPosition = glm::vec3(glm::mix(frame.player.previous, frame.player.current, interpolation), 0.0f);
         }
 
-        // Handle level transition state
-        if (gameState == GameState::LEVEL_COMPLETE) {
-            levelTransitionTimer += deltaTime;
-            if (levelTransitionTimer >= LEVEL_TRANSITION_DURATION) { // 2 seconds for transition
-                advanceToNextLevel();
+        // Particles are purely visual and advance once per rendered frame
+        if (particleSystem) {
+            {
+                std::lock_guard<std::mutex> lock(particleRequestMutex);
+                if (particleClearRequested) {
+                    particleSystem->clear();
+                    particleClearRequested = false;
+                }
+                for (const ParticleEmitter& emitter : particleRequests) {
+                    particleSystem->emit(emitter);
+                }
+                particleRequests.clear();
+            }
+            if (frame.state == GameState::PLAYING) {
+                // Engine trail behind the ship, emitted at a fixed rate independent of frame rate
+                engineTrailAccumulator += frameDeltaTime * ENGINE_TRAIL_RATE;
+                ParticleEmitter trail = ParticleEmitter::engineTrail(glm::vec2(playerRenderPosition.x, playerRenderPosition.y - 0.12f));
+                trail.count = static_cast<int>(engineTrailAccumulator);
+                engineTrailAccumulator -= trail.count;
+                particleSystem->emit(trail);
+                particleSystem->update(frameDeltaTime);
             }
         }
 
         // render
         // ------
+        glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
@@ -1339,7 +2543,7 @@ int main(int argc, char *argv[])
 
 
         // ===== MENU STATE =====
-        if (gameState == GameState::MENU) {
+        if (frame.state == GameState::MENU) {
             // Render parallax background layers for menu
             glDisable(GL_DEPTH_TEST);
             glEnable(GL_BLEND);
@@ -1348,6 +2552,7 @@ int main(int argc, char *argv[])
             parallaxShader.use();
             
             for (const auto& layer : parallaxLayers) {
+                if (layer.texture == 0) continue;   // still loading
                 parallaxShader.setFloat("offsetX", layer.offsetX);
                 parallaxShader.setFloat("alpha", 1.0f);
                 
@@ -1359,18 +2564,25 @@ int main(int argc, char *argv[])
             
             glBindVertexArray(0);
             
-            // Render menu buttons with proper centering
+            // Render menu buttons with proper centering; the start button shows progress until the assets are in
             for (const auto& button : menuButtons) {
-                renderText(button.text.c_str(), button.pixelX, button.pixelY, button.scale, button.color);
+                if (!assetsLoaded && button.text == "CLICK TO START") {
+                    const char* progress = frameArena.format("LOADING %d/%d", assetLoader.completedCount(),
+                                                             assetLoader.totalCount());
+                    textRenderer.add(loadingLabel, progress, button.pixelX, button.pixelY, button.scale,
+                                     glm::vec3(0.6f, 0.6f, 0.6f));
+                    continue;
+                }
+                textRenderer.add(button.text.c_str(), button.pixelX, button.pixelY, button.scale, button.color);
             }
+            textRenderer.flush(currentWindowWidth, currentWindowHeight);
             
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+            endFrame();
             continue;
         }
 
         // ===== GAME OVER / WIN STATES =====
-        if (gameState == GameState::GAME_OVER || gameState == GameState::GAME_WON) {
+        if (frame.state == GameState::GAME_OVER || frame.state == GameState::GAME_WON) {
             // Render parallax background layers for game over/win screens
             glDisable(GL_DEPTH_TEST);
             glEnable(GL_BLEND);
@@ -1379,6 +2591,7 @@ int main(int argc, char *argv[])
             parallaxShader.use();
             
             for (const auto& layer : parallaxLayers) {
+                if (layer.texture == 0) continue;   // still loading
                 parallaxShader.setFloat("offsetX", layer.offsetX);
                 parallaxShader.setFloat("alpha", 1.0f);
                 
@@ -1391,50 +2604,42 @@ int main(int argc, char *argv[])
             glBindVertexArray(0);
             
             // Render text on top of background
-            std::string message = (gameState == GameState::GAME_OVER) ? "GAME OVER" : "YOU WON!";
-            std::string scoreText = "SCORE: " + std::to_string(playerScore);
-            std::string restartText = "PRESS R TO RESTART";
+            const char* message = (frame.state == GameState::GAME_OVER) ? "GAME OVER" : "YOU WON!";
+            const char* scoreText = frameArena.format("SCORE: %d", frame.score);
+            const char* restartText = "PRESS R TO RESTART";
             
-            renderText(message.c_str(), currentWindowWidth/2.0f - 80.0f, currentWindowHeight/2.0f - 50.0f, 3.0f, 
-                      glm::vec3(1.0f, 0.0f, 0.0f));
-            renderText(scoreText.c_str(), currentWindowWidth/2.0f - 60.0f, currentWindowHeight/2.0f, 2.0f, 
-                      glm::vec3(1.0f, 1.0f, 0.0f));
-            renderText(restartText.c_str(), currentWindowWidth/2.0f - 100.0f, currentWindowHeight/2.0f + 50.0f, 1.5f, 
-                      glm::vec3(0.8f, 0.8f, 1.0f));
+            textRenderer.add(message, currentWindowWidth/2.0f - 80.0f, currentWindowHeight/2.0f - 50.0f, 3.0f, 
+                             glm::vec3(1.0f, 0.0f, 0.0f));
+            textRenderer.add(finalScoreLabel, scoreText, currentWindowWidth/2.0f - 60.0f, currentWindowHeight/2.0f, 2.0f, 
+                             glm::vec3(1.0f, 1.0f, 0.0f));
+            textRenderer.add(restartText, currentWindowWidth/2.0f - 100.0f, currentWindowHeight/2.0f + 50.0f, 1.5f, 
+                             glm::vec3(0.8f, 0.8f, 1.0f));
+            textRenderer.flush(currentWindowWidth, currentWindowHeight);
             
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+            endFrame();
             continue;
         }
 
         // ===== LEVEL COMPLETE STATE =====
-        if (gameState == GameState::LEVEL_COMPLETE) {
+        if (frame.state == GameState::LEVEL_COMPLETE) {
             // Render parallax background layers for level complete
             glDisable(GL_DEPTH_TEST);
-            backgroundShader.use();
-            backgroundShader.setFloat("time", currentFrame);
-            backgroundShader.setFloat("alpha", 1.0f); // Full alpha for starfield visibility
-    
-            glActiveTexture(GL_TEXTURE0);
-            // glBindTexture(GL_TEXTURE_2D, backgroundTexture);
-            glBindVertexArray(backgroundVAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
+            renderStarfield(starfieldShader, backgroundVAO, activeStarfieldTexture, currentFrame);
 
             // Render level complete text
-            std::string message = "LEVEL " + std::to_string(currentLevel) + " COMPLETE!";
-            std::string bonusText = "SCORE: " + std::to_string(playerScore);
-            std::string nextLevelText = "ADVANCING TO LEVEL " + std::to_string(currentLevel + 1);
+            const char* message = frameArena.format("LEVEL %d COMPLETE!", frame.level);
+            const char* bonusText = frameArena.format("SCORE: %d", frame.score);
+            const char* nextLevelText = frameArena.format("ADVANCING TO LEVEL %d", frame.level + 1);
             
-            renderText(message.c_str(), currentWindowWidth/2.0f - 150.0f, currentWindowHeight/2.0f - 50.0f, 3.0f, 
-                      glm::vec3(1.0f, 1.0f, 1.0f));
-            renderText(bonusText.c_str(), currentWindowWidth/2.0f - 100.0f, currentWindowHeight/2.0f, 2.5f, 
-                      glm::vec3(1.0f, 1.0f, 0.5f));
-            renderText(nextLevelText.c_str(), currentWindowWidth/2.0f - 150.0f, currentWindowHeight/2.0f + 50.0f, 2.5f, 
-                      glm::vec3(1.0f, 1.0f, 1.0f));
+            textRenderer.add(levelCompleteLabels[0], message, currentWindowWidth/2.0f - 150.0f,
+                             currentWindowHeight/2.0f - 50.0f, 3.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+            textRenderer.add(levelCompleteLabels[1], bonusText, currentWindowWidth/2.0f - 100.0f,
+                             currentWindowHeight/2.0f, 2.5f, glm::vec3(1.0f, 1.0f, 0.5f));
+            textRenderer.add(levelCompleteLabels[2], nextLevelText, currentWindowWidth/2.0f - 150.0f,
+                             currentWindowHeight/2.0f + 50.0f, 2.5f, glm::vec3(1.0f, 1.0f, 1.0f));
+            textRenderer.flush(currentWindowWidth, currentWindowHeight);
             
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+            endFrame();
             continue;
         }
 
@@ -1444,41 +2649,34 @@ int main(int argc, char *argv[])
 
         // render scene normally
         glDisable(GL_DEPTH_TEST);
-        backgroundShader.use();
-        backgroundShader.setFloat("time", currentFrame);
-        backgroundShader.setFloat("alpha", 1.0f); // Full alpha for starfield visibility
-
-        glActiveTexture(GL_TEXTURE0);
-        // glBindTexture(GL_TEXTURE_2D, backgroundTexture);
-        glBindVertexArray(backgroundVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
+        renderStarfield(starfieldShader, backgroundVAO, activeStarfieldTexture, currentFrame);
         
         playerShader.use();
         playerShader.setMat4("view", view);
         playerShader.setMat4("projection", projection);
 
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, playerPosition);
+        model = glm::translate(model, playerRenderPosition);
         model = glm::scale(model, glm::vec3(0.07f, 0.07f, 0.07f));
         model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
         // model = glm::rotate(model, glm::radians(180.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         playerShader.setMat4("model", model);
         // Enable glow only when the player is currently moving (A/D or arrow keys pressed)
-        bool playerMoving = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS ||
-                            glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS ||
-                            glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS ||
-                            glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS;
-
-        float glowIntensity = playerMoving ? 10.0f : 0.0f; // No glow when idle
+        float glowIntensity = frame.playerMoving ? 10.0f : 0.0f; // No glow when idle
 
         playerShader.setVec3("glowColor", glm::vec3(1.0f, 0.5f, 0.0f));
         playerShader.setFloat("glowIntensity", glowIntensity);
-        player->Draw(playerShader);
+        if (player) {
+            player->Draw(playerShader);
+        }
 
         // Draw enemy formation (instanced)
-        if(aliveEnemyPositions.size() > 0)
+        enemyRenderPositions.clear();
+        for (const MovingSprite& enemy : frame.enemies) {
+            enemyRenderPositions.push_back(glm::mix(enemy.previous, enemy.current, interpolation));
+        }
+        if(enemyRenderPositions.size() > 0)
         {
             enemyShader.use();
             enemyShader.setMat4("view", view);
@@ -1486,84 +2684,103 @@ int main(int argc, char *argv[])
 
             // Base transformation for all enemies
             glm::mat4 enemyModel = glm::mat4(1.0f);
-            enemyModel = glm::scale(enemyModel, glm::vec3(0.25f, 0.25f, 0.25f));
+            enemyModel = glm::scale(enemyModel, glm::vec3(0.25f * formation.enemySize));
             enemyShader.setMat4("model", enemyModel);
 
             // update VBO dynamically
             glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, aliveEnemyPositions.size() * sizeof(glm::vec2), aliveEnemyPositions.data());
+            glBufferSubData(GL_ARRAY_BUFFER, 0, enemyRenderPositions.size() * sizeof(glm::vec2), enemyRenderPositions.data());
 
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, enemyTexture);
             glBindVertexArray(enemyVAO);
-            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, aliveEnemyPositions.size());
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, enemyRenderPositions.size());
             glBindVertexArray(0);
         }
 
         // Draw player bullets
-        for (int i = 0; i < MAX_BULLETS; i++) {
-            if (bullets[i].isActive) {
-                enemyShader.use(); // Reuse enemy shader for bullets
-                enemyShader.setMat4("view", view);
-                enemyShader.setMat4("projection", projection);
-
-                // Create transformation matrix for this bullet
-                glm::mat4 bulletModel = glm::mat4(1.0f);
-                bulletModel = glm::translate(bulletModel, glm::vec3(bullets[i].position.x, bullets[i].position.y, 0.0f));
-                bulletModel = glm::scale(bulletModel, glm::vec3(0.5f, 0.6f, 1.0f)); // Smaller and taller for bullet shape
-                enemyShader.setMat4("model", bulletModel);
+        for (const MovingSprite& bullet : frame.bullets) {
+            enemyShader.use(); // Reuse enemy shader for bullets
+            enemyShader.setMat4("view", view);
+            enemyShader.setMat4("projection", projection);
 
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, missileTexture);
-                glBindVertexArray(bulletVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                glBindVertexArray(0);
-            }
+            // Create transformation matrix for this bullet
+            glm::mat4 bulletModel = glm::mat4(1.0f);
+            glm::vec2 bulletPosition = glm::mix(bullet.previous, bullet.current, interpolation);
+            bulletModel = glm::translate(bulletModel, glm::vec3(bulletPosition, 0.0f));
+            bulletModel = glm::scale(bulletModel, glm::vec3(0.5f, 0.6f, 1.0f)); // Smaller and taller for bullet shape
+            enemyShader.setMat4("model", bulletModel);
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, missileTexture);
+            glBindVertexArray(bulletVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glBindVertexArray(0);
         }
 
         // Draw Enemy Bullets
         enemyShader.use();
-        for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
-            if (enemyBullets[i].isActive) {
-                glm::mat4 bulletModel = glm::mat4(1.0f);
-                bulletModel = glm::translate(bulletModel, glm::vec3(enemyBullets[i].position.x, enemyBullets[i].position.y, 0.0f));
-                bulletModel = glm::scale(bulletModel, glm::vec3(0.7f, 0.7f, 1.0f));
-                enemyShader.setMat4("model", bulletModel);
-        
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, enemyMissileTexture);
-                glBindVertexArray(bulletVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-            }
+        for (const MovingSprite& bullet : frame.enemyBullets) {
+            glm::mat4 bulletModel = glm::mat4(1.0f);
+            glm::vec2 bulletPosition = glm::mix(bullet.previous, bullet.current, interpolation);
+            bulletModel = glm::translate(bulletModel, glm::vec3(bulletPosition, 0.0f));
+            bulletModel = glm::scale(bulletModel, glm::vec3(0.7f, 0.7f, 1.0f));
+            enemyShader.setMat4("model", bulletModel);
+    
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, enemyMissileTexture);
+            glBindVertexArray(bulletVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
         }
 
         // Draw explosions (render on top)
         glDisable(GL_DEPTH_TEST); // Ensure explosions are always visible
         glEnable(GL_BLEND); // Enable transparency for explosions
         glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending for more boom!
-        for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-            if (explosions[i].isActive) {
+        for (const ExplosionSnapshot& explosion : frame.explosions) {
+            if (explosionAtlasTexture) {
+                // One atlas fetch per pixel; the pool slot picks the spark variation
+                float progress = explosion.timer / explosion.duration;
+                int flipbookFrame = std::min(static_cast<int>(progress * (EXPLOSION_FLIPBOOK_FRAMES - 1) + 0.5f),
+                                     EXPLOSION_FLIPBOOK_FRAMES - 1);
+
+                explosionFlipbookShader.use();
+                explosionFlipbookShader.setMat4("view", view);
+                explosionFlipbookShader.setMat4("projection", projection);
+                explosionFlipbookShader.setVec2("cell", glm::vec2(flipbookFrame, explosion.slot % EXPLOSION_FLIPBOOK_VARIATIONS));
+
+                glm::mat4 explosionModel = glm::mat4(1.0f);
+                explosionModel = glm::translate(explosionModel, glm::vec3(explosion.position.x, explosion.position.y, 0.0f));
+                explosionModel = glm::scale(explosionModel, glm::vec3(0.5f, 0.5f, 1.0f)); // Control explosion size
+                explosionFlipbookShader.setMat4("model", explosionModel);
+
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, explosionAtlasTexture);
+                glBindVertexArray(explosionVAO);
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+                glBindVertexArray(0);
+            } else {
                 explosionShader.use();
                 explosionShader.setMat4("view", view);
                 explosionShader.setMat4("projection", projection);
 
                 // Send correct explosion-specific time and progress
-                explosionShader.setFloat("explosionTime", explosions[i].timer);
-                explosionShader.setFloat("explosionDuration", explosions[i].duration);
-                explosionShader.setVec2("explosionCenter", explosions[i].position);
+                explosionShader.setFloat("explosionTime", explosion.timer);
+                explosionShader.setFloat("explosionDuration", explosion.duration);
+                explosionShader.setVec2("explosionCenter", explosion.position);
                 
                 // Calculate explosion progress (0.0 to 1.0)
-                float progress = explosions[i].timer / explosions[i].duration;
+                float progress = explosion.timer / explosion.duration;
                 explosionShader.setFloat("explosionProgress", progress);
                 explosionShader.setFloat("currentTime", currentFrame); // For additional effects
 
                 glm::mat4 explosionModel = glm::mat4(1.0f);
-                explosionModel = glm::translate(explosionModel, glm::vec3(explosions[i].position.x, explosions[i].position.y, 0.0f));
+                explosionModel = glm::translate(explosionModel, glm::vec3(explosion.position.x, explosion.position.y, 0.0f));
                 explosionModel = glm::scale(explosionModel, glm::vec3(0.5f, 0.5f, 1.0f)); // Control explosion size
                 explosionShader.setMat4("model", explosionModel);
                 
                 // Debug output (uncomment to debug)
-                // std::cout << "Rendering explosion " << i << " at progress: " << progress << " position: (" << explosions[i].position.x << ", " << explosions[i].position.y << ")" << std::endl;
+                // std::cout << "Rendering explosion " << explosion.slot << " at progress: " << progress << " position: (" << explosion.position.x << ", " << explosion.position.y << ")" << std::endl;
                 
                 glBindVertexArray(explosionVAO);
                 glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -1571,24 +2788,29 @@ int main(int argc, char *argv[])
             }
         }
 
+        // Debris, sparks and engine trail share the additive blend
+        if (particleSystem) {
+            particleSystem->render(view, projection, currentWindowHeight / (2.0f * WORLD_HALF_HEIGHT));
+        }
 
-        // Add HUD display
-        std::string levelText = "LEVEL: " + std::to_string(currentLevel);
-        std::string scoreText = "SCORE: " + std::to_string(playerScore);
-        std::string livesText = "LIVES: " + std::to_string(playerLives);
 
-        renderText(levelText.c_str(), 20.0f, 20.0f, 1.5f, glm::vec3(1.0f, 1.0f, 1.0f));
-        renderText(scoreText.c_str(), 20.0f, 50.0f, 1.5f, glm::vec3(1.0f, 1.0f, 0.0f));
-        renderText(livesText.c_str(), 20.0f, 80.0f, 1.5f, glm::vec3(1.0f, 0.0f, 0.0f));
+        // Add HUD display
+        textRenderer.add(hudLabels[0], frameArena.format("LEVEL: %d", frame.level), 20.0f, 20.0f, 1.5f,
+                         glm::vec3(1.0f, 1.0f, 1.0f));
+        textRenderer.add(hudLabels[1], frameArena.format("SCORE: %d", frame.score), 20.0f, 50.0f, 1.5f,
+                         glm::vec3(1.0f, 1.0f, 0.0f));
+        textRenderer.add(hudLabels[2], frameArena.format("LIVES: %d", frame.lives), 20.0f, 80.0f, 1.5f,
+                         glm::vec3(1.0f, 0.0f, 0.0f));
+        textRenderer.flush(currentWindowWidth, currentWindowHeight);
 
         // Update audio listener position to follow player
         if (audioManager) {
-            audioManager->setListenerPosition(playerPosition.x, playerPosition.y, 0.0f);
+            audioManager->setListenerPosition(playerRenderPosition.x, playerRenderPosition.y, 0.0f);
         }
 
         // blur loop for glow effect
         bool horizontal = true, first_iteration=true;
-        int amount=10;
+        int amount=quality.blurPasses;
         blurShader.use();
         for (unsigned int i=0; i<amount; i++) {
             glBindFramebuffer(GL_FRAMEBUFFER, pingPongFBO[horizontal]);
@@ -1600,7 +2822,7 @@ int main(int argc, char *argv[])
             if (first_iteration)
                 first_iteration = false;
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
 
         // render quad with color buffer and tonemap HDR colors
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -1611,15 +2833,60 @@ int main(int argc, char *argv[])
         glBindTexture(GL_TEXTURE_2D, colorBuffer[1]);
         hdrShader.setFloat("exposure", exposure);
         renderQuad();
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved
         // etc.)
         // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        endFrame();
+    }
+
+    if (simulationThread.joinable()) {
+        simulationRunning = false;
+        simulationThread.join();
+    }
+    int exitCode = 0;
+
+    if (measureLatency) {
+        reportInputLatency();
     }
 
+#ifdef INVADERS_HEADLESS
+    if (headlessMode && !frameTimings.empty()) {
+        // Per-frame timings as CSV plus a short summary for build logs
+        std::string csvPath = headlessOptions.outputDir + "/frame_times.csv";
+        std::ofstream csv(csvPath);
+        csv << "frame,simulation_ms,render_ms,total_ms,allocations,allocated_bytes\n";
+        double totalSum = 0.0, worst = 0.0;
+        for (const auto& timing : frameTimings) {
+            double total = timing.simulationMs + timing.renderMs;
+            csv << timing.frame << "," << timing.simulationMs << "," << timing.renderMs << "," << total << ","
+                << timing.allocations << "," << timing.allocatedBytes << "\n";
+            totalSum += total;
+            worst = std::max(worst, total);
+        }
+        std::cout << "Headless run: " << frameTimings.size() << " frames, avg " << totalSum / frameTimings.size()
+                  << " ms, worst " << worst << " ms (" << csvPath << ")" << std::endl;
+        reportRunAhead(simulationStats);
+
+        TextRenderer::Stats textStats = textRenderer.takeStats();
+        if (textStats.frames > 0) {
+            std::cout << "Text: " << static_cast<double>(textStats.strings) / textStats.frames << " strings, "
+                      << static_cast<double>(textStats.vertices) / textStats.frames << " vertices per frame in one draw call, "
+                      << textStats.layouts << " layouts in " << textStats.frames << " frames" << std::endl;
+        }
+
+        if (headlessOptions.checkAllocations) {
+            std::cout << "Allocation check: " << allocatingFrames << " of " << checkedFrames << " PLAYING frames after "
+                      << headlessOptions.allocationWarmupFrames << " warm-up frames allocated" << std::endl;
+            if (checkedFrames == 0) {
+                std::cerr << "ERROR::ALLOCATIONS::No PLAYING frames past the warm-up; raise --frames" << std::endl;
+            }
+            if (allocatingFrames > 0 || checkedFrames == 0) exitCode = 1;
+        }
+    }
+#endif
+
     // Cleanup resources
     glDeleteVertexArrays(1, &backgroundVAO);
     glDeleteBuffers(1, &backgroundVBO);
@@ -1634,17 +2901,19 @@ int main(int argc, char *argv[])
     glDeleteBuffers(1, &quadVBO);
     glDeleteFramebuffers(2, pingPongFBO);
     glDeleteTextures(2, pingPongColorBuffer);
-    glDeleteTextures(1, &enemyTexture);
-    glDeleteTextures(1, &missileTexture);
+    TextureCache::instance().release(enemyTexture);
+    TextureCache::instance().release(missileTexture);
+    TextureCache::instance().release(enemyMissileTexture);
+    if (starfieldTexture) glDeleteTextures(1, &starfieldTexture);
+    TextureCache::instance().release(explosionAtlasTexture);
     
     // Cleanup parallax textures
     for (const auto& layer : parallaxLayers) {
-        glDeleteTextures(1, &layer.texture);
+        TextureCache::instance().release(layer.texture);
     }
     
     // Cleanup text rendering
-    glDeleteVertexArrays(1, &textVAO);
-    glDeleteBuffers(1, &textVBO);
+    textRenderer.cleanup();
 
     // Cleanup audio manager
     if (audioManager) {
@@ -1652,84 +2921,150 @@ int main(int argc, char *argv[])
         audioManager = nullptr;
     }
 
-    glfwTerminate();
-    return 0;
+    if (particleSystem) {
+        delete particleSystem;
+        particleSystem = nullptr;
+    }
+
+    // Model owns its shared vertex/index buffers
+    delete player;
+
+    if (window) {
+        glfwTerminate();
+    }
+    return exitCode;
 }
+#endif
 
 
-// process all input: query GLFW whether relevant keys are pressed/released this
-// frame and react accordingly
+// Input callbacks: they run inside glfwPollEvents/glfwWaitEventsTimeout and only
+// queue the change; processInputEvents acts on it at the next tick
 // ---------------------------------------------------------------------------------------------------------
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (action == GLFW_REPEAT || key == GLFW_KEY_UNKNOWN) return;
+    inputQueue.push({InputEvent::KEY, key, action, glfwGetTime()});
+}
+
+// The menu is laid out and drawn on this thread, so clicks are hit tested here
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
     if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
+    if (frameSnapshots.readBuffer().state != GameState::MENU || !assetsLoaded) return;
+
+    double mouseX, mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+
+    // Convert mouse position to NDC using current window dimensions
+    float ndcX =  (float)mouseX / (currentWindowWidth  * 0.5f) - 1.0f;
+    float ndcY = -(float)mouseY / (currentWindowHeight * 0.5f) + 1.0f;
     
-    if (gameState == GameState::MENU) {
-        double mouseX, mouseY;
-        glfwGetCursorPos(window, &mouseX, &mouseY);
-        
-        // Convert mouse position to NDC using current window dimensions
-        float ndcX =  (float)mouseX / (currentWindowWidth  * 0.5f) - 1.0f;
-        float ndcY = -(float)mouseY / (currentWindowHeight * 0.5f) + 1.0f;
-        
-        // Check if click is on start button
-        for (auto& button : menuButtons) {
-            if (button.text == "CLICK TO START" &&
-                ndcX >= button.bounds.x && ndcX <= button.bounds.z &&
-                ndcY >= button.bounds.y && ndcY <= button.bounds.w) {
-                
+    // Check if click is on start button
+    for (auto& button : menuButtons) {
+        if (button.text == "CLICK TO START" &&
+            ndcX >= button.bounds.x && ndcX <= button.bounds.z &&
+            ndcY >= button.bounds.y && ndcY <= button.bounds.w) {
+            inputQueue.push({InputEvent::START_GAME, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, glfwGetTime()});
+            break;
+        }
+    }
+}
+
+// A shot pressed at time leaves the tip then, so by the end of this tick's
+// bullet update it has covered tickEnd - time
+void fireBullet(double time, double tickEnd) {
+    createBullet(static_cast<float>(tickEnd - time) - deltaTime);
+    lastBulletTime = static_cast<float>(time);
+}
+
+// Apply the queued input up to tickEnd in timestamp order: movement is integrated
+// between events, presses act at their own time. Later events wait for their tick.
+void processInputEvents(GLFWwindow *window, double tickEnd) {
+    size_t count = applyInputEvents(window, 0, tickEnd);
+    inputQueue.pop(count);
+    latchedEventCount -= std::min(latchedEventCount, count);
+    applyHeldInput(tickEnd - deltaTime, tickEnd);
+}
+
+// Applies queued events from index first on, without taking them off the queue;
+// returns the index of the first event left for a later tick
+size_t applyInputEvents(GLFWwindow *window, size_t first, double tickEnd) {
+    double tickStart = tickEnd - deltaTime;
+    size_t pending = inputQueue.pending();
+    size_t count = first;
+
+    for (; count < pending && inputQueue.peek(count).time <= tickEnd; count++) {
+        const InputEvent& event = inputQueue.peek(count);
+        double time = glm::clamp(event.time, tickStart, tickEnd);
+        if (measureLatency && count >= latchedEventCount) {
+            noteAppliedInput(event.time);
+        }
+
+        advancePlayerTo(time);
+        applyKeyState(event);
+        if (event.action != GLFW_PRESS) continue;
+
+        if (event.type == InputEvent::START_GAME) {
+            if (gameState == GameState::MENU) {
                 gameState = GameState::PLAYING;
-                
+
                 // Play click sound
                 if (audioManager) {
                     audioManager->playSound("laser", 0.3f);
                 }
-                break;
             }
+            continue;
+        }
+        switch (event.code) {
+        case GLFW_KEY_ESCAPE:
+            if (!speculating) glfwSetWindowShouldClose(window, true);
+            break;
+        case GLFW_KEY_R:
+            // Handle game restart
+            if (gameState == GameState::GAME_OVER || gameState == GameState::GAME_WON) {
+                resetGame();
+            }
+            break;
+        case GLFW_KEY_SPACE:
+            // Skip the level transition, or shoot if the cooldown allows
+            if (gameState == GameState::LEVEL_COMPLETE) {
+                advanceToNextLevel();
+            } else if (gameState == GameState::PLAYING && time - lastBulletTime >= BULLET_COOLDOWN) {
+                fireBullet(time, tickEnd);
+            }
+            break;
         }
     }
+    return count;
 }
 
-void processInput(GLFWwindow *window) {
-    float currentTime = glfwGetTime();
-    const float moveSpeed = playerSpeed * deltaTime;
+// Movement and auto-fire for the keys held through the rest of the tick
+void applyHeldInput(double tickStart, double tickEnd) {
+    advancePlayerTo(tickEnd);
 
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-
-    // Handle game restart
-    if ((gameState == GameState::GAME_OVER || gameState == GameState::GAME_WON) && 
-        glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-        // Reset game state
-        resetGame(); // Use new reset function
-        return;
-    }
-
-    // Allow skipping level transition
-    if (gameState == GameState::LEVEL_COMPLETE && 
-        glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        advanceToNextLevel();
-        return;
+    // Holding the spacebar keeps firing on the cooldown
+    if (gameState == GameState::PLAYING && keysDown[GLFW_KEY_SPACE]) {
+        double due = std::max(static_cast<double>(lastBulletTime) + BULLET_COOLDOWN, tickStart);
+        if (due <= tickEnd) {
+            fireBullet(due, tickEnd);
+        }
     }
+}
 
-    // Only allow movement and shooting if game is active
-    if (gameState == GameState::PLAYING) {
-        if(glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-            playerPosition.x -= moveSpeed;
-        if(glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-            playerPosition.x += moveSpeed;
-
-        // Handle bullet shooting with spacebar
-        if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-            if (currentTime - lastBulletTime >= BULLET_COOLDOWN) {
-                createBullet();
-                lastBulletTime = currentTime;
-            }
+// Late latch: pick up input that arrived while this frame was simulated and move
+// the ship to where it is now, just before its transform is built. The events
+// stay queued; the next tick replays them without moving the ship twice.
+void latchPlayerInput() {
+    glfwPollEvents();
+    size_t count = inputQueue.pending();
+    for (size_t i = latchedEventCount; i < count; i++) {
+        const InputEvent& event = inputQueue.peek(i);
+        if (measureLatency) {
+            noteAppliedInput(event.time);
         }
-
-        // Clamp player position to screen bounds
-        playerPosition.x = glm::clamp(playerPosition.x, -WORLD_HALF_WIDTH, WORLD_HALF_WIDTH);
-        playerPosition.y = glm::clamp(playerPosition.y, -WORLD_HALF_HEIGHT, WORLD_HALF_HEIGHT);
+        advancePlayerTo(event.time);
+        applyKeyState(event);
     }
+    latchedEventCount = count;
+    advancePlayerTo(glfwGetTime());
 }
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height)
@@ -1743,43 +3078,16 @@ void framebuffer_size_callback(GLFWwindow *window, int width, int height)
     currentWindowHeight = height;
     
     // Recalculate text button bounds for the new window size
-    if (gameState == GameState::MENU) {
+    if (frameSnapshots.readBuffer().state == GameState::MENU) {
         initMenuButtons();
     }
 }
 
-unsigned int loadTexture(const std::string& path)
+// Sprites and parallax layers go through the shared TextureCache; they tile
+// horizontally for scrolling but must not wrap vertically
+TextureLoadOptions spriteTextureOptions()
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrChannels;
-    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data) {
-        GLenum format;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Set texture wrapping to repeat for tiling effect
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // Prevent vertical tiling
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        std::cout << "Texture loaded successfully: " << path << std::endl;
-    } else {
-        std::cout << "Failed to load texture: " << path << std::endl;
-    }
-
-    stbi_image_free(data);
-    return textureID;
+    TextureLoadOptions options;
+    options.wrapT = GL_CLAMP_TO_EDGE;
+    return options;
 }
@@ -0,0 +1,251 @@
+#include "mesh_cache.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const size_t BLOB_ALIGNMENT = 16;
+
+static uint64_t hashValue(uint64_t hash, uint64_t value) {
+    // FNV-1a over the value's bytes
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const std::string& value) {
+    for (unsigned char c : value) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Folds in a file's size and modification time; false if it cannot be stat'ed
+static bool hashFileStamp(uint64_t& hash, const std::filesystem::path& path) {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    hash = hashValue(hash, size);
+    hash = hashValue(hash, static_cast<uint64_t>(modified.time_since_epoch().count()));
+    return true;
+}
+
+// Material libraries named by the OBJ's mtllib lines, relative to the OBJ's directory
+static std::vector<std::filesystem::path> objMaterialLibraries(const std::filesystem::path& objPath) {
+    std::vector<std::filesystem::path> libraries;
+    std::ifstream file(objPath);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 6, "mtllib") != 0) continue;
+        std::istringstream names(line.substr(start + 6));
+        std::string name;
+        while (names >> name) {
+            libraries.push_back(objPath.parent_path() / name);
+        }
+    }
+    return libraries;
+}
+
+uint64_t meshCacheSourceKey(const std::string& sourcePath, uint32_t importFlags) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hashValue(hash, MESH_CACHE_VERSION);
+    hash = hashValue(hash, importFlags);
+    if (!hashFileStamp(hash, sourcePath)) return 0;
+
+    // Materials live in separate .mtl files for OBJ models, and editing one changes the
+    // imported textures without touching the OBJ itself
+    std::string extension = std::filesystem::path(sourcePath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".obj") {
+        for (const auto& library : objMaterialLibraries(sourcePath)) {
+            hash = hashString(hash, library.filename().string());
+            // a missing library still counts, so the key changes once it appears
+            if (!hashFileStamp(hash, library)) hash = hashValue(hash, 0);
+        }
+    }
+    return hash != 0 ? hash : 1;
+}
+
+std::string meshCachePath(const std::string& cacheDir, const std::string& sourcePath) {
+    // Models in different directories often share a file name, so the name carries a
+    // hash of the full path; the file name stays in front to keep the cache readable
+    std::error_code ec;
+    std::filesystem::path fullPath = std::filesystem::absolute(sourcePath, ec);
+    if (ec) fullPath = sourcePath;
+    uint64_t pathHash = hashString(14695981039346656037ULL, fullPath.lexically_normal().generic_string());
+
+    char suffix[24];
+    snprintf(suffix, sizeof(suffix), "-%016llx", static_cast<unsigned long long>(pathHash));
+    return cacheDir + "/" + std::filesystem::path(sourcePath).filename().string() + suffix + MESH_CACHE_EXTENSION;
+}
+
+static size_t alignUp(size_t value) {
+    return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+}
+
+bool writeMeshCache(const std::string& path, uint64_t sourceKey, const std::vector<MeshCacheEntry>& meshes) {
+    std::vector<MeshCacheMesh> meshTable;
+    std::vector<MeshCacheTexture> textureTable;
+    std::string strings;
+    for (const MeshCacheEntry& entry : meshes) {
+        MeshCacheMesh record = {};
+        record.vertexBytes = static_cast<uint32_t>(entry.vertexData.size());
+        record.indexBytes = static_cast<uint32_t>(entry.indexData.size());
+        record.indexCount = entry.indexCount;
+        record.indexType = entry.indexType;
+        record.hasTangents = entry.hasTangents ? 1 : 0;
+        record.firstTexture = static_cast<uint32_t>(textureTable.size());
+        record.textureCount = static_cast<uint32_t>(entry.textures.size());
+        for (const auto& texture : entry.textures) {
+            MeshCacheTexture textureRecord;
+            textureRecord.typeOffset = static_cast<uint32_t>(strings.size());
+            textureRecord.typeLength = static_cast<uint32_t>(texture.first.size());
+            strings += texture.first;
+            textureRecord.pathOffset = static_cast<uint32_t>(strings.size());
+            textureRecord.pathLength = static_cast<uint32_t>(texture.second.size());
+            strings += texture.second;
+            textureTable.push_back(textureRecord);
+        }
+        meshTable.push_back(record);
+    }
+
+    // lay out the blobs after the tables
+    size_t offset = alignUp(sizeof(MeshCacheHeader) + meshTable.size() * sizeof(MeshCacheMesh) +
+                            textureTable.size() * sizeof(MeshCacheTexture) + strings.size());
+    for (MeshCacheMesh& record : meshTable) {
+        record.vertexOffset = offset;
+        offset = alignUp(offset + record.vertexBytes);
+        record.indexOffset = offset;
+        offset = alignUp(offset + record.indexBytes);
+    }
+
+    MeshCacheHeader header = {};
+    std::memcpy(header.magic, "IVMC", 4);
+    header.version = MESH_CACHE_VERSION;
+    header.sourceKey = sourceKey;
+    header.meshCount = static_cast<uint32_t>(meshTable.size());
+    header.textureCount = static_cast<uint32_t>(textureTable.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cout << "WARNING::MESH_CACHE::Cannot write " << tmpPath << std::endl;
+            return false;
+        }
+        const char padding[BLOB_ALIGNMENT] = {};
+        auto pad = [&]() {
+            size_t position = static_cast<size_t>(file.tellp());
+            file.write(padding, alignUp(position) - position);
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(meshTable.data()), meshTable.size() * sizeof(MeshCacheMesh));
+        file.write(reinterpret_cast<const char*>(textureTable.data()), textureTable.size() * sizeof(MeshCacheTexture));
+        file.write(strings.data(), strings.size());
+        pad();
+        for (const MeshCacheEntry& entry : meshes) {
+            file.write(reinterpret_cast<const char*>(entry.vertexData.data()), entry.vertexData.size());
+            pad();
+            file.write(reinterpret_cast<const char*>(entry.indexData.data()), entry.indexData.size());
+            pad();
+        }
+        if (!file) {
+            std::cout << "WARNING::MESH_CACHE::Failed writing " << tmpPath << std::endl;
+            file.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cout << "WARNING::MESH_CACHE::Cannot store " << path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool MeshCacheFile::open(const std::string& path, uint64_t sourceKey) {
+    if (!file.open(path)) return false;
+
+    const MeshCacheHeader* head = header();
+    if (file.size() < sizeof(MeshCacheHeader) ||
+        std::memcmp(head->magic, "IVMC", 4) != 0 ||
+        head->version != MESH_CACHE_VERSION ||
+        head->sourceKey != sourceKey) {
+        std::cout << "Mesh cache: stale entry " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    // bounds-check every table entry once so the accessors can trust the file
+    uint64_t tablesEnd = sizeof(MeshCacheHeader) + uint64_t(head->meshCount) * sizeof(MeshCacheMesh) +
+                         uint64_t(head->textureCount) * sizeof(MeshCacheTexture) + head->stringBytes;
+    bool valid = tablesEnd <= file.size();
+    for (uint32_t i = 0; valid && i < head->meshCount; i++) {
+        const MeshCacheMesh& record = mesh(i);
+        uint64_t indexSize = record.indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+        valid = (record.indexType == GL_UNSIGNED_SHORT || record.indexType == GL_UNSIGNED_INT) &&
+                record.vertexOffset + record.vertexBytes <= file.size() &&
+                record.indexOffset + record.indexBytes <= file.size() &&
+                uint64_t(record.indexCount) * indexSize <= record.indexBytes &&
+                uint64_t(record.firstTexture) + record.textureCount <= head->textureCount;
+    }
+    for (uint32_t i = 0; valid && i < head->textureCount; i++) {
+        const MeshCacheTexture& record = texture(i);
+        valid = uint64_t(record.typeOffset) + record.typeLength <= head->stringBytes &&
+                uint64_t(record.pathOffset) + record.pathLength <= head->stringBytes;
+    }
+    if (!valid) {
+        std::cout << "Mesh cache: truncated entry " << path << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+const MeshCacheMesh& MeshCacheFile::mesh(uint32_t index) const {
+    return reinterpret_cast<const MeshCacheMesh*>(file.data() + sizeof(MeshCacheHeader))[index];
+}
+
+const MeshCacheTexture& MeshCacheFile::texture(uint32_t index) const {
+    const unsigned char* table = file.data() + sizeof(MeshCacheHeader) + header()->meshCount * sizeof(MeshCacheMesh);
+    return reinterpret_cast<const MeshCacheTexture*>(table)[index];
+}
+
+const char* MeshCacheFile::strings() const {
+    return reinterpret_cast<const char*>(file.data() + sizeof(MeshCacheHeader) +
+                                         header()->meshCount * sizeof(MeshCacheMesh) +
+                                         header()->textureCount * sizeof(MeshCacheTexture));
+}
+
+std::string MeshCacheFile::textureType(uint32_t index) const {
+    const MeshCacheTexture& record = texture(index);
+    return std::string(strings() + record.typeOffset, record.typeLength);
+}
+
+std::string MeshCacheFile::texturePath(uint32_t index) const {
+    const MeshCacheTexture& record = texture(index);
+    return std::string(strings() + record.pathOffset, record.pathLength);
+}
@@ -0,0 +1,304 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+// ===== STATISTICS =====
+
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize) {
+    VertexCacheStats stats = {0.0f, 0.0f};
+    if (indices.empty() || vertexCount == 0) return stats;
+
+    // FIFO: a hit does not refresh the entry, like fixed-function post-transform caches
+    std::vector<unsigned int> insertedAt(vertexCount, 0);   // 0 = never cached
+    unsigned int timestamp = static_cast<unsigned int>(cacheSize) + 1;
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (insertedAt[index] == 0 || timestamp - insertedAt[index] > static_cast<unsigned int>(cacheSize)) {
+            insertedAt[index] = timestamp++;
+            misses++;
+        }
+    }
+
+    size_t usedVertices = 0;
+    for (unsigned int time : insertedAt) {
+        if (time != 0) usedVertices++;
+    }
+    stats.acmr = static_cast<float>(misses) / (indices.size() / 3);
+    stats.atvr = static_cast<float>(misses) / usedVertices;
+    return stats;
+}
+
+// ===== WELDING =====
+
+// Only the attributes Model::processMesh fills in take part in the comparison
+static const size_t WELD_KEY_BYTES = offsetof(Vertex, m_BoneIDs);
+
+void weldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    std::vector<unsigned int> order(vertices.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        int compare = std::memcmp(&vertices[a], &vertices[b], WELD_KEY_BYTES);
+        return compare < 0 || (compare == 0 && a < b);
+    });
+
+    // every run of identical vertices maps onto its first (lowest index) member
+    std::vector<unsigned int> remap(vertices.size());
+    for (size_t i = 0; i < order.size(); ) {
+        size_t runEnd = i + 1;
+        while (runEnd < order.size() &&
+               std::memcmp(&vertices[order[i]], &vertices[order[runEnd]], WELD_KEY_BYTES) == 0) {
+            runEnd++;
+        }
+        for (size_t j = i; j < runEnd; j++) remap[order[j]] = order[i];
+        i = runEnd;
+    }
+
+    for (unsigned int& index : indices) index = remap[index];
+    // the now unreferenced duplicates are removed by optimizeVertexFetch
+}
+
+// ===== VERTEX CACHE (FORSYTH) =====
+
+const int FORSYTH_CACHE_SIZE = 32;
+
+static float forsythVertexScore(int cachePosition, unsigned int remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;     // nothing left to draw with this vertex
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // just used by the last triangle; a fixed score stops strips of near-duplicates
+            score = 0.75f;
+        } else {
+            float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+        }
+    }
+    // favour vertices with few triangles left so they get finished and leave the cache
+    score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+    return score;
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // vertex -> triangle adjacency, compacted as triangles are emitted
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (unsigned int index : indices) remaining[index]++;
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<unsigned int> adjacency(indices.size());
+    {
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<char> emitted(triangleCount, 0);
+    size_t bestTriangle = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[bestTriangle]) bestTriangle = t;
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    std::vector<unsigned int> cache, nextCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+    size_t scanCursor = 0;
+    bool haveBest = true;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (!haveBest) {
+            // nothing in the cache leads anywhere: continue with the next unused triangle
+            while (emitted[scanCursor]) scanCursor++;
+            bestTriangle = scanCursor;
+        }
+
+        emitted[bestTriangle] = 1;
+        const unsigned int* triangle = &indices[bestTriangle * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+
+        // drop the triangle from its vertices' adjacency lists
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = triangle[k];
+            unsigned int* list = &adjacency[offsets[v]];
+            for (unsigned int i = 0; i < remaining[v]; i++) {
+                if (list[i] == bestTriangle) {
+                    list[i] = list[remaining[v] - 1];
+                    remaining[v]--;
+                    break;
+                }
+            }
+        }
+
+        // LRU update: the triangle's vertices move to the front
+        nextCache.clear();
+        for (int k = 0; k < 3; k++) {
+            if (std::find(nextCache.begin(), nextCache.end(), triangle[k]) == nextCache.end()) {
+                nextCache.push_back(triangle[k]);
+            }
+        }
+        for (unsigned int v : cache) {
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) nextCache.push_back(v);
+        }
+
+        // rescore everything that was or is in the cache, including vertices just evicted
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            unsigned int v = nextCache[i];
+            cachePosition[v] = i < static_cast<size_t>(FORSYTH_CACHE_SIZE) ? static_cast<int>(i) : -1;
+            vertexScore[v] = forsythVertexScore(cachePosition[v], remaining[v]);
+        }
+
+        haveBest = false;
+        float bestScore = -1.0f;
+        for (unsigned int v : nextCache) {
+            const unsigned int* list = &adjacency[offsets[v]];
+            for (unsigned int i = 0; i < remaining[v]; i++) {
+                unsigned int t = list[i];
+                float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                    haveBest = true;
+                }
+            }
+        }
+
+        if (nextCache.size() > static_cast<size_t>(FORSYTH_CACHE_SIZE)) nextCache.resize(FORSYTH_CACHE_SIZE);
+        cache.swap(nextCache);
+    }
+
+    indices.swap(output);
+}
+
+// ===== OVERDRAW =====
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float threshold) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    VertexCacheStats original = analyzeVertexCache(indices, vertices.size());
+
+    // Cut clusters where the running ACMR (with the cache flushed at the cluster
+    // start, as it will be once clusters move) has come down to the mesh average;
+    // reordering whole clusters then costs little cache efficiency
+    std::vector<size_t> clusterStarts;
+    std::vector<unsigned int> insertedAt(vertices.size(), 0);
+    unsigned int timestamp = VERTEX_CACHE_STATS_SIZE + 1;
+    size_t clusterMisses = 0, clusterTriangles = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (clusterTriangles == 0) {
+            clusterStarts.push_back(t);
+            timestamp += VERTEX_CACHE_STATS_SIZE + 1;      // flush
+        }
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[t * 3 + k];
+            if (insertedAt[v] == 0 || timestamp - insertedAt[v] > static_cast<unsigned int>(VERTEX_CACHE_STATS_SIZE)) {
+                insertedAt[v] = timestamp++;
+                clusterMisses++;
+            }
+        }
+        clusterTriangles++;
+        if (clusterMisses <= clusterTriangles * original.acmr * threshold) {
+            clusterMisses = 0;
+            clusterTriangles = 0;
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    size_t clusterCount = clusterStarts.size() - 1;
+    if (clusterCount < 2) return;
+
+    // mesh centroid (area weighted)
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> faceNormals(triangleCount);      // length = 2 * area
+    std::vector<glm::vec3> faceCentroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        const glm::vec3& a = vertices[indices[t * 3]].Position;
+        const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+        const glm::vec3& c = vertices[indices[t * 3 + 2]].Position;
+        faceNormals[t] = glm::cross(b - a, c - a);
+        faceCentroids[t] = (a + b + c) / 3.0f;
+        float area = glm::length(faceNormals[t]);
+        meshCentroid += faceCentroids[t] * area;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // clusters that face away from the centre occlude the rest: draw them first
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+            float triangleArea = glm::length(faceNormals[t]);
+            centroid += faceCentroids[t] * triangleArea;
+            normal += faceNormals[t];
+            area += triangleArea;
+        }
+        if (area > 0.0f) centroid /= area;
+        float normalLength = glm::length(normal);
+        sortKey[c] = normalLength > 0.0f ? glm::dot(centroid - meshCentroid, normal / normalLength) : 0.0f;
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    std::iota(clusterOrder.begin(), clusterOrder.end(), size_t(0));
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+                     [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> reordered;
+    reordered.reserve(indices.size());
+    for (size_t c : clusterOrder) {
+        reordered.insert(reordered.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    }
+
+    if (analyzeVertexCache(reordered, vertices.size()).acmr <= original.acmr * threshold) {
+        indices.swap(reordered);
+    }
+}
+
+// ===== VERTEX FETCH =====
+
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(vertices.size(), unused);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = static_cast<unsigned int>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(reordered);
+}
+
+MeshOptimizationStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    MeshOptimizationStats stats;
+    stats.verticesBefore = vertices.size();
+    stats.before = analyzeVertexCache(indices, vertices.size());
+
+    weldVertices(vertices, indices);
+    optimizeVertexCache(indices, vertices.size());
+    optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(vertices, indices);
+
+    stats.verticesAfter = vertices.size();
+    stats.after = analyzeVertexCache(indices, vertices.size());
+    return stats;
+}
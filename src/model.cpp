@@ -1,7 +1,9 @@
 #include "model.h"
 #include "mesh.h"
+#include "mesh_optimizer.h"
 #include "shader.h"
 #include "stb_image.h"
+#include "texture_cache.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/material.h>
@@ -9,6 +11,7 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/types.h>
+#include <chrono>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -16,12 +19,16 @@
 #include <string>
 #include <vector>
 
-unsigned int TextureFromFile(const char *path, const std::string &directory);
-
-Model::Model(std::string const &path, bool gamma) : gammaCorrection(gamma) {
+Model::Model(std::string const &path, bool gamma, const ModelImportOptions &options)
+    : gammaCorrection(gamma), importOptions(options) {
   std::cout << "Model constructor called with path: " << path << std::endl;
+  auto loadStart = std::chrono::steady_clock::now();
   try {
-    loadModel(path);
+    import(path);
+    loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    if (!importOptions.deferUpload) {
+      upload();
+    }
     std::cout << "Model loading completed successfully" << std::endl;
   }
   catch (const std::exception& e) { 
@@ -34,22 +41,334 @@ Model::Model(std::string const &path, bool gamma) : gammaCorrection(gamma) {
   }
 }
 
+void Model::import(std::string const &path) {
+  std::string cachePath;
+  uint64_t sourceKey = 0;
+  if (!importOptions.cacheDir.empty()) {
+    uint32_t importFlags = (importOptions.optimize ? 1u : 0u) | (importOptions.assimpOptimize ? 2u : 0u);
+    sourceKey = meshCacheSourceKey(path, importFlags);
+    cachePath = meshCachePath(importOptions.cacheDir, path);
+  }
+  // keepCPUData needs the unpacked vertices, which only the Assimp path produces
+  bool useCache = sourceKey != 0 && !importOptions.keepCPUData;
+
+  if (useCache && !importOptions.rebuildCache && loadFromCache(path, cachePath, sourceKey)) {
+    loadedFromCache = true;
+  } else {
+    loadModel(path);
+    if (useCache && writeMeshCache(cachePath, sourceKey, importedMeshes)) {
+      std::cout << "Model: wrote mesh cache " << cachePath << std::endl;
+    }
+  }
+
+  // a deferred upload should only have GL work left, so the images are decoded here
+  if (importOptions.deferUpload) {
+    size_t meshCount = importedCache ? importedCache->meshCount() : importedMeshes.size();
+    for (size_t i = 0; i < meshCount; i++) {
+      for (const auto &texture : importedTexturePaths(i)) {
+        std::string fullPath = directory + "/" + texture.second;
+        std::string canonicalPath = TextureCache::canonicalPath(fullPath);
+        bool decoded = false;
+        for (const DecodedImage &image : decodedTextures) {
+          decoded = decoded || image.path == canonicalPath;
+        }
+        DecodedImage image;
+        if (!decoded && TextureCache::decodeImage(fullPath, TextureLoadOptions(), image)) {
+          decodedTextures.push_back(std::move(image));
+        }
+      }
+    }
+  }
+}
+
+std::vector<std::pair<std::string, std::string>> Model::importedTexturePaths(size_t mesh) const {
+  if (!importedCache) {
+    return importedMeshes[mesh].textures;
+  }
+  std::vector<std::pair<std::string, std::string>> textures;
+  const MeshCacheMesh &record = importedCache->mesh(static_cast<uint32_t>(mesh));
+  for (uint32_t t = record.firstTexture; t < record.firstTexture + record.textureCount; t++) {
+    textures.emplace_back(importedCache->textureType(t), importedCache->texturePath(t));
+  }
+  return textures;
+}
+
+void Model::upload() {
+  if (uploaded) {
+    return;
+  }
+  auto uploadStart = std::chrono::steady_clock::now();
+
+  std::vector<PackedMesh> packedMeshes;
+  size_t meshCount = importedCache ? importedCache->meshCount() : importedMeshes.size();
+  for (size_t i = 0; i < meshCount; i++) {
+    std::vector<Texture> textures;
+    for (const auto &entry : importedTexturePaths(i)) {
+      Texture texture;
+      if (loadTexture(entry.second, entry.first, texture)) {
+        textures.push_back(texture);
+      }
+    }
+    if (importedCache) {
+      // vertex and index blobs go from the mapping straight into glBufferSubData
+      const MeshCacheMesh &record = importedCache->mesh(static_cast<uint32_t>(i));
+      packedMeshes.push_back({importedCache->blob(record.vertexOffset), record.vertexBytes,
+                              importedCache->blob(record.indexOffset), record.indexCount, record.indexType,
+                              record.hasTangents != 0, std::move(textures)});
+    } else {
+      const MeshCacheEntry &entry = importedMeshes[i];
+      packedMeshes.push_back({entry.vertexData.data(), entry.vertexData.size(), entry.indexData.data(),
+                              entry.indexCount, entry.indexType, entry.hasTangents, std::move(textures)});
+    }
+  }
+  buildBuffers(packedMeshes);
+
+  if (importOptions.keepCPUData) {
+    for (size_t i = 0; i < submeshes.size(); i++) {
+      submeshes[i].vertices = std::move(importedVertices[i]);
+      submeshes[i].indices = std::move(importedIndices[i]);
+    }
+  }
+  std::vector<MeshCacheEntry>().swap(importedMeshes);
+  std::vector<std::vector<Vertex>>().swap(importedVertices);
+  std::vector<std::vector<unsigned int>>().swap(importedIndices);
+  std::vector<DecodedImage>().swap(decodedTextures);
+  importedCache.reset();
+
+  uploaded = true;
+  loadMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+}
+
+
+Model::~Model() {
+  for (const Texture &texture : textures_loaded) {
+    TextureCache::instance().release(texture.id);
+  }
+  // a model that was only imported (deferUpload) may not have a GL context to talk to
+  if (!uploaded) {
+    return;
+  }
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+  glDeleteBuffers(1, &instanceVBO);
+}
 
 void Model::Draw(Shader &shader){
-  if (meshes.empty()) {
+  if (materials.empty()) {
     std::cerr << "WARNING::MODEL::No meshes to draw" << std::endl;
     return;
   }
-  
-  try {
-    for (unsigned int i=0; i< meshes.size(); i++) {
-      meshes[i].Draw(shader);
+
+  if (!instanceIdentity) {
+    glm::mat4 identity(1.0f);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::mat4), &identity);
+    instanceIdentity = true;
+  }
+  drawBatches(shader, 1);
+}
+
+void Model::DrawInstanced(Shader &shader, const std::vector<glm::mat4> &instanceTransforms) {
+  if (materials.empty() || instanceTransforms.empty()) {
+    return;
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  size_t bytes = instanceTransforms.size() * sizeof(glm::mat4);
+  if (instanceTransforms.size() > instanceCapacity) {
+    glBufferData(GL_ARRAY_BUFFER, bytes, instanceTransforms.data(), GL_DYNAMIC_DRAW);
+    instanceCapacity = instanceTransforms.size();
+  } else {
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instanceTransforms.data());
+  }
+  instanceIdentity = false;
+  drawBatches(shader, static_cast<GLsizei>(instanceTransforms.size()));
+}
+
+void Model::drawBatches(Shader &shader, GLsizei instanceCount) {
+  // sampler -> unit assignments are fixed per model, so they only change with the program
+  if (shader.ID != samplerProgram) {
+    for (size_t unit = 0; unit < samplerNames.size(); unit++) {
+      glUniform1i(glGetUniformLocation(shader.ID, samplerNames[unit].c_str()), static_cast<GLint>(unit));
     }
+    samplerProgram = shader.ID;
   }
-  catch (const std::exception& e) {
-    std::cerr << "ERROR::MODEL::Exception in Draw: " << e.what() << std::endl;
-    throw; // Re-throw the exception for higher-level handling
+
+  size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+  glBindVertexArray(VAO);
+  for (const ModelMaterial &material : materials) {
+    for (size_t i = 0; i < material.textures.size(); i++) {
+      glActiveTexture(GL_TEXTURE0 + material.textureUnits[i]);
+      glBindTexture(GL_TEXTURE_2D, material.textures[i].id);
+    }
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, material.indexCount, indexType,
+                                      (void*)(material.firstIndex * indexSize), instanceCount, material.baseVertex);
+  }
+  glBindVertexArray(0);
+  glActiveTexture(GL_TEXTURE0);
+}
+
+static bool sameTextures(const std::vector<Texture> &a, const std::vector<Texture> &b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].id != b[i].id || a[i].type != b[i].type) return false;
+  }
+  return true;
+}
+
+void Model::buildBuffers(const std::vector<PackedMesh> &packedMeshes) {
+  // group meshes by texture set; each group becomes one contiguous draw
+  std::vector<unsigned int> meshMaterial(packedMeshes.size());
+  for (size_t i = 0; i < packedMeshes.size(); i++) {
+    unsigned int material = 0;
+    while (material < materials.size() && !sameTextures(materials[material].textures, packedMeshes[i].textures)) {
+      material++;
+    }
+    if (material == materials.size()) {
+      ModelMaterial newMaterial;
+      newMaterial.textures = packedMeshes[i].textures;
+      materials.push_back(newMaterial);
+    }
+    meshMaterial[i] = material;
+    hasTangents = hasTangents || packedMeshes[i].hasTangents;
+  }
+
+  // numbered sampler names as Mesh::Draw uses them, one texture unit per distinct name
+  for (ModelMaterial &material : materials) {
+    std::map<std::string, int> typeCounts;
+    for (const Texture &texture : material.textures) {
+      std::string name = texture.type + std::to_string(++typeCounts[texture.type]);
+      size_t unit = 0;
+      while (unit < samplerNames.size() && samplerNames[unit] != name) unit++;
+      if (unit == samplerNames.size()) samplerNames.push_back(name);
+      material.textureUnits.push_back(static_cast<int>(unit));
+    }
   }
+
+  // indices are rebased onto their material's first vertex, so 16-bit indices
+  // only work while every material stays within 65536 vertices
+  size_t stride = PACKED_VERTEX_BASE_SIZE + (hasTangents ? PACKED_VERTEX_TANGENT_SIZE : 0);
+  std::vector<size_t> materialVertices(materials.size(), 0);
+  size_t totalVertices = 0, totalIndices = 0;
+  for (size_t i = 0; i < packedMeshes.size(); i++) {
+    size_t meshStride = PACKED_VERTEX_BASE_SIZE + (packedMeshes[i].hasTangents ? PACKED_VERTEX_TANGENT_SIZE : 0);
+    materialVertices[meshMaterial[i]] += packedMeshes[i].vertexBytes / meshStride;
+    totalVertices += packedMeshes[i].vertexBytes / meshStride;
+    totalIndices += packedMeshes[i].indexCount;
+  }
+  indexType = GL_UNSIGNED_SHORT;
+  for (size_t count : materialVertices) {
+    if (count > 65536) indexType = GL_UNSIGNED_INT;
+  }
+  size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+  gpuBytes = totalVertices * stride + totalIndices * indexSize;
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+  glGenBuffers(1, &instanceVBO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, totalVertices * stride, nullptr, GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, totalIndices * indexSize, nullptr, GL_STATIC_DRAW);
+
+  // submeshes stay in import order; only their ranges follow the material grouping
+  submeshes.resize(packedMeshes.size());
+  size_t vertexCursor = 0, indexCursor = 0;
+  std::vector<unsigned char> scratch;
+  for (unsigned int m = 0; m < materials.size(); m++) {
+    ModelMaterial &material = materials[m];
+    material.baseVertex = static_cast<GLint>(vertexCursor);
+    material.firstIndex = static_cast<unsigned int>(indexCursor);
+
+    for (size_t i = 0; i < packedMeshes.size(); i++) {
+      if (meshMaterial[i] != m) continue;
+      const PackedMesh &mesh = packedMeshes[i];
+      size_t meshStride = PACKED_VERTEX_BASE_SIZE + (mesh.hasTangents ? PACKED_VERTEX_TANGENT_SIZE : 0);
+      size_t vertexCount = mesh.vertexBytes / meshStride;
+
+      // vertices go up unchanged unless another mesh forces the tangent layout
+      glBindBuffer(GL_ARRAY_BUFFER, VBO);
+      if (meshStride == stride) {
+        glBufferSubData(GL_ARRAY_BUFFER, vertexCursor * stride, mesh.vertexBytes, mesh.vertexData);
+      } else {
+        scratch.assign(vertexCount * stride, 0);
+        for (size_t v = 0; v < vertexCount; v++) {
+          std::memcpy(&scratch[v * stride], mesh.vertexData + v * meshStride, meshStride);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, vertexCursor * stride, scratch.size(), scratch.data());
+      }
+
+      // likewise the indices, unless they need rebasing or widening
+      unsigned int offset = static_cast<unsigned int>(vertexCursor - material.baseVertex);
+      if (offset == 0 && mesh.indexType == indexType) {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexCursor * indexSize, mesh.indexCount * indexSize, mesh.indexData);
+      } else {
+        scratch.resize(mesh.indexCount * indexSize);
+        for (unsigned int k = 0; k < mesh.indexCount; k++) {
+          uint32_t index;
+          if (mesh.indexType == GL_UNSIGNED_SHORT) {
+            uint16_t shortIndex;
+            std::memcpy(&shortIndex, mesh.indexData + k * sizeof(uint16_t), sizeof(uint16_t));
+            index = shortIndex;
+          } else {
+            std::memcpy(&index, mesh.indexData + k * sizeof(uint32_t), sizeof(uint32_t));
+          }
+          index += offset;
+          if (indexType == GL_UNSIGNED_SHORT) {
+            uint16_t shortIndex = static_cast<uint16_t>(index);
+            std::memcpy(&scratch[k * sizeof(uint16_t)], &shortIndex, sizeof(uint16_t));
+          } else {
+            std::memcpy(&scratch[k * sizeof(uint32_t)], &index, sizeof(uint32_t));
+          }
+        }
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexCursor * indexSize, scratch.size(), scratch.data());
+      }
+
+      ModelSubmesh &submesh = submeshes[i];
+      submesh.baseVertex = material.baseVertex;
+      submesh.firstIndex = static_cast<unsigned int>(indexCursor);
+      submesh.indexCount = mesh.indexCount;
+      submesh.vertexCount = static_cast<unsigned int>(vertexCount);
+      submesh.material = m;
+
+      vertexCursor += vertexCount;
+      indexCursor += mesh.indexCount;
+    }
+    material.indexCount = static_cast<unsigned int>(indexCursor - material.firstIndex);
+  }
+
+  // same attribute layout as Mesh::setupMesh
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (void*)12);
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)16);
+  if (hasTangents) {
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_SHORT, GL_TRUE, stride, (void*)20);
+  }
+
+  // per-instance model matrix, one column per location
+  glm::mat4 identity(1.0f);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4), &identity, GL_DYNAMIC_DRAW);
+  instanceCapacity = 1;
+  instanceIdentity = true;
+  for (int column = 0; column < 4; column++) {
+    glEnableVertexAttribArray(4 + column);
+    glVertexAttribPointer(4 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)));
+    glVertexAttribDivisor(4 + column, 1);
+  }
+  glBindVertexArray(0);
+
+  std::cout << "Model: " << submeshes.size() << " meshes in " << materials.size() << " draw(s), "
+            << totalVertices << " vertices, " << gpuBytes << " bytes"
+            << (indexType == GL_UNSIGNED_SHORT ? ", 16-bit indices" : "") << std::endl;
 }
 
 void Model::loadModel(std::string const &path){
@@ -65,7 +384,12 @@ void Model::loadModel(std::string const &path){
   std::cout << "Creating Assimp importer..." << std::endl;
   Assimp::Importer importer;
   std::cout << "Reading file with Assimp..." << std::endl;
-  const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+  // tangents are only uploaded for meshes whose material has a normal map
+  unsigned int postProcess = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+  if (importOptions.assimpOptimize) {
+    postProcess |= aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality;
+  }
+  const aiScene *scene = importer.ReadFile(path, postProcess);
   std::cout << "Assimp ReadFile completed" << std::endl;
 
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode){
@@ -97,13 +421,27 @@ void Model::loadModel(std::string const &path){
   }
 }
 
+bool Model::loadFromCache(std::string const &path, std::string const &cachePath, uint64_t sourceKey) {
+  std::unique_ptr<MeshCacheFile> cache(new MeshCacheFile());
+  if (!cache->open(cachePath, sourceKey)) {
+    return false;
+  }
+
+  directory = path.substr(0, path.find_last_of('/'));
+  std::cout << "Model: loaded " << cache->meshCount() << " meshes from mesh cache " << cachePath
+            << " (" << cache->size() << " bytes)" << std::endl;
+  // stays mapped until upload()
+  importedCache = std::move(cache);
+  return true;
+}
+
 void Model::processNode(aiNode *node, const aiScene *scene)
 {
     // process all the node's meshes (if any)
     for(unsigned int i = 0; i < node->mNumMeshes; i++)
     {
         aiMesh *mesh = scene->mMeshes[node->mMeshes[i]]; 
-        meshes.push_back(processMesh(mesh, scene));			
+        processMesh(mesh, scene);			
     }
     // then do the same for each of its children
     for(unsigned int i = 0; i < node->mNumChildren; i++)
@@ -113,7 +451,7 @@ void Model::processNode(aiNode *node, const aiScene *scene)
 }  
 
 
-Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
+void Model::processMesh(aiMesh *mesh, const aiScene *scene) {
   std::cout << "processMesh: Starting..." << std::endl;
   
   if (!mesh) {
@@ -126,6 +464,7 @@ Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
   std::vector<Vertex> vertices;
   std::vector<unsigned int> indices;
   std::vector<Texture> textures;
+  bool hasNormalMap = false;
 
   // Check if mesh has vertices
   if (mesh->mNumVertices == 0) {
@@ -141,7 +480,7 @@ Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
       std::cout << "processMesh: Processing vertex " << i << " of " << mesh->mNumVertices << std::endl;
     }
     
-    Vertex vertex;
+    Vertex vertex{}; // zeroed so unused attributes compare equal when welding
     glm::vec3 vector;
     
     // Check if mesh vertices are valid
@@ -280,17 +619,52 @@ Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
       // load specular map texture
       std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
       textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-    
+
+      // normal map (OBJ exports usually list it as a bump/height map)
+      std::vector<Texture> normalMaps = loadMaterialTextures(material, aiTextureType_NORMALS, "texture_normal");
+      if (normalMaps.empty()) {
+        normalMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
+      }
+      textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
+      hasNormalMap = !normalMaps.empty() && mesh->mTangents && mesh->mBitangents;
     }
     catch (const std::exception& e) {
       std::cout << "WARNING::MODEL::Error loading textures: " << e.what() << std::endl;
     }
   }
 
-  std::cout << "processMesh: Creating and returning mesh..." << std::endl;
+  if (importOptions.optimize && !indices.empty()) {
+    MeshOptimizationStats stats = optimizeMesh(vertices, indices);
+    std::cout << "processMesh: Optimized " << stats.verticesBefore << " -> " << stats.verticesAfter << " vertices, "
+              << "ACMR " << stats.before.acmr << " -> " << stats.after.acmr << ", "
+              << "ATVR " << stats.before.atvr << " -> " << stats.after.atvr
+              << " (FIFO " << VERTEX_CACHE_STATS_SIZE << ")" << std::endl;
+  }
+
+  std::cout << "processMesh: Packing mesh..." << std::endl;
   std::cout << "processMesh: Vertices: " << vertices.size() << ", Indices: " << indices.size() << ", Textures: " << textures.size() << std::endl;
-  
-  return Mesh(vertices, indices, textures);
+
+  // packed once for both the shared model buffers and the cache file
+  size_t unpackedBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+  MeshCacheEntry entry;
+  GLenum indexType;
+  entry.vertexData = Mesh::packVertices(vertices, hasNormalMap);
+  entry.indexData = Mesh::packIndices(indices, vertices.size(), indexType);
+  entry.indexCount = static_cast<unsigned int>(indices.size());
+  entry.indexType = indexType;
+  entry.hasTangents = hasNormalMap;
+  for (const Texture &texture : textures) {
+    entry.textures.emplace_back(texture.type, texture.path);
+  }
+  std::cout << "processMesh: Packed " << entry.vertexData.size() + entry.indexData.size() << " bytes (unpacked " << unpackedBytes << ")"
+            << (indexType == GL_UNSIGNED_SHORT ? ", 16-bit indices" : "")
+            << (hasNormalMap ? ", tangent frame" : "") << std::endl;
+
+  importedMeshes.push_back(std::move(entry));
+  if (importOptions.keepCPUData) {
+    importedVertices.push_back(std::move(vertices));
+    importedIndices.push_back(std::move(indices));
+  }
 }
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName) {
@@ -312,117 +686,37 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType
     }
     
     std::cout << "loadMaterialTextures: Processing texture " << i << ": " << str.C_Str() << std::endl;
-    bool skip = false;
-
-    for (unsigned int j=0; j<textures_loaded.size(); j++) {
-      if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0) {
-        std::cout << "loadMaterialTextures: Reusing already loaded texture" << std::endl;
-        textures.push_back(textures_loaded[j]);
-        skip=true;
-        break;
-      }
-    }
-    if (!skip) {
-      try {
-        std::cout << "loadMaterialTextures: Loading new texture from " << directory << "/" << str.C_Str() << std::endl;
-        Texture texture;
-        texture.id = TextureFromFile(str.C_Str(), this->directory);
-        texture.type = typeName;
-        std::cout << "loadMaterialTextures: Texture ID: " << texture.id << std::endl;
-        texture.path = str.C_Str();
-
-        if (!texture.type.empty()) {
-          std::cout << "loadMaterialTextures: Found " << textureCount << " textures of type " << texture.type << std::endl;
-        }
-        
-        textures.push_back(texture);
-        textures_loaded.push_back(texture);
-      }
-      catch (const std::exception& e) {
-        std::cout << "WARNING::MODEL::Failed to load texture: " << str.C_Str() << " - " << e.what() << std::endl;
-      }
-    }
+    Texture texture;
+    texture.id = 0;
+    texture.type = typeName;
+    texture.path = str.C_Str();
+    textures.push_back(texture);
   }
   
   std::cout << "loadMaterialTextures: Completed for type " << typeName << std::endl;
   return textures; 
 }
 
-unsigned int TextureFromFile(const char *path, const std::string &directory){
-  std::cout << "TextureFromFile: Starting for " << path << std::endl;
-  
-  if (!path) {
-    throw std::runtime_error("ERROR::TEXTURE::Null path in TextureFromFile");
+bool Model::loadTexture(const std::string &path, const std::string &typeName, Texture &texture) {
+  // the process-wide cache shares the GL texture with every other model and sprite using the file
+  std::cout << "loadMaterialTextures: Loading texture from " << directory << "/" << path << std::endl;
+  std::string fullPath = directory + "/" + path;
+  texture.id = 0;
+  std::string canonicalPath = decodedTextures.empty() ? fullPath : TextureCache::canonicalPath(fullPath);
+  for (const DecodedImage &image : decodedTextures) {
+    if (image.path == canonicalPath) {
+      texture.id = TextureCache::instance().acquireDecoded(image, TextureLoadOptions());
+    }
   }
-
-  std::string fileName = std::string(path);
-  fileName = directory + '/' + fileName;
-  std::cout << "TextureFromFile: Full path: " << fileName << std::endl;
-
-  // Check if the file exists
-  std::ifstream f(fileName.c_str());
-  bool exists = f.good();
-  f.close();
-  std::cout << "TextureFromFile: File exists: " << (exists ? "Yes" : "No") << std::endl;
-  
-  if (!exists) {
-    std::string error = "Texture file does not exist: " + fileName;
-    std::cerr << error << std::endl;
-    throw std::runtime_error(error);
+  if (texture.id == 0) {
+    texture.id = TextureCache::instance().acquire(fullPath);
   }
-
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  std::cout << "TextureFromFile: Generated texture ID: " << textureID << std::endl;
-
-  int width, height, nrComponents;
-  
-  // Load image using stb_image
-  std::cout << "TextureFromFile: Loading with stbi_load..." << std::endl;
-  stbi_set_flip_vertically_on_load(true);
-
-  std::cout << "TextureFromFile: Loading image: " << fileName << std::endl;
-    
-  unsigned char* data = stbi_load(fileName.c_str(), &width, &height, &nrComponents, 0);
-  std::cout << "TextureFromFile: stbi_load completed" << std::endl;
-    
-  if (data) {
-    std::cout << "TextureFromFile: Successfully loaded image: " << width << "x" << height << " with " << nrComponents << " components" << std::endl;
-    
-    GLenum format;
-    
-    // Set format based on channels
-    if (nrComponents == 1)
-      format = GL_RED;
-    else if (nrComponents == 3)
-      format = GL_RGB;
-    else if (nrComponents == 4)
-      format = GL_RGBA;
-    else {
-      stbi_image_free(data);
-      throw std::runtime_error("ERROR::TEXTURE::Unsupported number of components: " + std::to_string(nrComponents));
-    }
-
-    std::cout << "TextureFromFile: Uploading to GPU..." << std::endl;
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // Set the texture wrapping/filtering options (on the currently bound texture object)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    std::cout << "TextureFromFile: Texture uploaded successfully" << std::endl;
-
-    stbi_image_free(data);
-  } else {
-    std::string error = "Texture failed to load at path: " + std::string(path) + " - " + std::string(stbi_failure_reason());
-    std::cerr << error << std::endl;
-    stbi_image_free(data);
-    throw std::runtime_error(error);
+  if (texture.id == 0) {
+    std::cout << "WARNING::MODEL::Failed to load texture: " << path << std::endl;
+    return false;
   }
-
-  std::cout << "TextureFromFile: Returning texture ID: " << textureID << std::endl;
-  return textureID;
-};
\ No newline at end of file
+  texture.type = typeName;
+  texture.path = path;
+  textures_loaded.push_back(texture);
+  return true;
+}
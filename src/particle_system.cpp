@@ -0,0 +1,395 @@
+#include "particle_system.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define PARTICLES_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PARTICLES_NEON
+#endif
+
+// ===== EMITTER PRESETS =====
+
+ParticleEmitter ParticleEmitter::explosionDebris(glm::vec2 position) {
+    ParticleEmitter emitter;
+    emitter.position = position;
+    emitter.speedMin = 0.5f;
+    emitter.speedMax = 3.0f;
+    emitter.lifeMin = 0.4f;
+    emitter.lifeMax = 1.2f;
+    emitter.sizeMin = 0.015f;
+    emitter.sizeMax = 0.04f;
+    emitter.drag = 1.5f;
+    emitter.positionJitter = 0.05f;
+    emitter.colorMin = glm::vec4(1.5f, 0.35f, 0.05f, 1.0f);   // deep orange
+    emitter.colorMax = glm::vec4(1.5f, 1.0f, 0.5f, 1.0f);     // yellow-white
+    emitter.count = 400;
+    return emitter;
+}
+
+ParticleEmitter ParticleEmitter::hitSparks(glm::vec2 position, glm::vec2 bulletVelocity) {
+    ParticleEmitter emitter;
+    emitter.position = position;
+    // spray back against the bullet's direction of travel
+    emitter.direction = std::atan2(-bulletVelocity.y, -bulletVelocity.x);
+    emitter.spread = 1.6f;
+    emitter.speedMin = 1.5f;
+    emitter.speedMax = 4.0f;
+    emitter.lifeMin = 0.1f;
+    emitter.lifeMax = 0.35f;
+    emitter.sizeMin = 0.01f;
+    emitter.sizeMax = 0.02f;
+    emitter.drag = 4.0f;
+    emitter.colorMin = glm::vec4(1.5f, 1.2f, 0.4f, 1.0f);
+    emitter.colorMax = glm::vec4(1.5f, 1.5f, 1.2f, 1.0f);
+    emitter.count = 40;
+    return emitter;
+}
+
+ParticleEmitter ParticleEmitter::engineTrail(glm::vec2 position) {
+    ParticleEmitter emitter;
+    emitter.position = position;
+    emitter.direction = -glm::half_pi<float>();    // exhaust points down the screen
+    emitter.spread = 0.4f;
+    emitter.speedMin = 0.6f;
+    emitter.speedMax = 1.2f;
+    emitter.lifeMin = 0.15f;
+    emitter.lifeMax = 0.4f;
+    emitter.sizeMin = 0.02f;
+    emitter.sizeMax = 0.035f;
+    emitter.drag = 2.0f;
+    emitter.positionJitter = 0.02f;
+    emitter.colorMin = glm::vec4(0.4f, 0.7f, 1.5f, 0.8f);
+    emitter.colorMax = glm::vec4(0.6f, 0.9f, 1.5f, 1.0f);
+    emitter.count = 1;
+    return emitter;
+}
+
+// ===== PARTICLE SYSTEM =====
+
+ParticleSystem::ParticleSystem(int maxParticles)
+    : maxParticles(std::max(2, (maxParticles + 1) & ~1)),   // even, so SIMD pairs never split
+      backend(CPU_SIMD), updateShader(nullptr), renderShader(nullptr),
+      buffers{0, 0}, vaos{0, 0}, current(0),
+      dynamicBuffer(0), staticBuffer(0), streamVAO(0),
+      spawnCursor(0), activeRange(0), simulationTime(0.0f), aliveUntil(0.0f),
+      randomState(0x9E3779B9u) {}
+
+ParticleSystem::~ParticleSystem() {
+    cleanup();
+}
+
+const std::vector<const char*>& ParticleSystem::feedbackVaryings() {
+    static const std::vector<const char*> varyings = {
+        "outPosition", "outVelocity", "outAgeLife", "outSizeDrag", "outColor"
+    };
+    return varyings;
+}
+
+bool ParticleSystem::initialize(Shader* update, Shader* render, bool allowGPU) {
+    updateShader = update;
+    renderShader = render;
+    if (!renderShader || renderShader->ID == 0) {
+        std::cerr << "Particle system: render shader missing" << std::endl;
+        return false;
+    }
+
+    if (allowGPU && createGPUBuffers()) {
+        backend = GPU_TRANSFORM_FEEDBACK;
+    } else {
+        createCPUBuffers();
+        backend = CPU_SIMD;
+    }
+
+    pending.reserve(1024);
+    std::cout << "Particle system: " << maxParticles << " particles, "
+              << (backend == GPU_TRANSFORM_FEEDBACK ? "GPU transform feedback" : "CPU SIMD") << std::endl;
+    return true;
+}
+
+bool ParticleSystem::createGPUBuffers() {
+    if (!glad_glTransformFeedbackVaryings || !glad_glBeginTransformFeedback || !glad_glBindBufferBase) {
+        return false;
+    }
+    int linked = 0;
+    if (updateShader && updateShader->ID != 0) {
+        glGetProgramiv(updateShader->ID, GL_LINK_STATUS, &linked);
+    }
+    if (!linked) {
+        std::cerr << "Particle system: update shader not linked, using CPU simulation" << std::endl;
+        return false;
+    }
+
+    // Zeroed particles have age == lifetime == 0, which the shaders treat as dead
+    std::vector<Particle> zeros(maxParticles, Particle{});
+    glGenBuffers(2, buffers);
+    glGenVertexArrays(2, vaos);
+    for (int i = 0; i < 2; i++) {
+        glBindVertexArray(vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, maxParticles * sizeof(Particle), zeros.data(), GL_DYNAMIC_COPY);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, velocity));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, ageLife));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, sizeDrag));
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, color));
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    current = 0;
+    return true;
+}
+
+void ParticleSystem::createCPUBuffers() {
+    positions.assign(maxParticles * 2, 0.0f);
+    velocities.assign(maxParticles * 2, 0.0f);
+    ageLife.assign(maxParticles * 2, 0.0f);
+    dragPairs.assign(maxParticles * 2, 0.0f);
+    sizeDrag.assign(maxParticles * 2, 0.0f);
+    colors.assign(maxParticles * 4, 0.0f);
+
+    size_t pairBytes = maxParticles * 2 * sizeof(float);
+
+    glGenVertexArrays(1, &streamVAO);
+    glGenBuffers(1, &dynamicBuffer);
+    glGenBuffers(1, &staticBuffer);
+    glBindVertexArray(streamVAO);
+
+    // positions | ageLife, orphaned and refilled every frame
+    glBindBuffer(GL_ARRAY_BUFFER, dynamicBuffer);
+    glBufferData(GL_ARRAY_BUFFER, pairBytes * 2, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, pairBytes, pairBytes, ageLife.data());
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)pairBytes);
+
+    // sizeDrag | color, only touched where particles spawn
+    glBindBuffer(GL_ARRAY_BUFFER, staticBuffer);
+    glBufferData(GL_ARRAY_BUFFER, pairBytes * 3, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, pairBytes, sizeDrag.data());
+    glBufferSubData(GL_ARRAY_BUFFER, pairBytes, pairBytes * 2, colors.data());
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)pairBytes);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleSystem::cleanup() {
+    if (buffers[0]) {
+        glDeleteBuffers(2, buffers);
+        glDeleteVertexArrays(2, vaos);
+        buffers[0] = buffers[1] = 0;
+        vaos[0] = vaos[1] = 0;
+    }
+    if (streamVAO) {
+        glDeleteBuffers(1, &dynamicBuffer);
+        glDeleteBuffers(1, &staticBuffer);
+        glDeleteVertexArrays(1, &streamVAO);
+        dynamicBuffer = staticBuffer = streamVAO = 0;
+    }
+}
+
+float ParticleSystem::random(float minValue, float maxValue) {
+    // xorshift32: emitters spawn hundreds of particles per call, rand() is too slow
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return minValue + (maxValue - minValue) * ((randomState >> 8) * (1.0f / 16777216.0f));
+}
+
+void ParticleSystem::emit(const ParticleEmitter& emitter) {
+    for (int i = 0; i < emitter.count; i++) {
+        float angle = emitter.direction + random(-0.5f, 0.5f) * emitter.spread;
+        float speed = random(emitter.speedMin, emitter.speedMax);
+        float life = random(emitter.lifeMin, emitter.lifeMax);
+        float mix = random(0.0f, 1.0f);
+
+        Particle particle;
+        particle.position = emitter.position + glm::vec2(random(-emitter.positionJitter, emitter.positionJitter),
+                                                         random(-emitter.positionJitter, emitter.positionJitter));
+        particle.velocity = emitter.baseVelocity + glm::vec2(std::cos(angle), std::sin(angle)) * speed;
+        particle.ageLife = glm::vec2(0.0f, life);
+        particle.sizeDrag = glm::vec2(random(emitter.sizeMin, emitter.sizeMax), emitter.drag);
+        particle.color = emitter.colorMin + (emitter.colorMax - emitter.colorMin) * mix;
+        pending.push_back(particle);
+    }
+    aliveUntil = std::max(aliveUntil, simulationTime + emitter.lifeMax);
+}
+
+void ParticleSystem::clear() {
+    pending.clear();
+    if (activeRange > 0) {
+        // age past any lifetime marks every touched slot dead
+        std::vector<Particle> zeros(activeRange, Particle{});
+        uploadRun(0, zeros.data(), activeRange);
+    }
+    spawnCursor = 0;
+    activeRange = 0;
+    aliveUntil = simulationTime;
+}
+
+// Writes particles into consecutive slots [first, first + count) of the live storage
+void ParticleSystem::uploadRun(int first, const Particle* particles, int count) {
+    if (count <= 0) return;
+
+    if (backend == GPU_TRANSFORM_FEEDBACK) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[current]);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Particle), count * sizeof(Particle), particles);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Particle& particle = particles[i];
+        int pair = (first + i) * 2;
+        positions[pair] = particle.position.x;
+        positions[pair + 1] = particle.position.y;
+        velocities[pair] = particle.velocity.x;
+        velocities[pair + 1] = particle.velocity.y;
+        ageLife[pair] = particle.ageLife.x;
+        ageLife[pair + 1] = particle.ageLife.y;
+        dragPairs[pair] = particle.sizeDrag.y;
+        dragPairs[pair + 1] = particle.sizeDrag.y;
+        sizeDrag[pair] = particle.sizeDrag.x;
+        sizeDrag[pair + 1] = particle.sizeDrag.y;
+        for (int c = 0; c < 4; c++) colors[(first + i) * 4 + c] = particle.color[c];
+    }
+
+    size_t pairBytes = maxParticles * 2 * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, staticBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, first * 2 * sizeof(float), count * 2 * sizeof(float), &sizeDrag[first * 2]);
+    glBufferSubData(GL_ARRAY_BUFFER, pairBytes + first * 4 * sizeof(float), count * 4 * sizeof(float), &colors[first * 4]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleSystem::flushPending() {
+    if (pending.empty()) return;
+
+    // more than the pool holds: only the newest survive
+    int count = static_cast<int>(pending.size());
+    const Particle* source = pending.data();
+    if (count > maxParticles) {
+        source += count - maxParticles;
+        count = maxParticles;
+    }
+
+    // ring buffer, so at most two contiguous runs
+    int firstRun = std::min(count, maxParticles - spawnCursor);
+    uploadRun(spawnCursor, source, firstRun);
+    uploadRun(0, source + firstRun, count - firstRun);
+
+    if (spawnCursor + count >= maxParticles) activeRange = maxParticles;
+    else activeRange = std::max(activeRange, spawnCursor + count);
+    spawnCursor = (spawnCursor + count) % maxParticles;
+    pending.clear();
+}
+
+// Semi-implicit Euler over the CPU pair streams, matching particle_update.vs:
+// velocity *= max(1 - drag * dt, 0); position += velocity * dt; age += dt
+static void integrateStreams(float* positions, float* velocities, float* ageLife, const float* dragPairs,
+                             size_t floatCount, float deltaTime) {
+    size_t i = 0;
+#if defined(PARTICLES_SSE2)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ageStep = _mm_setr_ps(deltaTime, 0.0f, deltaTime, 0.0f);
+    for (; i + 4 <= floatCount; i += 4) {
+        __m128 damping = _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(dragPairs + i), dt)), zero);
+        __m128 velocity = _mm_mul_ps(_mm_loadu_ps(velocities + i), damping);
+        _mm_storeu_ps(velocities + i, velocity);
+        _mm_storeu_ps(positions + i, _mm_add_ps(_mm_loadu_ps(positions + i), _mm_mul_ps(velocity, dt)));
+        _mm_storeu_ps(ageLife + i, _mm_add_ps(_mm_loadu_ps(ageLife + i), ageStep));
+    }
+#elif defined(PARTICLES_NEON)
+    const float32x4_t dt = vdupq_n_f32(deltaTime);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float ageStepValues[4] = {deltaTime, 0.0f, deltaTime, 0.0f};
+    const float32x4_t ageStep = vld1q_f32(ageStepValues);
+    for (; i + 4 <= floatCount; i += 4) {
+        float32x4_t damping = vmaxq_f32(vsubq_f32(one, vmulq_f32(vld1q_f32(dragPairs + i), dt)), zero);
+        float32x4_t velocity = vmulq_f32(vld1q_f32(velocities + i), damping);
+        vst1q_f32(velocities + i, velocity);
+        vst1q_f32(positions + i, vaddq_f32(vld1q_f32(positions + i), vmulq_f32(velocity, dt)));
+        vst1q_f32(ageLife + i, vaddq_f32(vld1q_f32(ageLife + i), ageStep));
+    }
+#endif
+    for (; i < floatCount; i++) {
+        velocities[i] *= std::max(1.0f - dragPairs[i] * deltaTime, 0.0f);
+        positions[i] += velocities[i] * deltaTime;
+        if ((i & 1) == 0) ageLife[i] += deltaTime;
+    }
+}
+
+void ParticleSystem::update(float deltaTime) {
+    flushPending();
+    simulationTime += deltaTime;
+    if (activeRange == 0) return;
+
+    if (backend == GPU_TRANSFORM_FEEDBACK) {
+        glEnable(GL_RASTERIZER_DISCARD);
+        updateShader->use();
+        updateShader->setFloat("deltaTime", deltaTime);
+        glBindVertexArray(vaos[current]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[1 - current]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, activeRange);
+        glEndTransformFeedback();
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+        glDisable(GL_RASTERIZER_DISCARD);
+        current = 1 - current;
+    } else {
+        // activeRange rounded up to a whole pair; the spare slot is a dead particle
+        size_t floatCount = static_cast<size_t>((activeRange + 1) & ~1) * 2;
+        integrateStreams(positions.data(), velocities.data(), ageLife.data(), dragPairs.data(), floatCount, deltaTime);
+
+        size_t pairBytes = maxParticles * 2 * sizeof(float);
+        glBindBuffer(GL_ARRAY_BUFFER, dynamicBuffer);
+        glBufferData(GL_ARRAY_BUFFER, pairBytes * 2, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, floatCount * sizeof(float), positions.data());
+        glBufferSubData(GL_ARRAY_BUFFER, pairBytes, floatCount * sizeof(float), ageLife.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // Everything has expired: restart from slot 0 so update and draw ranges shrink back.
+    // The small margin covers float drift between per-particle ages and simulationTime.
+    if (simulationTime > aliveUntil + 0.01f) {
+        spawnCursor = 0;
+        activeRange = 0;
+    }
+}
+
+void ParticleSystem::render(const glm::mat4& view, const glm::mat4& projection, float pixelsPerUnit) {
+    if (activeRange == 0) return;
+
+    renderShader->use();
+    renderShader->setMat4("view", view);
+    renderShader->setMat4("projection", projection);
+    renderShader->setFloat("pointScale", pixelsPerUnit);
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glBindVertexArray(backend == GPU_TRANSFORM_FEEDBACK ? vaos[current] : streamVAO);
+    glDrawArrays(GL_POINTS, 0, activeRange);
+    glBindVertexArray(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
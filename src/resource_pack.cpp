@@ -0,0 +1,422 @@
+#include "resource_pack.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// FNV-1a, as for the shader, mesh and texture cache keys
+static uint64_t hashName(const char* name, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static size_t alignUp(size_t value) {
+    return (value + RESOURCE_PACK_ALIGNMENT - 1) & ~size_t(RESOURCE_PACK_ALIGNMENT - 1);
+}
+
+// ===== DEFLATE ENCODER =====
+// zlib stream with a single fixed-Huffman block and greedy hash-chain matching.
+// Ratios are below zlib's, but the packer needs no extra dependency and the game
+// inflates with the decoder that stb_image already carries.
+
+namespace {
+
+const int WINDOW_SIZE = 32768;
+const int MIN_MATCH = 3;
+const int MAX_MATCH = 258;
+const int MAX_CHAIN = 64;
+const int HASH_BITS = 15;
+
+const unsigned short LENGTH_BASE[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const unsigned char LENGTH_EXTRA[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const unsigned short DISTANCE_BASE[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                        193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                        6145, 8193, 12289, 16385, 24577};
+const unsigned char DISTANCE_EXTRA[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char>& output) : out(output) {}
+
+    // Extra bits and header fields go out least significant bit first
+    void bits(uint32_t value, int count) {
+        buffer |= value << used;
+        used += count;
+        while (used >= 8) {
+            out.push_back(static_cast<unsigned char>(buffer));
+            buffer >>= 8;
+            used -= 8;
+        }
+    }
+
+    // Huffman codes go out most significant bit first
+    void code(uint32_t value, int count) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < count; i++) {
+            reversed = (reversed << 1) | ((value >> i) & 1);
+        }
+        bits(reversed, count);
+    }
+
+    void flush() {
+        if (used > 0) out.push_back(static_cast<unsigned char>(buffer));
+        buffer = 0;
+        used = 0;
+    }
+
+private:
+    std::vector<unsigned char>& out;
+    uint32_t buffer = 0;
+    int used = 0;
+};
+
+void writeSymbol(BitWriter& writer, int symbol) {
+    if (symbol <= 143) writer.code(0x30 + symbol, 8);
+    else if (symbol <= 255) writer.code(0x190 + symbol - 144, 9);
+    else if (symbol <= 279) writer.code(symbol - 256, 7);
+    else writer.code(0xC0 + symbol - 280, 8);
+}
+
+void writeMatch(BitWriter& writer, int length, int distance) {
+    int lengthCode = 28;
+    while (LENGTH_BASE[lengthCode] > length) lengthCode--;
+    writeSymbol(writer, 257 + lengthCode);
+    writer.bits(length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+    int distanceCode = 29;
+    while (DISTANCE_BASE[distanceCode] > distance) distanceCode--;
+    writer.code(distanceCode, 5);
+    writer.bits(distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+}
+
+uint32_t hash3(const unsigned char* bytes) {
+    uint32_t value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16);
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+std::vector<unsigned char> zlibCompress(const unsigned char* data, size_t size) {
+    std::vector<unsigned char> out;
+    out.reserve(size / 2 + 64);
+    out.push_back(0x78);    // deflate, 32 KB window
+    out.push_back(0x5e);
+
+    BitWriter writer(out);
+    writer.bits(1, 1);      // final block
+    writer.bits(1, 2);      // fixed Huffman codes
+
+    std::vector<int> head(size_t(1) << HASH_BITS, -1);
+    std::vector<int> previous(WINDOW_SIZE, -1);
+    auto insert = [&](size_t position) {
+        uint32_t hash = hash3(data + position);
+        previous[position & (WINDOW_SIZE - 1)] = head[hash];
+        head[hash] = static_cast<int>(position);
+    };
+
+    size_t position = 0;
+    while (position < size) {
+        int bestLength = 0, bestDistance = 0;
+        if (position + MIN_MATCH <= size) {
+            size_t limit = std::min<size_t>(MAX_MATCH, size - position);
+            int candidate = head[hash3(data + position)];
+            for (int chain = 0; candidate >= 0 && chain < MAX_CHAIN; chain++) {
+                size_t distance = position - candidate;
+                if (distance > WINDOW_SIZE) break;
+                int length = 0;
+                while (static_cast<size_t>(length) < limit && data[candidate + length] == data[position + length]) {
+                    length++;
+                }
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = static_cast<int>(distance);
+                    if (static_cast<size_t>(length) == limit) break;
+                }
+                int next = previous[candidate & (WINDOW_SIZE - 1)];
+                if (next >= candidate) break;   // slot reused by a newer position
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            writeMatch(writer, bestLength, bestDistance);
+            for (int i = 0; i < bestLength; i++, position++) {
+                if (position + MIN_MATCH <= size) insert(position);
+            }
+        } else {
+            writeSymbol(writer, data[position]);
+            if (position + MIN_MATCH <= size) insert(position);
+            position++;
+        }
+    }
+    writeSymbol(writer, 256);   // end of block
+    writer.flush();
+
+    // Adler-32 of the uncompressed data, big-endian
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < size; i++) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<unsigned char>(adler >> shift));
+    }
+    return out;
+}
+
+} // namespace
+
+bool writeResourcePack(const std::string& path, const std::vector<ResourcePackInput>& inputs, bool compress,
+                       ResourcePackStats* stats) {
+    // sorted so the same tree always produces the same file
+    std::vector<const ResourcePackInput*> sorted;
+    for (const ResourcePackInput& input : inputs) sorted.push_back(&input);
+    std::sort(sorted.begin(), sorted.end(), [](const ResourcePackInput* a, const ResourcePackInput* b) {
+        return a->name < b->name;
+    });
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (sorted[i]->name.empty() || sorted[i]->name.size() > UINT16_MAX ||
+            (i > 0 && sorted[i]->name == sorted[i - 1]->name)) {
+            std::cout << "WARNING::RESOURCE_PACK::Bad or duplicate entry name '" << sorted[i]->name << "'" << std::endl;
+            return false;
+        }
+    }
+
+    ResourcePackStats totals;
+    std::vector<std::vector<unsigned char>> compressed(sorted.size());
+    std::vector<ResourcePackEntry> entries(sorted.size());
+    std::string names;
+    size_t offset = alignUp(sizeof(ResourcePackHeader));
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const ResourcePackInput& input = *sorted[i];
+        ResourcePackEntry& entry = entries[i];
+        entry.nameHash = hashName(input.name.data(), input.name.size());
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint16_t>(input.name.size());
+        entry.size = input.data.size();
+        entry.storedSize = input.data.size();
+        entry.flags = 0;
+        names += input.name;
+
+        // stb_image's inflate takes int sizes
+        if (compress && !input.data.empty() && input.data.size() <= INT_MAX) {
+            std::vector<unsigned char> deflated = zlibCompress(input.data.data(), input.data.size());
+            if (deflated.size() <= input.data.size() - input.data.size() / 8) {
+                entry.storedSize = deflated.size();
+                entry.flags = RESOURCE_PACK_COMPRESSED;
+                compressed[i] = std::move(deflated);
+                totals.compressedEntries++;
+            }
+        }
+        entry.offset = offset;
+        offset = alignUp(offset + entry.storedSize);
+        totals.inputBytes += input.data.size();
+    }
+
+    uint32_t bucketCount = 2;
+    while (bucketCount < entries.size() * 2) bucketCount *= 2;
+    std::vector<ResourcePackEntry> buckets(bucketCount);
+    std::memset(buckets.data(), 0, buckets.size() * sizeof(ResourcePackEntry));
+    for (const ResourcePackEntry& entry : entries) {
+        uint32_t bucket = static_cast<uint32_t>(entry.nameHash) & (bucketCount - 1);
+        while (buckets[bucket].nameLength != 0) bucket = (bucket + 1) & (bucketCount - 1);
+        buckets[bucket] = entry;
+    }
+
+    ResourcePackHeader header = {};
+    std::memcpy(header.magic, "IVPK", 4);
+    header.version = RESOURCE_PACK_VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.bucketCount = bucketCount;
+    header.directoryOffset = offset;
+    header.namesOffset = offset + buckets.size() * sizeof(ResourcePackEntry);
+    header.namesSize = names.size();
+
+    std::error_code ec;
+    fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cout << "WARNING::RESOURCE_PACK::Cannot write " << tmpPath << std::endl;
+            return false;
+        }
+        const char padding[RESOURCE_PACK_ALIGNMENT] = {};
+        auto pad = [&]() {
+            size_t position = static_cast<size_t>(file.tellp());
+            file.write(padding, alignUp(position) - position);
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad();
+        for (size_t i = 0; i < sorted.size(); i++) {
+            const std::vector<unsigned char>& data = entries[i].flags & RESOURCE_PACK_COMPRESSED ? compressed[i]
+                                                                                                 : sorted[i]->data;
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            pad();
+        }
+        file.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(ResourcePackEntry));
+        file.write(names.data(), names.size());
+        if (!file) {
+            std::cout << "WARNING::RESOURCE_PACK::Failed writing " << tmpPath << std::endl;
+            file.close();
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+        totals.fileBytes = static_cast<size_t>(file.tellp());
+    }
+
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cout << "WARNING::RESOURCE_PACK::Cannot store " << path << ": " << ec.message() << std::endl;
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    totals.entries = entries.size();
+    if (stats) *stats = totals;
+    return true;
+}
+
+ResourcePack& ResourcePack::instance() {
+    static ResourcePack pack;
+    return pack;
+}
+
+bool ResourcePack::mount(const std::string& packPath, const std::string& rootDir) {
+    unmount();
+    if (!file.open(packPath)) return false;
+    if (!mountMemory(file.data(), file.size(), rootDir)) {
+        file.close();
+        return false;
+    }
+    std::cout << "Mounted resource pack " << packPath << " (" << entryCount() << " entries, "
+              << length / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+bool ResourcePack::mountMemory(const unsigned char* data, size_t size, const std::string& rootDir) {
+    bytes = data;
+    length = size;
+    root.clear();
+    if (!rootDir.empty()) {
+        std::error_code ec;
+        fs::path rootPath = fs::weakly_canonical(fs::absolute(rootDir, ec), ec);
+        root = rootPath.generic_string();
+        if (root.empty() || root.back() != '/') root += '/';
+    }
+    if (!validate(rootDir)) {
+        bytes = nullptr;
+        length = 0;
+        header = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void ResourcePack::unmount() {
+    file.close();
+    bytes = nullptr;
+    length = 0;
+    header = nullptr;
+    buckets = nullptr;
+    names = nullptr;
+    root.clear();
+}
+
+bool ResourcePack::validate(const std::string& description) {
+    header = reinterpret_cast<const ResourcePackHeader*>(bytes);
+    if (length < sizeof(ResourcePackHeader) || std::memcmp(header->magic, "IVPK", 4) != 0 ||
+        header->version != RESOURCE_PACK_VERSION) {
+        std::cout << "WARNING::RESOURCE_PACK::Not a version " << RESOURCE_PACK_VERSION << " pack for "
+                  << description << std::endl;
+        return false;
+    }
+
+    // bounds-check every bucket once so lookups can trust the file
+    uint64_t directoryEnd = header->directoryOffset + uint64_t(header->bucketCount) * sizeof(ResourcePackEntry);
+    bool valid = header->bucketCount != 0 && (header->bucketCount & (header->bucketCount - 1)) == 0 &&
+                 header->entryCount < header->bucketCount && header->directoryOffset % 8 == 0 &&
+                 directoryEnd <= header->namesOffset && header->namesOffset + header->namesSize <= length;
+    if (valid) {
+        buckets = reinterpret_cast<const ResourcePackEntry*>(bytes + header->directoryOffset);
+        names = reinterpret_cast<const char*>(bytes + header->namesOffset);
+    }
+    for (uint32_t i = 0; valid && i < header->bucketCount; i++) {
+        const ResourcePackEntry& entry = buckets[i];
+        if (entry.nameLength == 0) continue;
+        valid = uint64_t(entry.nameOffset) + entry.nameLength <= header->namesSize &&
+                entry.offset + entry.storedSize <= length &&
+                ((entry.flags & RESOURCE_PACK_COMPRESSED) ? entry.size <= INT_MAX : entry.storedSize == entry.size);
+    }
+    if (!valid) {
+        std::cout << "WARNING::RESOURCE_PACK::Truncated or corrupt pack for " << description << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string ResourcePack::entryName(const std::string& path) const {
+    if (root.empty()) return path;
+
+    // lexical first; resolving symlinks costs a stat per path component
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    std::string normalized = absolute.lexically_normal().generic_string();
+    if (normalized.compare(0, root.size(), root) != 0) {
+        normalized = fs::weakly_canonical(absolute, ec).generic_string();
+        if (ec || normalized.compare(0, root.size(), root) != 0) return std::string();
+    }
+    return normalized.substr(root.size());
+}
+
+bool ResourcePack::find(const std::string& path, ResourceData& out) const {
+    if (!bytes) return false;
+    std::string name = entryName(path);
+    if (name.empty()) return false;
+
+    uint64_t hash = hashName(name.data(), name.size());
+    uint32_t mask = header->bucketCount - 1;
+    for (uint32_t bucket = static_cast<uint32_t>(hash) & mask;; bucket = (bucket + 1) & mask) {
+        const ResourcePackEntry& entry = buckets[bucket];
+        if (entry.nameLength == 0) return false;
+        if (entry.nameHash != hash || entry.nameLength != name.size() ||
+            std::memcmp(names + entry.nameOffset, name.data(), name.size()) != 0) {
+            continue;
+        }
+
+        const unsigned char* stored = bytes + entry.offset;
+        if (!(entry.flags & RESOURCE_PACK_COMPRESSED)) {
+            out.data = stored;
+            out.size = static_cast<size_t>(entry.size);
+            out.mapped = true;
+            out.storage.clear();
+            return true;
+        }
+
+        out.storage.resize(static_cast<size_t>(entry.size));
+        int inflated = stbi_zlib_decode_buffer(reinterpret_cast<char*>(out.storage.data()), static_cast<int>(entry.size),
+                                               reinterpret_cast<const char*>(stored), static_cast<int>(entry.storedSize));
+        if (inflated != static_cast<int>(entry.size)) {
+            std::cout << "WARNING::RESOURCE_PACK::Cannot inflate " << name << std::endl;
+            return false;
+        }
+        out.data = out.storage.data();
+        out.size = out.storage.size();
+        out.mapped = false;
+        return true;
+    }
+}
@@ -8,62 +8,141 @@
 #include <sstream>
 #include <iostream>
 #include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <filesystem>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
-  std::string vertexCode;
-  std::string fragmentCode;
-  std::ifstream vShaderFile;
-  std::ifstream fShaderFile;
+std::string Shader::binaryCacheDir;
+
+// Program binary cache file header
+struct ProgramBinaryHeader {
+  char magic[4];            // "IVPB"
+  uint32_t version;
+  uint64_t key;             // hash of sources + driver strings
+  uint32_t binaryFormat;
+  uint32_t length;
+};
+
+static const uint32_t PROGRAM_BINARY_VERSION = 1;
+
+// FNV-1a, good enough to key the cache on source and driver changes
+static uint64_t hashBytes(uint64_t hash, const char* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char)data[i];
+    hash *= 1099511628211ULL;
+  }
+  // separator so "ab"+"c" and "a"+"bc" hash differently
+  hash ^= 0xff;
+  hash *= 1099511628211ULL;
+  return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const char* str) {
+  return hashBytes(hash, str ? str : "", str ? std::strlen(str) : 0);
+}
+
+static bool programBinarySupported() {
+  if (!glad_glProgramBinary || !glad_glGetProgramBinary || !glad_glProgramParameteri) {
+    return false;
+  }
+  GLint numFormats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  return numFormats > 0;
+}
+
+static bool readShaderFile(const char* path, std::string& code) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "ERROR: Shader file does not exist at: " << path << std::endl;
+    return false;
+  }
+  std::stringstream stream;
+  stream << file.rdbuf();
+  code = stream.str();
+  if (code.empty()) {
+    std::cout << "WARNING: Shader file is empty: " << path << std::endl;
+  }
+  return true;
+}
 
-  // Check if files exist before attempting to open them
-  std::ifstream checkVFile(vertexPath);
-  if (!checkVFile.good()) {
-    std::cout << "ERROR: Vertex shader file does not exist at: " << vertexPath << std::endl;
+void Shader::setBinaryCacheDir(const std::string &dir) {
+  binaryCacheDir = dir;
+  if (dir.empty()) return;
+
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) {
+    std::cout << "WARNING::SHADER::Cannot create binary cache dir " << dir << ": " << ec.message() << std::endl;
+    binaryCacheDir.clear();
   }
-  checkVFile.close();
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath,
+               const std::vector<const char*>& feedbackVaryings) {
+  std::string vertexCode;
+  std::string fragmentCode;
 
-  std::ifstream checkFFile(fragmentPath);
-  if (!checkFFile.good()) {
-    std::cout << "ERROR: Fragment shader file does not exist at: " << fragmentPath << std::endl;
+  // read each source once; a missing file is reported here instead of a separate existence check
+  bool vertexRead = readShaderFile(vertexPath, vertexCode);
+  bool fragmentRead = readShaderFile(fragmentPath, fragmentCode);
+  if (!vertexRead || !fragmentRead) {
+    std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
   }
-  checkFFile.close();
 
-  vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-  fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+  std::cout << "Vertex shader content length: " << vertexCode.length() << std::endl;
+  std::cout << "Fragment shader content length: " << fragmentCode.length() << std::endl;
 
-  try {
-    // open files
-    vShaderFile.open(vertexPath);
-    fShaderFile.open(fragmentPath);
-    std::stringstream vShaderStream, fShaderStream;
+  build(vertexCode, fragmentCode, feedbackVaryings);
+}
 
-    // read file's buffer contents into streams
-    vShaderStream << vShaderFile.rdbuf();
-    fShaderStream << fShaderFile.rdbuf();
+Shader::Shader(const ShaderSource& source) {
+  std::string vertexCode = source.vertexCode ? source.vertexCode : "";
+  std::string fragmentCode = source.fragmentCode ? source.fragmentCode : "";
+  if (vertexCode.empty() || fragmentCode.empty()) {
+    std::cout << "ERROR::SHADER::EMPTY_SOURCE" << std::endl;
+  }
 
-    // close file handlers
-    vShaderFile.close();
-    fShaderFile.close();
+  build(vertexCode, fragmentCode, source.feedbackVaryings);
+}
 
-    // convert stream into string
-    vertexCode = vShaderStream.str();
-    fragmentCode = fShaderStream.str();
+void Shader::build(const std::string& vertexCode, const std::string& fragmentCode,
+                   const std::vector<const char*>& feedbackVaryings) {
+  std::string cachePath;
+  uint64_t key = 0;
+  bool useCache = !binaryCacheDir.empty() && !vertexCode.empty() && !fragmentCode.empty() &&
+                  programBinarySupported();
 
-    // Check if files are empty
-    if (vertexCode.empty()) {
-      std::cout << "WARNING: Vertex shader file is empty!" << std::endl;
-    }
-    if (fragmentCode.empty()) {
-      std::cout << "WARNING: Fragment shader file is empty!" << std::endl;
+  if (useCache) {
+    key = 14695981039346656037ULL;
+    key = hashBytes(key, vertexCode.data(), vertexCode.size());
+    key = hashBytes(key, fragmentCode.data(), fragmentCode.size());
+    for (const char* varying : feedbackVaryings) {
+      key = hashString(key, varying);
     }
+    key = hashString(key, (const char*)glGetString(GL_VENDOR));
+    key = hashString(key, (const char*)glGetString(GL_RENDERER));
+    key = hashString(key, (const char*)glGetString(GL_VERSION));
 
-    std::cout << "Vertex shader content length: " << vertexCode.length() << std::endl;
-    std::cout << "Fragment shader content length: " << fragmentCode.length() << std::endl;
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    cachePath = binaryCacheDir + "/" + name;
+
+    if (loadProgramBinary(cachePath, key)) {
+      loadedFromCache = true;
+      return;
+    }
   }
-  catch (std::ifstream::failure& e) {
-    std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+
+  compileAndLinkShaders(vertexCode, fragmentCode, feedbackVaryings);
+
+  if (useCache) {
+    saveProgramBinary(cachePath, key);
   }
+}
 
+void Shader::compileAndLinkShaders(const std::string& vertexCode, const std::string& fragmentCode,
+                                   const std::vector<const char*>& feedbackVaryings) {
   const char* vShaderCode = vertexCode.c_str();
   const char* fShaderCode = fragmentCode.c_str();
 
@@ -99,8 +178,15 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
 
   // shader program
   ID = glCreateProgram();
+  if (!binaryCacheDir.empty() && glad_glProgramParameteri) {
+    glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
   glAttachShader(ID, vertex);
   glAttachShader(ID, fragment);
+  // transform feedback outputs have to be declared before linking
+  if (!feedbackVaryings.empty()) {
+    glTransformFeedbackVaryings(ID, (GLsizei)feedbackVaryings.size(), feedbackVaryings.data(), GL_INTERLEAVED_ATTRIBS);
+  }
   glLinkProgram(ID);
 
   // linking error checking
@@ -114,6 +200,87 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
   glDeleteShader(fragment);
 }
 
+bool Shader::loadProgramBinary(const std::string& cachePath, unsigned long long key) {
+  std::ifstream file(cachePath, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  ProgramBinaryHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (file.gcount() != sizeof(header) ||
+      std::memcmp(header.magic, "IVPB", 4) != 0 ||
+      header.version != PROGRAM_BINARY_VERSION ||
+      header.key != key ||
+      header.length == 0) {
+    std::cout << "Shader cache: stale entry " << cachePath << std::endl;
+    return false;
+  }
+
+  std::vector<char> binary(header.length);
+  file.read(binary.data(), header.length);
+  if ((uint32_t)file.gcount() != header.length) {
+    std::cout << "Shader cache: truncated entry " << cachePath << std::endl;
+    return false;
+  }
+
+  ID = glCreateProgram();
+  glProgramBinary(ID, header.binaryFormat, binary.data(), header.length);
+
+  // the driver rejects binaries from other versions; fall back to compiling from source
+  int success = 0;
+  glGetProgramiv(ID, GL_LINK_STATUS, &success);
+  if (!success) {
+    std::cout << "Shader cache: driver rejected " << cachePath << ", recompiling" << std::endl;
+    glDeleteProgram(ID);
+    ID = 0;
+    return false;
+  }
+  return true;
+}
+
+void Shader::saveProgramBinary(const std::string& cachePath, unsigned long long key) {
+  int success = 0;
+  glGetProgramiv(ID, GL_LINK_STATUS, &success);
+  if (!success) return;
+
+  GLint length = 0;
+  glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  std::vector<char> binary(length);
+  GLenum binaryFormat = 0;
+  GLsizei written = 0;
+  glGetProgramBinary(ID, length, &written, &binaryFormat, binary.data());
+  if (written <= 0) return;
+
+  ProgramBinaryHeader header;
+  std::memcpy(header.magic, "IVPB", 4);
+  header.version = PROGRAM_BINARY_VERSION;
+  header.key = key;
+  header.binaryFormat = binaryFormat;
+  header.length = (uint32_t)written;
+
+  // write to a temporary file and rename so a crash never leaves a half-written entry
+  std::string tmpPath = cachePath + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      std::cout << "WARNING::SHADER::Cannot write binary cache " << tmpPath << std::endl;
+      return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, cachePath, ec);
+  if (ec) {
+    std::cout << "WARNING::SHADER::Cannot store binary cache " << cachePath << ": " << ec.message() << std::endl;
+    std::filesystem::remove(tmpPath, ec);
+  }
+}
+
 void Shader::use() {
   glUseProgram(ID);
 }
@@ -0,0 +1,42 @@
+#include "spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SpatialGrid::begin(glm::vec2 boundsMin, glm::vec2 boundsMax, float cellSize) {
+    origin = boundsMin;
+    inverseCellSize = 1.0f / cellSize;
+    columns = std::max(1, static_cast<int>(std::ceil((boundsMax.x - boundsMin.x) * inverseCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil((boundsMax.y - boundsMin.y) * inverseCellSize)));
+    pointCells.clear();
+    pointIndices.clear();
+}
+
+void SpatialGrid::insert(int index, glm::vec2 position) {
+    pointCells.push_back(cellY(position.y) * columns + cellX(position.x));
+    pointIndices.push_back(index);
+}
+
+void SpatialGrid::end() {
+    // count per cell, prefix sum to offsets, then place the points
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (int cell : pointCells) cellStart[cell + 1]++;
+    for (size_t cell = 1; cell < cellStart.size(); cell++) cellStart[cell] += cellStart[cell - 1];
+
+    indices.resize(pointIndices.size());
+    for (size_t i = 0; i < pointIndices.size(); i++) {
+        // cellStart[cell] walks forward while filling and ends at the next cell's start
+        indices[cellStart[pointCells[i]]++] = pointIndices[i];
+    }
+    // shift back so cellStart[cell] is the first entry of cell again
+    for (size_t cell = cellStart.size() - 1; cell > 0; cell--) cellStart[cell] = cellStart[cell - 1];
+    cellStart[0] = 0;
+}
+
+int SpatialGrid::cellX(float x) const {
+    return std::min(columns - 1, std::max(0, static_cast<int>(std::floor((x - origin.x) * inverseCellSize))));
+}
+
+int SpatialGrid::cellY(float y) const {
+    return std::min(rows - 1, std::max(0, static_cast<int>(std::floor((y - origin.y) * inverseCellSize))));
+}
@@ -0,0 +1,286 @@
+#include "text_renderer.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <iostream>
+
+#include "stb_easy_font.h"
+
+#ifdef INVADERS_SDF_FONT
+#include "sdf_font_atlas.h"
+#endif
+
+namespace {
+
+// FNV-1a over the characters and the scale's bits
+uint64_t layoutKey(const char* text, float scale) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char* c = text; *c; c++) {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+    }
+    uint32_t scaleBits;
+    std::memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ ((scaleBits >> (8 * i)) & 0xFF)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+TextRenderer::TextRenderer(int maxVertices)
+    : maxVertices(maxVertices), bitmapShader(nullptr), sdfShader(nullptr), vao(0), vbo(0), atlasTexture(0),
+      currentFont(BITMAP), overflowReported(false) {
+    batch.reserve(maxVertices);
+}
+
+TextRenderer::~TextRenderer() {
+    cleanup();
+}
+
+bool TextRenderer::initialize(Shader* bitmap, Shader* sdf) {
+    bitmapShader = bitmap;
+    sdfShader = sdf;
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, maxVertices * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+    glBindVertexArray(0);
+
+#ifdef INVADERS_SDF_FONT
+    if (sdfShader) {
+        glGenTextures(1, &atlasTexture);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, SDF_FONT_ATLAS_WIDTH, SDF_FONT_ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE,
+                     SDF_FONT_ATLAS);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        // no mipmaps: averaging distances would move the outline
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        sdfShader->use();
+        sdfShader->setInt("fontAtlas", 0);
+    }
+#endif
+    setFont(SDF);
+    return vao != 0 && vbo != 0;
+}
+
+void TextRenderer::cleanup() {
+    if (vao) glDeleteVertexArrays(1, &vao);
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (atlasTexture) glDeleteTextures(1, &atlasTexture);
+    vao = 0;
+    vbo = 0;
+    atlasTexture = 0;
+}
+
+void TextRenderer::setFont(Font font) {
+    if (font == SDF && !hasSdfFont()) font = BITMAP;
+    if (font == currentFont) return;
+    currentFont = font;
+    // cached geometry is for the other font; labels notice by themselves
+    cache.clear();
+    cachedVertices.clear();
+}
+
+void TextRenderer::layoutSdf(const char* text, float scale, std::vector<TextVertex>& out) {
+#ifdef INVADERS_SDF_FONT
+    const glm::vec2 cellUnits(SDF_FONT_CELL_UNITS_X, SDF_FONT_CELL_UNITS_Y);
+    const glm::vec2 cellUV = cellUnits * static_cast<float>(SDF_FONT_PIXELS_PER_UNIT) /
+                             glm::vec2(SDF_FONT_ATLAS_WIDTH, SDF_FONT_ATLAS_HEIGHT);
+    glm::vec2 pen(0.0f);
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            pen = glm::vec2(0.0f, pen.y + 12.0f);     // stb_easy_font's line height
+            continue;
+        }
+        int glyph = static_cast<unsigned char>(*c) - SDF_FONT_FIRST_CHAR;
+        if (glyph < 0 || glyph >= SDF_FONT_GLYPH_COUNT) continue;
+
+        // the cell, padding included, around the glyph origin at the pen
+        glm::vec2 p0 = (pen - glm::vec2(static_cast<float>(SDF_FONT_PADDING))) * scale;
+        glm::vec2 p1 = p0 + cellUnits * scale;
+        glm::vec2 uv0 = glm::vec2(glyph % SDF_FONT_COLUMNS, glyph / SDF_FONT_COLUMNS) * cellUV;
+        glm::vec2 uv1 = uv0 + cellUV;
+        TextVertex corners[4] = {{p0, uv0}, {glm::vec2(p1.x, p0.y), glm::vec2(uv1.x, uv0.y)},
+                                 {p1, uv1}, {glm::vec2(p0.x, p1.y), glm::vec2(uv0.x, uv1.y)}};
+        static const int indices[6] = {0, 1, 2, 0, 2, 3};
+        for (int index : indices) {
+            out.push_back(corners[index]);
+        }
+        pen.x += SDF_FONT_ADVANCES[glyph];
+    }
+#else
+    (void)text;
+    (void)scale;
+    (void)out;
+#endif
+}
+
+void TextRenderer::layout(const char* text, float scale, std::vector<TextVertex>& out,
+                          glm::vec2& boundsMin, glm::vec2& boundsMax) {
+    char buffer[9999];
+    int numQuads = stb_easy_font_print(0, 0, (char*)text, nullptr, buffer, sizeof(buffer));
+    stats.layouts++;
+
+    boundsMin = glm::vec2(FLT_MAX);
+    boundsMax = glm::vec2(-FLT_MAX);
+    for (int q = 0; q < numQuads; ++q) {
+        // stb_easy_font vertex: x, y, z (float), color (uint8[4]) = 16 bytes, 4 per quad
+        const char* quadData = buffer + q * 4 * 16;
+        glm::vec2 corners[4];
+        for (int i = 0; i < 4; ++i) {
+            const float* vertex = reinterpret_cast<const float*>(quadData + i * 16);
+            corners[i] = glm::vec2(vertex[0], vertex[1]) * scale;
+            boundsMin = glm::min(boundsMin, corners[i]);
+            boundsMax = glm::max(boundsMax, corners[i]);
+        }
+        if (currentFont == BITMAP) {
+            // two triangles: (0,1,2) and (0,2,3)
+            static const int indices[6] = {0, 1, 2, 0, 2, 3};
+            for (int index : indices) {
+                out.push_back({corners[index], glm::vec2(0.0f)});
+            }
+        }
+    }
+    if (numQuads == 0) {
+        boundsMin = boundsMax = glm::vec2(0.0f);
+    }
+    if (currentFont == SDF) {
+        layoutSdf(text, scale, out);
+    }
+}
+
+const TextRenderer::CachedLayout& TextRenderer::cachedLayout(const char* text, float scale) {
+    uint64_t key = layoutKey(text, scale);
+    auto found = cache.find(key);
+    if (found != cache.end() && found->second.scale == scale && found->second.text == text) {
+        return found->second;
+    }
+
+    if (cachedVertices.size() > CACHE_VERTEX_LIMIT) {
+        cache.clear();
+        cachedVertices.clear();
+    }
+    CachedLayout entry;
+    entry.text = text;
+    entry.scale = scale;
+    entry.first = cachedVertices.size();
+    layout(text, scale, cachedVertices, entry.boundsMin, entry.boundsMax);
+    entry.count = cachedVertices.size() - entry.first;
+    // a hash collision just replaces the other string's entry
+    CachedLayout& stored = cache[key];
+    stored = entry;
+    return stored;
+}
+
+void TextRenderer::append(const TextVertex* vertices, size_t count, float x, float y, const glm::vec3& color) {
+    stats.strings++;
+    if (batch.size() + count > static_cast<size_t>(maxVertices)) {
+        if (!overflowReported) {
+            std::cout << "WARNING::TEXT_RENDERER::More than " << maxVertices << " text vertices in a frame, dropping text"
+                      << std::endl;
+            overflowReported = true;
+        }
+        return;
+    }
+    glm::vec2 origin(x, y);
+    for (size_t i = 0; i < count; i++) {
+        batch.push_back({origin + vertices[i].position, vertices[i].uv, color});
+    }
+}
+
+void TextRenderer::add(const char* text, float x, float y, float scale, const glm::vec3& color) {
+    const CachedLayout& cached = cachedLayout(text, scale);
+    append(cachedVertices.data() + cached.first, cached.count, x, y, color);
+}
+
+void TextRenderer::add(TextLabel& label, const char* text, float x, float y, float scale, const glm::vec3& color) {
+    if (label.font != currentFont || label.scale != scale || label.text != text) {
+        // assign and clear keep their capacity, so a label stops allocating once it has seen its longest string
+        label.text = text;
+        label.scale = scale;
+        label.font = currentFont;
+        label.vertices.clear();
+        layout(text, scale, label.vertices, label.boundsMin, label.boundsMax);
+    }
+    append(label.vertices.data(), label.vertices.size(), x, y, color);
+}
+
+void TextRenderer::flush(int viewportWidth, int viewportHeight) {
+    Shader* shader = currentFont == SDF ? sdfShader : bitmapShader;
+    if (batch.empty() || !shader) {
+        batch.clear();
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // orphan last frame's storage instead of waiting for the GPU to finish with it
+    glBufferData(GL_ARRAY_BUFFER, maxVertices * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, batch.size() * sizeof(Vertex), batch.data());
+
+    shader->use();
+    // window pixels, y down
+    shader->setMat4("projection", glm::ortho(0.0f, static_cast<float>(viewportWidth),
+                                             static_cast<float>(viewportHeight), 0.0f));
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    if (currentFont == SDF) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    }
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch.size()));
+    glBindVertexArray(0);
+
+    stats.frames++;
+    stats.vertices += static_cast<int>(batch.size());
+    batch.clear();
+}
+
+float TextRenderer::width(const char* text, float scale) {
+    const CachedLayout& cached = cachedLayout(text, scale);
+    return cached.boundsMax.x - cached.boundsMin.x;
+}
+
+glm::vec4 TextRenderer::bounds(const char* text, float x, float y, float scale, int viewportWidth, int viewportHeight) {
+    const CachedLayout& cached = cachedLayout(text, scale);
+    if (cached.count == 0) return glm::vec4(0.0f);
+
+    glm::vec2 boundsMin = glm::vec2(x, y) + cached.boundsMin;
+    glm::vec2 boundsMax = glm::vec2(x, y) + cached.boundsMax;
+    float ndcX0 =  boundsMin.x / (viewportWidth  * 0.5f) - 1.0f;
+    float ndcX1 =  boundsMax.x / (viewportWidth  * 0.5f) - 1.0f;
+    float ndcY0 = -boundsMax.y / (viewportHeight * 0.5f) + 1.0f;  // flip Y
+    float ndcY1 = -boundsMin.y / (viewportHeight * 0.5f) + 1.0f;
+    return {ndcX0, ndcY0, ndcX1, ndcY1};
+}
+
+TextRenderer::Stats TextRenderer::takeStats() {
+    Stats taken = stats;
+    stats = Stats();
+    return taken;
+}
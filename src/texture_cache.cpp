@@ -0,0 +1,233 @@
+#include "texture_cache.h"
+#include "resource_pack.h"
+#include "stb_image.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+bool TextureCache::bcSupported = false;
+bool TextureCache::etc2Supported = false;
+
+// FNV-1a, as for the shader and mesh cache keys
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t textureKey(const std::string& canonicalPath, const TextureLoadOptions& options) {
+    uint64_t hash = hashBytes(14695981039346656037ULL, canonicalPath.data(), canonicalPath.size());
+    GLint settings[] = {options.flipVertically, options.mipmaps, options.wrapS, options.wrapT,
+                        options.minFilter, options.magFilter, options.allowCompressed};
+    return hashBytes(hash, settings, sizeof(settings));
+}
+
+TextureCache& TextureCache::instance() {
+    static TextureCache cache;
+    return cache;
+}
+
+void ImageDataDeleter::operator()(unsigned char* pixels) const {
+    stbi_image_free(pixels);
+}
+
+std::string TextureCache::canonicalPath(const std::string& path) {
+    // "a/../b.png" and "b.png" are the same file; fall back to the given path if it cannot be resolved
+    std::error_code ec;
+    std::string canonical = std::filesystem::weakly_canonical(path, ec).string();
+    return ec ? path : canonical;
+}
+
+unsigned int TextureCache::acquire(const std::string& path, const TextureLoadOptions& options) {
+    // resident textures skip the decode entirely
+    std::string canonical = canonicalPath(path);
+    auto found = entries.find(textureKey(canonical, options));
+    if (found != entries.end() && found->second.path == canonical) {
+        found->second.references++;
+        return found->second.texture;
+    }
+
+    DecodedImage image;
+    if (!decodeImage(path, options, image)) {
+        return 0;
+    }
+    return acquireDecoded(image, options);
+}
+
+void TextureCache::detectCompressedFormats() {
+    GLint extensionCount = 0, major = 0, minor = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bcSupported = false;
+    etc2Supported = major > 4 || (major == 4 && minor >= 3);
+    for (GLint i = 0; i < extensionCount; i++) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (!name) continue;
+        if (std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) bcSupported = true;
+        if (std::strcmp(name, "GL_ARB_ES3_compatibility") == 0) etc2Supported = true;
+    }
+    std::cout << "Compressed textures: BC " << (bcSupported ? "yes" : "no") << ", ETC2 "
+              << (etc2Supported ? "yes" : "no") << std::endl;
+}
+
+bool TextureCache::loadCompressed(const std::string& canonicalPath, const TextureLoadOptions& options, Ktx2Texture& texture) {
+    // BC first: desktop drivers that accept ETC2 often just decompress it to RGBA8
+    const char* suffixes[] = {bcSupported ? KTX2_SUFFIX_BC : nullptr, etc2Supported ? KTX2_SUFFIX_ETC2 : nullptr};
+    for (const char* suffix : suffixes) {
+        if (!suffix) continue;
+        std::string compressedPath = ktx2SiblingPath(canonicalPath, suffix);
+        ResourceData packed;
+        std::error_code ec;
+        if (ResourcePack::instance().find(compressedPath, packed)) {
+            if (!parseKtx2(packed.data, packed.size, texture)) continue;
+        } else if (!std::filesystem::exists(compressedPath, ec) || !readKtx2(compressedPath, texture)) {
+            continue;
+        }
+        if (texture.bottomUp != options.flipVertically) {
+            std::cout << "WARNING::TEXTURE_CACHE::" << compressedPath << " has the wrong row order, using "
+                      << canonicalPath << std::endl;
+            continue;
+        }
+        return true;
+    }
+    texture = Ktx2Texture();
+    return false;
+}
+
+bool TextureCache::decodeImage(const std::string& path, const TextureLoadOptions& options, DecodedImage& image) {
+    image.path = canonicalPath(path);
+    if (options.allowCompressed && (bcSupported || etc2Supported) &&
+        loadCompressed(image.path, options, image.compressed)) {
+        image.width = image.compressed.width;
+        image.height = image.compressed.height;
+        image.channels = image.compressed.vkFormat == KTX2_FORMAT_BC1_RGB ||
+                         image.compressed.vkFormat == KTX2_FORMAT_ETC2_RGB ? 3 : 4;
+        return true;
+    }
+
+    // the per-thread flip setting keeps concurrent decodes from racing on stb_image's global one
+    stbi_set_flip_vertically_on_load_thread(options.flipVertically);
+    ResourceData packed;
+    if (ResourcePack::instance().find(image.path, packed)) {
+        image.pixels.reset(stbi_load_from_memory(packed.data, static_cast<int>(packed.size), &image.width,
+                                                 &image.height, &image.channels, 0));
+    } else {
+        image.pixels.reset(stbi_load(image.path.c_str(), &image.width, &image.height, &image.channels, 0));
+    }
+    if (!image.pixels) {
+        std::cout << "Failed to load texture: " << path << " (" << stbi_failure_reason() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+unsigned int TextureCache::acquireDecoded(const DecodedImage& image, const TextureLoadOptions& options) {
+    uint64_t key = textureKey(image.path, options);
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+        if (found->second.path == image.path) {
+            found->second.references++;
+            return found->second.texture;
+        }
+        std::cout << "WARNING::TEXTURE_CACHE::Hash collision between " << found->second.path
+                  << " and " << image.path << ", loading uncached" << std::endl;
+    }
+    const Ktx2Texture& compressed = image.compressed;
+    if (!image.pixels && compressed.vkFormat == 0) {
+        return 0;
+    }
+
+    int width = image.width, height = image.height, channels = image.channels;
+    size_t bytes = 0;
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (compressed.vkFormat != 0) {
+        // the file's mip chain replaces glGenerateMipmap, which cannot run on compressed formats
+        GLsizei levels = options.mipmaps ? static_cast<GLsizei>(compressed.levels.size()) : 1;
+        GLenum internalFormat = ktx2GLInternalFormat(compressed.vkFormat);
+        for (GLsizei level = 0; level < levels; level++) {
+            const Ktx2Level& entry = compressed.levels[level];
+            const unsigned char* data = compressed.data.data() + entry.offset;
+            if (compressed.vkFormat == KTX2_FORMAT_RGBA8) {
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, entry.width, entry.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            } else {
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, entry.width, entry.height, 0,
+                                       static_cast<GLsizei>(entry.size), data);
+            }
+            bytes += entry.size;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    } else {
+        GLenum format = channels == 1 ? GL_RED : channels == 2 ? GL_RG : channels == 3 ? GL_RGB : GL_RGBA;
+        // rows of 1- and 3-channel images are not necessarily 4-byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (options.mipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+
+        // drivers pad RGB to RGBA; a full mip chain adds a third
+        size_t texelBytes = channels == 3 ? 4 : static_cast<size_t>(channels);
+        bytes = static_cast<size_t>(width) * height * texelBytes;
+        if (options.mipmaps) bytes += bytes / 3;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, options.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, options.wrapT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, options.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, options.magFilter);
+
+    if (found != entries.end()) {
+        // colliding key: the texture lives outside the cache, release() deletes it directly
+        return texture;
+    }
+    const char* format = compressed.vkFormat != 0 ? ktx2FormatName(compressed.vkFormat) : "uncompressed";
+    entries[key] = Entry{image.path, texture, width, height, channels, format, bytes, 1};
+    keysByTexture[texture] = key;
+    totalBytes += bytes;
+    std::cout << "Texture loaded successfully: " << image.path << " (" << width << "x" << height << ", "
+              << format << ", " << bytes / 1024 << " KB, " << totalBytes / 1024 << " KB resident)" << std::endl;
+    return texture;
+}
+
+void TextureCache::addReference(unsigned int texture) {
+    auto found = keysByTexture.find(texture);
+    if (found != keysByTexture.end()) {
+        entries[found->second].references++;
+    }
+}
+
+void TextureCache::release(unsigned int texture) {
+    if (texture == 0) return;
+    auto found = keysByTexture.find(texture);
+    if (found == keysByTexture.end()) {
+        glDeleteTextures(1, &texture);
+        return;
+    }
+
+    Entry& entry = entries[found->second];
+    if (--entry.references > 0) return;
+
+    totalBytes -= entry.bytes;
+    glDeleteTextures(1, &entry.texture);
+    entries.erase(found->second);
+    keysByTexture.erase(found);
+}
+
+size_t TextureCache::getTextureBytes(unsigned int texture) const {
+    auto found = keysByTexture.find(texture);
+    return found != keysByTexture.end() ? entries.at(found->second).bytes : 0;
+}
+
+void TextureCache::logUsage() const {
+    std::cout << "Texture cache: " << entries.size() << " textures, " << totalBytes / 1024 << " KB" << std::endl;
+    for (const auto& item : entries) {
+        const Entry& entry = item.second;
+        std::cout << "  " << entry.path << ": " << entry.width << "x" << entry.height << "x" << entry.channels
+                  << " " << entry.format << ", " << entry.bytes / 1024 << " KB, " << entry.references << " reference(s)" << std::endl;
+    }
+}
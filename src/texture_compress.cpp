@@ -0,0 +1,486 @@
+#include "texture_compress.h"
+#include "ktx2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// One 4x4 block; texel i is at (x, y) = (i % 4, i / 4)
+struct Block {
+    int rgba[16][4];
+    bool visible[16];   // alpha > 0, or every texel when the whole block is transparent
+};
+
+static Block fetchBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY) {
+    Block block;
+    bool anyVisible = false;
+    for (int i = 0; i < 16; i++) {
+        int x = std::min(blockX * 4 + i % 4, width - 1);
+        int y = std::min(blockY * 4 + i / 4, height - 1);
+        const unsigned char* texel = rgba + (static_cast<size_t>(y) * width + x) * 4;
+        for (int c = 0; c < 4; c++) block.rgba[i][c] = texel[c];
+        block.visible[i] = texel[3] > 0;
+        anyVisible = anyVisible || block.visible[i];
+    }
+    if (!anyVisible) {
+        for (bool& visible : block.visible) visible = true;
+    }
+    return block;
+}
+
+static int clampByte(int value) {
+    return value < 0 ? 0 : value > 255 ? 255 : value;
+}
+
+static int colorError(const int* a, const int* b) {
+    int dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+// ===== BC1 / BC3 =====
+
+static uint16_t packRGB565(const float* color) {
+    int r = std::min(31, std::max(0, static_cast<int>(std::lround(color[0] * 31.0f / 255.0f))));
+    int g = std::min(63, std::max(0, static_cast<int>(std::lround(color[1] * 63.0f / 255.0f))));
+    int b = std::min(31, std::max(0, static_cast<int>(std::lround(color[2] * 31.0f / 255.0f))));
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+static void unpackRGB565(uint16_t packed, int* color) {
+    int r = packed >> 11 & 31, g = packed >> 5 & 63, b = packed & 31;
+    color[0] = r << 3 | r >> 2;
+    color[1] = g << 2 | g >> 4;
+    color[2] = b << 3 | b >> 2;
+}
+
+// Picks the nearest of the four palette entries for every texel; returns the error of the visible ones
+static int fitBC1Indices(const Block& block, uint16_t color0, uint16_t color1, uint32_t& indices) {
+    int palette[4][3];
+    unpackRGB565(color0, palette[0]);
+    unpackRGB565(color1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    indices = 0;
+    int error = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestError = colorError(block.rgba[i], palette[0]);
+        for (int p = 1; p < 4; p++) {
+            int e = colorError(block.rgba[i], palette[p]);
+            if (e < bestError) {
+                best = p;
+                bestError = e;
+            }
+        }
+        indices |= static_cast<uint32_t>(best) << (2 * i);
+        if (block.visible[i]) error += bestError;
+    }
+    return error;
+}
+
+// Four-colour BC1 block: endpoints along the principal axis of the visible
+// texels, then two least-squares refinements of the endpoints for the chosen indices
+static int encodeColorBC1(const Block& block, unsigned char* out) {
+    float mean[3] = {0, 0, 0};
+    int count = 0;
+    for (int i = 0; i < 16; i++) {
+        if (!block.visible[i]) continue;
+        for (int c = 0; c < 3; c++) mean[c] += block.rgba[i][c];
+        count++;
+    }
+    for (float& m : mean) m /= count;
+
+    float covariance[6] = {0, 0, 0, 0, 0, 0};   // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++) {
+        if (!block.visible[i]) continue;
+        float d[3] = {block.rgba[i][0] - mean[0], block.rgba[i][1] - mean[1], block.rgba[i][2] - mean[2]};
+        covariance[0] += d[0] * d[0]; covariance[1] += d[0] * d[1]; covariance[2] += d[0] * d[2];
+        covariance[3] += d[1] * d[1]; covariance[4] += d[1] * d[2]; covariance[5] += d[2] * d[2];
+    }
+    float axis[3] = {1, 1, 1};
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[3] = {
+            covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+            covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+            covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]};
+        float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < 1e-6f) break;
+        for (int c = 0; c < 3; c++) axis[c] = next[c] / length;
+    }
+
+    float minProjection = 1e9f, maxProjection = -1e9f;
+    for (int i = 0; i < 16; i++) {
+        if (!block.visible[i]) continue;
+        float projection = (block.rgba[i][0] - mean[0]) * axis[0] + (block.rgba[i][1] - mean[1]) * axis[1] +
+                           (block.rgba[i][2] - mean[2]) * axis[2];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    float high[3], low[3];
+    for (int c = 0; c < 3; c++) {
+        high[c] = mean[c] + axis[c] * maxProjection;
+        low[c] = mean[c] + axis[c] * minProjection;
+    }
+
+    uint16_t color0 = packRGB565(high), color1 = packRGB565(low);
+    uint32_t indices;
+    int error = fitBC1Indices(block, color0, color1, indices);
+
+    static const float WEIGHTS[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    for (int iteration = 0; iteration < 2 && error > 0; iteration++) {
+        float aa = 0, ab = 0, bb = 0, ax[3] = {0, 0, 0}, bx[3] = {0, 0, 0};
+        for (int i = 0; i < 16; i++) {
+            if (!block.visible[i]) continue;
+            float w = WEIGHTS[indices >> (2 * i) & 3];
+            aa += w * w; ab += w * (1 - w); bb += (1 - w) * (1 - w);
+            for (int c = 0; c < 3; c++) {
+                ax[c] += w * block.rgba[i][c];
+                bx[c] += (1 - w) * block.rgba[i][c];
+            }
+        }
+        float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f) break;
+        for (int c = 0; c < 3; c++) {
+            high[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+            low[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+        }
+        uint16_t refined0 = packRGB565(high), refined1 = packRGB565(low);
+        uint32_t refinedIndices;
+        int refinedError = fitBC1Indices(block, refined0, refined1, refinedIndices);
+        if (refinedError >= error) break;
+        color0 = refined0; color1 = refined1; indices = refinedIndices; error = refinedError;
+    }
+
+    // color0 > color1 selects the four-colour mode; swapping the endpoints swaps indices 0<->1 and 2<->3
+    if (color0 < color1) {
+        std::swap(color0, color1);
+        indices ^= 0x55555555;
+    } else if (color0 == color1) {
+        indices = 0;
+    }
+    out[0] = color0 & 0xff; out[1] = color0 >> 8;
+    out[2] = color1 & 0xff; out[3] = color1 >> 8;
+    for (int i = 0; i < 4; i++) out[4 + i] = indices >> (8 * i) & 0xff;
+    return error;
+}
+
+static int fitBC3Alpha(const Block& block, int alpha0, int alpha1, uint64_t& indices) {
+    int palette[8] = {alpha0, alpha1};
+    if (alpha0 > alpha1) {
+        for (int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    } else {
+        for (int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    indices = 0;
+    int error = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestError = 1 << 30;
+        for (int p = 0; p < 8; p++) {
+            int d = block.rgba[i][3] - palette[p];
+            if (d * d < bestError) {
+                best = p;
+                bestError = d * d;
+            }
+        }
+        indices |= static_cast<uint64_t>(best) << (3 * i);
+        error += bestError;
+    }
+    return error;
+}
+
+// Tries the 8-value ramp between the extremes and the 6-value ramp with exact 0 and 255
+static int encodeAlphaBC3(const Block& block, unsigned char* out) {
+    int minAlpha = 255, maxAlpha = 0, minInner = 255, maxInner = 0;
+    for (int i = 0; i < 16; i++) {
+        int alpha = block.rgba[i][3];
+        minAlpha = std::min(minAlpha, alpha);
+        maxAlpha = std::max(maxAlpha, alpha);
+        if (alpha != 0 && alpha != 255) {
+            minInner = std::min(minInner, alpha);
+            maxInner = std::max(maxInner, alpha);
+        }
+    }
+    if (minInner > maxInner) minInner = maxInner = 0;
+
+    uint64_t indices, innerIndices;
+    int alpha0 = maxAlpha, alpha1 = minAlpha;
+    int error = fitBC3Alpha(block, alpha0, alpha1, indices);
+    int innerError = fitBC3Alpha(block, minInner, maxInner, innerIndices);
+    if (innerError < error) {
+        alpha0 = minInner; alpha1 = maxInner; indices = innerIndices; error = innerError;
+    }
+    out[0] = static_cast<unsigned char>(alpha0);
+    out[1] = static_cast<unsigned char>(alpha1);
+    for (int i = 0; i < 6; i++) out[2 + i] = indices >> (8 * i) & 0xff;
+    return error;
+}
+
+// ===== ETC2 =====
+
+static const int ETC_MODIFIERS[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+// texel index -> 2-bit selector (msb, lsb): 0 = +small, 1 = +large, 2 = -small, 3 = -large
+static int etcModifier(int table, int selector) {
+    int magnitude = ETC_MODIFIERS[table][selector & 1];
+    return selector & 2 ? -magnitude : magnitude;
+}
+
+struct EtcSubblock {
+    int base[3];            // quantized (4 or 5 bits per channel)
+    int table;
+    int selectors[16];      // by texel index, only the subblock's texels are set
+    int error;
+};
+
+static int expandEtcColor(int value, int bits) {
+    return bits == 4 ? value << 4 | value : value << 3 | value >> 2;
+}
+
+// Best modifier table for the texels at the given base colour
+static void fitEtcSubblock(const Block& block, const int* texels, const int* base, int bits, EtcSubblock& result) {
+    int expanded[3] = {expandEtcColor(base[0], bits), expandEtcColor(base[1], bits), expandEtcColor(base[2], bits)};
+    result.error = 1 << 30;
+    for (int table = 0; table < 8; table++) {
+        int error = 0, selectors[8];
+        for (int t = 0; t < 8; t++) {
+            const int* texel = block.rgba[texels[t]];
+            int best = 0, bestError = 1 << 30;
+            for (int selector = 0; selector < 4; selector++) {
+                int modifier = etcModifier(table, selector);
+                int color[3] = {clampByte(expanded[0] + modifier), clampByte(expanded[1] + modifier),
+                                clampByte(expanded[2] + modifier)};
+                int e = colorError(texel, color);
+                if (e < bestError) {
+                    best = selector;
+                    bestError = e;
+                }
+            }
+            selectors[t] = best;
+            if (block.visible[texels[t]]) error += bestError;
+        }
+        if (error < result.error) {
+            result.error = error;
+            result.table = table;
+            for (int c = 0; c < 3; c++) result.base[c] = base[c];
+            for (int t = 0; t < 8; t++) result.selectors[texels[t]] = selectors[t];
+        }
+    }
+}
+
+// Searches the quantized average colour and its neighbours
+static void encodeEtcSubblock(const Block& block, const int* texels, int bits, EtcSubblock& result) {
+    float average[3] = {0, 0, 0};
+    int count = 0;
+    for (int t = 0; t < 8; t++) {
+        if (!block.visible[texels[t]]) continue;
+        for (int c = 0; c < 3; c++) average[c] += block.rgba[texels[t]][c];
+        count++;
+    }
+    int maxValue = (1 << bits) - 1;
+    int center[3];
+    for (int c = 0; c < 3; c++) {
+        float mean = count > 0 ? average[c] / count : 0.0f;
+        center[c] = std::min(maxValue, std::max(0, static_cast<int>(std::lround(mean * maxValue / 255.0f))));
+    }
+
+    result.error = 1 << 30;
+    for (int dr = -1; dr <= 1; dr++)
+        for (int dg = -1; dg <= 1; dg++)
+            for (int db = -1; db <= 1; db++) {
+                int base[3] = {center[0] + dr, center[1] + dg, center[2] + db};
+                if (std::min({base[0], base[1], base[2]}) < 0 || std::max({base[0], base[1], base[2]}) > maxValue) continue;
+                EtcSubblock candidate;
+                fitEtcSubblock(block, texels, base, bits, candidate);
+                if (candidate.error < result.error) result = candidate;
+            }
+}
+
+// ETC1-compatible individual/differential block, which every ETC2 decoder reads
+// the same way (the T, H and planar modes are not used)
+static int encodeColorETC(const Block& block, unsigned char* out) {
+    int bestError = 1 << 30;
+    for (int flip = 0; flip < 2; flip++) {
+        // flip 0: left/right 2x4 halves, flip 1: top/bottom 4x2 halves
+        int texels[2][8], half[16];
+        int counts[2] = {0, 0};
+        for (int i = 0; i < 16; i++) {
+            half[i] = flip ? (i / 4 >= 2) : (i % 4 >= 2);
+            texels[half[i]][counts[half[i]]++] = i;
+        }
+
+        for (int differential = 0; differential < 2; differential++) {
+            int bits = differential ? 5 : 4;
+            EtcSubblock first, second;
+            encodeEtcSubblock(block, texels[0], bits, first);
+            encodeEtcSubblock(block, texels[1], bits, second);
+            if (differential) {
+                // the second base is stored as a 3-bit signed offset from the first
+                bool inRange = true;
+                for (int c = 0; c < 3; c++) {
+                    inRange = inRange && second.base[c] - first.base[c] >= -4 && second.base[c] - first.base[c] <= 3;
+                }
+                if (!inRange) {
+                    int base[3];
+                    for (int c = 0; c < 3; c++) {
+                        base[c] = first.base[c] + std::min(3, std::max(-4, second.base[c] - first.base[c]));
+                    }
+                    fitEtcSubblock(block, texels[1], base, bits, second);
+                }
+            }
+            int error = first.error + second.error;
+            if (error >= bestError) continue;
+            bestError = error;
+
+            for (int c = 0; c < 3; c++) {
+                out[c] = differential
+                    ? static_cast<unsigned char>(first.base[c] << 3 | ((second.base[c] - first.base[c]) & 7))
+                    : static_cast<unsigned char>(first.base[c] << 4 | second.base[c]);
+            }
+            out[3] = static_cast<unsigned char>(first.table << 5 | second.table << 2 | differential << 1 | flip);
+            // selectors are stored column-major: texel (x, y) is bit x * 4 + y, msbs in the upper half
+            uint32_t selectorBits = 0;
+            for (int i = 0; i < 16; i++) {
+                int selector = half[i] == 0 ? first.selectors[i] : second.selectors[i];
+                int bit = (i % 4) * 4 + i / 4;
+                selectorBits |= static_cast<uint32_t>(selector >> 1) << (16 + bit);
+                selectorBits |= static_cast<uint32_t>(selector & 1) << bit;
+            }
+            for (int i = 0; i < 4; i++) out[4 + i] = selectorBits >> (24 - 8 * i) & 0xff;
+        }
+    }
+    return bestError;
+}
+
+static const int EAC_MODIFIERS[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12}, {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10}, {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9}, {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9}, {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+static int fitEacAlpha(const Block& block, int base, int multiplier, int table, uint64_t& indices) {
+    indices = 0;
+    int error = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestError = 1 << 30;
+        for (int p = 0; p < 8; p++) {
+            int d = block.rgba[i][3] - clampByte(base + EAC_MODIFIERS[table][p] * multiplier);
+            if (d * d < bestError) {
+                best = p;
+                bestError = d * d;
+            }
+        }
+        // column-major like the colour selectors, first texel in the top bits
+        indices |= static_cast<uint64_t>(best) << (45 - 3 * ((i % 4) * 4 + i / 4));
+        error += bestError;
+    }
+    return error;
+}
+
+// For each table, the multiplier that spans the block's alpha range and a few bases around its centre
+static int encodeAlphaEAC(const Block& block, unsigned char* out) {
+    int minAlpha = 255, maxAlpha = 0;
+    for (int i = 0; i < 16; i++) {
+        minAlpha = std::min(minAlpha, block.rgba[i][3]);
+        maxAlpha = std::max(maxAlpha, block.rgba[i][3]);
+    }
+
+    int bestError = 1 << 30, bestBase = 0, bestMultiplier = 1, bestTable = 0;
+    uint64_t bestIndices = 0;
+    for (int table = 0; table < 16 && bestError > 0; table++) {
+        int low = EAC_MODIFIERS[table][3], high = EAC_MODIFIERS[table][7];
+        int span = std::max(1, (maxAlpha - minAlpha + (high - low) - 1) / (high - low));
+        for (int multiplier = std::max(1, span - 1); multiplier <= std::min(15, span + 1); multiplier++) {
+            int center = ((minAlpha - low * multiplier) + (maxAlpha - high * multiplier)) / 2;
+            for (int base = center - 2; base <= center + 2; base++) {
+                if (base < 0 || base > 255) continue;
+                uint64_t indices;
+                int error = fitEacAlpha(block, base, multiplier, table, indices);
+                if (error < bestError) {
+                    bestError = error; bestBase = base; bestMultiplier = multiplier; bestTable = table;
+                    bestIndices = indices;
+                }
+            }
+        }
+    }
+    out[0] = static_cast<unsigned char>(bestBase);
+    out[1] = static_cast<unsigned char>(bestMultiplier << 4 | bestTable);
+    for (int i = 0; i < 6; i++) out[2 + i] = bestIndices >> (40 - 8 * i) & 0xff;
+    return bestError;
+}
+
+// ===== Images =====
+
+uint32_t blockFormatVkFormat(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1: return KTX2_FORMAT_BC1_RGB;
+        case BlockFormat::BC3: return KTX2_FORMAT_BC3;
+        case BlockFormat::ETC2_RGB: return KTX2_FORMAT_ETC2_RGB;
+        case BlockFormat::ETC2_RGBA: return KTX2_FORMAT_ETC2_RGBA;
+    }
+    return 0;
+}
+
+bool imageHasAlpha(const unsigned char* rgba, int width, int height) {
+    size_t texels = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < texels; i++) {
+        if (rgba[i * 4 + 3] != 255) return true;
+    }
+    return false;
+}
+
+std::vector<unsigned char> compressImage(const unsigned char* rgba, int width, int height, BlockFormat format,
+                                         double* squaredError) {
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    bool withAlpha = format == BlockFormat::BC3 || format == BlockFormat::ETC2_RGBA;
+    size_t blockBytes = withAlpha ? 16 : 8;
+    std::vector<unsigned char> out(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+    double error = 0.0;
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            Block block = fetchBlock(rgba, width, height, bx, by);
+            unsigned char* dst = &out[(static_cast<size_t>(by) * blocksX + bx) * blockBytes];
+            switch (format) {
+                case BlockFormat::BC1:
+                    error += encodeColorBC1(block, dst);
+                    break;
+                case BlockFormat::BC3:
+                    error += encodeAlphaBC3(block, dst);
+                    error += encodeColorBC1(block, dst + 8);
+                    break;
+                case BlockFormat::ETC2_RGB:
+                    error += encodeColorETC(block, dst);
+                    break;
+                case BlockFormat::ETC2_RGBA:
+                    error += encodeAlphaEAC(block, dst);
+                    error += encodeColorETC(block, dst + 8);
+                    break;
+            }
+        }
+    }
+    if (squaredError) *squaredError = error;
+    return out;
+}
+
+std::vector<unsigned char> downsampleImage(const unsigned char* rgba, int width, int height) {
+    int outWidth = std::max(1, width / 2), outHeight = std::max(1, height / 2);
+    std::vector<unsigned char> out(static_cast<size_t>(outWidth) * outHeight * 4);
+    for (int y = 0; y < outHeight; y++) {
+        for (int x = 0; x < outWidth; x++) {
+            int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+            int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+            for (int c = 0; c < 4; c++) {
+                int sum = rgba[(static_cast<size_t>(y0) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y0) * width + x1) * 4 + c] +
+                          rgba[(static_cast<size_t>(y1) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+                out[(static_cast<size_t>(y) * outWidth + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+    return out;
+}
@@ -0,0 +1,157 @@
+// Renders the procedural explosion shader (explosion.fs) offline into a flipbook
+// atlas: one column per animation frame, one row per spark variation. The game
+// samples this atlas instead of running explosion.fs when the quality profile
+// asks for flipbook explosions.
+//
+// Usage: explosion_atlas [--shader-dir DIR] [--output PATH] [--frames N]
+//                        [--variations M] [--cell PX] [--duration S]
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "headless.h"
+#include "shader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Must match COLOR_RANGE in explosion_flipbook.fs: explosion.fs emits colours up to
+// 2.0, so premultiplied colour is stored divided by this to fit in RGBA8
+const float COLOR_RANGE = 2.0f;
+
+int main(int argc, char *argv[]) {
+    std::string shaderDir = "resources/shaders/";
+    std::string outputPath = "resources/effects/explosion_atlas.png";
+    int frames = 16;
+    int variations = 4;
+    int cellSize = 64;
+    float duration = 1.2f; // desktop explosion duration, drives the spark flicker rate
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--shader-dir" && hasValue) shaderDir = std::string(argv[++i]) + "/";
+        else if (arg == "--output" && hasValue) outputPath = argv[++i];
+        else if (arg == "--frames" && hasValue) frames = std::atoi(argv[++i]);
+        else if (arg == "--variations" && hasValue) variations = std::atoi(argv[++i]);
+        else if (arg == "--cell" && hasValue) cellSize = std::atoi(argv[++i]);
+        else if (arg == "--duration" && hasValue) duration = static_cast<float>(std::atof(argv[++i]));
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--shader-dir DIR] [--output PATH] [--frames N]"
+                      << " [--variations M] [--cell PX] [--duration S]" << std::endl;
+            return 1;
+        }
+    }
+    if (frames < 2 || variations < 1 || cellSize < 1 || duration <= 0.0f) {
+        std::cerr << "--frames must be at least 2; --variations, --cell and --duration must be positive" << std::endl;
+        return 1;
+    }
+
+    int width = frames * cellSize;
+    int height = variations * cellSize;
+
+    HeadlessContext context;
+    if (!context.create(width, height)) return 1;
+
+    Shader explosionShader((shaderDir + "explosion.vs").c_str(), (shaderDir + "explosion.fs").c_str());
+    if (explosionShader.ID == 0) return 1;
+
+    // Float target so colours above 1.0 survive until they are packed below
+    unsigned int fbo, colorTexture;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Atlas framebuffer not complete" << std::endl;
+        return 1;
+    }
+
+    // Same quad as the game; scaled by 2 it fills the viewport
+    float quadVertices[] = {
+        -0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  1.0f, 1.0f
+    };
+    unsigned int vao, vbo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+
+    explosionShader.use();
+    explosionShader.setMat4("model", glm::scale(glm::mat4(1.0f), glm::vec3(2.0f, 2.0f, 1.0f)));
+    explosionShader.setMat4("view", glm::mat4(1.0f));
+    explosionShader.setMat4("projection", glm::mat4(1.0f));
+    explosionShader.setFloat("explosionDuration", duration);
+    explosionShader.setVec2("explosionCenter", glm::vec2(0.0f));
+
+    for (int variation = 0; variation < variations; variation++) {
+        // Each row starts the spark noise at a different point in time
+        float timeOffset = variation * 1.37f;
+        for (int frame = 0; frame < frames; frame++) {
+            float progress = static_cast<float>(frame) / (frames - 1);
+            explosionShader.setFloat("explosionProgress", progress);
+            explosionShader.setFloat("explosionTime", progress * duration);
+            explosionShader.setFloat("currentTime", timeOffset + progress * duration);
+
+            glViewport(frame * cellSize, variation * cellSize, cellSize, cellSize);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+    }
+
+    std::vector<float> pixels(static_cast<size_t>(width) * height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, pixels.data());
+
+    // The game draws explosions additively (GL_SRC_ALPHA, GL_ONE), so store the
+    // premultiplied contribution colour * alpha. Rows are flipped to top-down for
+    // the PNG; the game loads it with stbi vertical flip, restoring GL order.
+    std::vector<unsigned char> rgba(pixels.size());
+    for (int y = 0; y < height; y++) {
+        const float* src = pixels.data() + static_cast<size_t>(y) * width * 4;
+        unsigned char* dst = rgba.data() + static_cast<size_t>(height - 1 - y) * width * 4;
+        for (int x = 0; x < width; x++) {
+            float alpha = std::min(std::max(src[x * 4 + 3], 0.0f), 1.0f);
+            for (int c = 0; c < 3; c++) {
+                float value = std::min(std::max(src[x * 4 + c] * alpha / COLOR_RANGE, 0.0f), 1.0f);
+                dst[x * 4 + c] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+            }
+            dst[x * 4 + 3] = static_cast<unsigned char>(alpha * 255.0f + 0.5f);
+        }
+    }
+
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteTextures(1, &colorTexture);
+    glDeleteFramebuffers(1, &fbo);
+
+    if (!writePNG(outputPath, width, height, rgba.data())) {
+        std::cerr << "Failed to write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << outputPath << " (" << frames << " frames x " << variations << " variations, "
+              << cellSize << "px cells)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Bakes the stb_easy_font glyphs into a signed distance field atlas, written as
+// a header the game compiles in (the build runs this tool, see CMakeLists.txt).
+// Every glyph is a union of axis-aligned segments, so the distance field is
+// computed exactly from the rectangles instead of from a rasterized bitmap.
+// TextRenderer draws one quad per glyph from the atlas, crisp at any scale.
+//
+// Usage: font_atlas [--output PATH] [--pixels-per-unit N] [--padding UNITS] [--preview PGM]
+
+#include "stb_easy_font.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int FIRST_CHAR = 32;
+const int GLYPH_COUNT = 95;     // printable ASCII
+const int COLUMNS = 16;
+
+struct Rect {
+    float x0, y0, x1, y1;       // font units, y down
+};
+
+// The segment rectangles stb_easy_font draws for one character at the origin
+std::vector<Rect> glyphRects(char c) {
+    char text[2] = {c, 0};
+    char buffer[4096];
+    int quads = stb_easy_font_print(0, 0, text, nullptr, buffer, sizeof(buffer));
+    std::vector<Rect> rects;
+    for (int q = 0; q < quads; q++) {
+        const float* v = reinterpret_cast<const float*>(buffer + q * 64);
+        // corners 0 and 2 (16 bytes, 4 floats per vertex) are opposite
+        rects.push_back({std::min(v[0], v[8]), std::min(v[1], v[9]), std::max(v[0], v[8]), std::max(v[1], v[9])});
+    }
+    return rects;
+}
+
+// Signed distance to a box, negative inside
+float boxDistance(const Rect& r, float x, float y) {
+    float cx = (r.x0 + r.x1) * 0.5f, cy = (r.y0 + r.y1) * 0.5f;
+    float dx = std::abs(x - cx) - (r.x1 - r.x0) * 0.5f;
+    float dy = std::abs(y - cy) - (r.y1 - r.y0) * 0.5f;
+    float outside = std::sqrt(std::max(dx, 0.0f) * std::max(dx, 0.0f) + std::max(dy, 0.0f) * std::max(dy, 0.0f));
+    return outside + std::min(std::max(dx, dy), 0.0f);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string outputPath = "sdf_font_atlas.h";
+    std::string previewPath;
+    int pixelsPerUnit = 4;
+    int padding = 2;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--output" && hasValue) outputPath = argv[++i];
+        else if (arg == "--pixels-per-unit" && hasValue) pixelsPerUnit = std::atoi(argv[++i]);
+        else if (arg == "--padding" && hasValue) padding = std::atoi(argv[++i]);
+        else if (arg == "--preview" && hasValue) previewPath = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--output PATH] [--pixels-per-unit N] [--padding UNITS] [--preview PGM]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (pixelsPerUnit < 1 || padding < 1) {
+        std::cerr << "--pixels-per-unit and --padding must be positive" << std::endl;
+        return 1;
+    }
+
+    // One cell size for every glyph, big enough for the largest plus the padding
+    std::vector<std::vector<Rect>> glyphs(GLYPH_COUNT);
+    int advances[GLYPH_COUNT];
+    float extentX = 1.0f, extentY = 1.0f;
+    for (int g = 0; g < GLYPH_COUNT; g++) {
+        glyphs[g] = glyphRects(static_cast<char>(FIRST_CHAR + g));
+        advances[g] = stb_easy_font_charinfo[g].advance & 15;
+        for (const Rect& r : glyphs[g]) {
+            extentX = std::max(extentX, r.x1);
+            extentY = std::max(extentY, r.y1);
+        }
+    }
+    int cellUnitsX = static_cast<int>(std::ceil(extentX)) + 2 * padding;
+    int cellUnitsY = static_cast<int>(std::ceil(extentY)) + 2 * padding;
+    int cellWidth = cellUnitsX * pixelsPerUnit;
+    int cellHeight = cellUnitsY * pixelsPerUnit;
+    int rows = (GLYPH_COUNT + COLUMNS - 1) / COLUMNS;
+    int width = COLUMNS * cellWidth;
+    int height = rows * cellHeight;
+
+    // 0.5 on the outline, 1 at padding units inside, 0 at padding units outside
+    std::vector<unsigned char> atlas(static_cast<size_t>(width) * height, 0);
+    for (int g = 0; g < GLYPH_COUNT; g++) {
+        int cellX = (g % COLUMNS) * cellWidth;
+        int cellY = (g / COLUMNS) * cellHeight;
+        for (int py = 0; py < cellHeight; py++) {
+            for (int px = 0; px < cellWidth; px++) {
+                // pixel centre in font units relative to the glyph origin
+                float x = (px + 0.5f) / pixelsPerUnit - padding;
+                float y = (py + 0.5f) / pixelsPerUnit - padding;
+                float distance = static_cast<float>(padding);
+                for (const Rect& r : glyphs[g]) {
+                    distance = std::min(distance, boxDistance(r, x, y));
+                }
+                float value = std::min(std::max(0.5f - distance / (2.0f * padding), 0.0f), 1.0f);
+                atlas[static_cast<size_t>(cellY + py) * width + cellX + px] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    std::ostringstream header;
+    header << "// Generated by font_atlas from stb_easy_font - do not edit.\n"
+           << "#ifndef SDF_FONT_ATLAS_H\n#define SDF_FONT_ATLAS_H\n\n"
+           << "// Single-channel distance field, rows top-down; cell (c - FIRST_CHAR) holds\n"
+           << "// character c with its origin PADDING units in from the cell's top-left corner\n"
+           << "inline constexpr int SDF_FONT_FIRST_CHAR = " << FIRST_CHAR << ";\n"
+           << "inline constexpr int SDF_FONT_GLYPH_COUNT = " << GLYPH_COUNT << ";\n"
+           << "inline constexpr int SDF_FONT_COLUMNS = " << COLUMNS << ";\n"
+           << "inline constexpr int SDF_FONT_PIXELS_PER_UNIT = " << pixelsPerUnit << ";\n"
+           << "inline constexpr int SDF_FONT_PADDING = " << padding << ";     // font units, also the distance range\n"
+           << "inline constexpr int SDF_FONT_CELL_UNITS_X = " << cellUnitsX << ";\n"
+           << "inline constexpr int SDF_FONT_CELL_UNITS_Y = " << cellUnitsY << ";\n"
+           << "inline constexpr int SDF_FONT_ATLAS_WIDTH = " << width << ";\n"
+           << "inline constexpr int SDF_FONT_ATLAS_HEIGHT = " << height << ";\n\n"
+           << "inline constexpr unsigned char SDF_FONT_ADVANCES[] = {";
+    for (int g = 0; g < GLYPH_COUNT; g++) {
+        header << (g % 32 == 0 ? "\n    " : " ") << advances[g] << ",";
+    }
+    header << "\n};\n\ninline constexpr unsigned char SDF_FONT_ATLAS[] = {";
+    for (size_t i = 0; i < atlas.size(); i++) {
+        header << (i % 32 == 0 ? "\n    " : "") << static_cast<int>(atlas[i]) << ",";
+    }
+    header << "\n};\n\n#endif\n";
+
+    // The preview is written even when the header is up to date
+    if (!previewPath.empty()) {
+        std::ofstream preview(previewPath, std::ios::binary);
+        preview << "P5\n" << width << " " << height << "\n255\n";
+        preview.write(reinterpret_cast<const char*>(atlas.data()), atlas.size());
+        if (!preview) {
+            std::cerr << "Failed to write " << previewPath << std::endl;
+            return 1;
+        }
+    }
+
+    // Only touch the header when it changed so dependents are not rebuilt needlessly
+    std::string content = header.str();
+    {
+        std::ifstream existing(outputPath, std::ios::binary);
+        std::stringstream old;
+        old << existing.rdbuf();
+        if (existing && old.str() == content) {
+            std::cout << outputPath << " is up to date" << std::endl;
+            return 0;
+        }
+    }
+    std::ofstream out(outputPath, std::ios::binary);
+    out << content;
+    if (!out) {
+        std::cerr << "Failed to write " << outputPath << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << outputPath << " (" << GLYPH_COUNT << " glyphs, " << width << "x" << height << ", "
+              << cellWidth << "x" << cellHeight << " px cells, " << atlas.size() / 1024 << " KB)" << std::endl;
+    return 0;
+}
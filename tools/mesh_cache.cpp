@@ -0,0 +1,67 @@
+// Converts models into the binary mesh cache format (mesh_cache.h) ahead of time,
+// so even the first launch skips Assimp. The game writes the same files itself
+// on a cache miss; this tool exists for packaging and for timing the two paths.
+//
+// Usage: mesh_cache [--cache-dir DIR] [--no-optimize] [--assimp-optimize] MODEL...
+
+#include <glad/glad.h>
+
+#include "headless.h"
+#include "model.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+    ModelImportOptions options;
+    options.cacheDir = "mesh_cache";
+    options.rebuildCache = true;
+    std::vector<std::string> models;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cache-dir" && i + 1 < argc) options.cacheDir = argv[++i];
+        else if (arg == "--no-optimize") options.optimize = false;
+        else if (arg == "--assimp-optimize") options.assimpOptimize = true;
+        else if (!arg.empty() && arg[0] != '-') models.push_back(arg);
+        else {
+            models.clear();
+            break;
+        }
+    }
+    if (models.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--cache-dir DIR] [--no-optimize] [--assimp-optimize] MODEL..." << std::endl;
+        return 1;
+    }
+
+    // Mesh and texture creation need a context even though only the cache file is kept
+    HeadlessContext context;
+    if (!context.create(1, 1)) return 1;
+
+    for (const std::string& path : models) {
+        try {
+            // import (writes the cache), then load it back the way the game will
+            double importMs;
+            {
+                Model imported(path, false, options);
+                importMs = imported.loadMilliseconds;
+            }
+            ModelImportOptions cachedOptions = options;
+            cachedOptions.rebuildCache = false;
+            Model cached(path, false, cachedOptions);
+            if (!cached.loadedFromCache) {
+                std::cerr << "Failed to write a usable mesh cache for " << path << std::endl;
+                return 1;
+            }
+            std::cout << path << " -> " << meshCachePath(options.cacheDir, path) << ": Assimp import "
+                      << importMs << " ms, cache load " << cached.loadMilliseconds << " ms" << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to convert " << path << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Packs a directory tree (normally resources/) into one .pack archive that the
+// game memory-maps at startup instead of opening each file. Entry names are
+// paths relative to ROOT; list PATHs (relative to ROOT) to pack only part of it.
+//
+// Usage: resource_pack [--compress] [--output FILE] ROOT [PATH...]
+//   (default output: ROOT.pack, e.g. resources.pack next to resources/)
+
+#include "resource_pack.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool addFile(const fs::path& root, const fs::path& path, std::vector<ResourcePackInput>& inputs) {
+    std::string extension = path.extension().string();
+    if (extension == ".pack" || extension == ".tmp") return true;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Cannot read " << path.string() << std::endl;
+        return false;
+    }
+    ResourcePackInput input;
+    input.name = path.lexically_relative(root).generic_string();
+    input.data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(input.data.data()), input.data.size());
+    inputs.push_back(std::move(input));
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char *argv[]) {
+    bool compress = false;
+    std::string output;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--compress") compress = true;
+        else if (arg == "--output" && i + 1 < argc) output = argv[++i];
+        else if (!arg.empty() && arg[0] != '-') paths.push_back(arg);
+        else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--compress] [--output FILE] ROOT [PATH...]" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    fs::path root = fs::path(paths[0]).lexically_normal();
+    if (root.filename().empty()) root = root.parent_path();
+    if (output.empty()) output = root.string() + ".pack";
+    if (paths.size() == 1) paths.push_back(root.string());
+
+    std::vector<ResourcePackInput> inputs;
+    for (size_t i = 1; i < paths.size(); i++) {
+        fs::path path = fs::path(paths[i]).lexically_normal();
+        if (i > 1 && path.is_relative()) path = root / path;
+        std::error_code ec;
+        if (fs::is_directory(path, ec)) {
+            for (const fs::directory_entry& entry : fs::recursive_directory_iterator(path, ec)) {
+                if (entry.is_regular_file() && !addFile(root, entry.path(), inputs)) return 1;
+            }
+        } else if (!fs::is_regular_file(path, ec) || !addFile(root, path, inputs)) {
+            std::cerr << "Not a file or directory: " << path.string() << std::endl;
+            return 1;
+        }
+    }
+
+    ResourcePackStats stats;
+    if (!writeResourcePack(output, inputs, compress, &stats)) {
+        return 1;
+    }
+    std::cout << output << ": " << stats.entries << " entries (" << stats.compressedEntries << " compressed), "
+              << stats.inputBytes / 1024 << " KB in, " << stats.fileBytes / 1024 << " KB packed, "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+              << " ms" << std::endl;
+    return 0;
+}
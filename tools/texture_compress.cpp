@@ -0,0 +1,114 @@
+// Encodes images into block-compressed KTX2 files with a precomputed mip chain,
+// written next to the source as <name>.bc.ktx2 (BC1, or BC3 with alpha) and
+// <name>.etc2.ktx2 (ETC2 RGB, or ETC2 RGBA with EAC alpha). TextureCache picks
+// the best one the GL context supports and falls back to the source image.
+//
+// Usage: texture_compress [--format bc|etc2|all] [--output-dir DIR] [--no-flip] [--no-mipmaps] IMAGE...
+
+#include "ktx2.h"
+#include "stb_image.h"
+#include "texture_compress.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool compressTo(const std::string& outputPath, const unsigned char* pixels, int width, int height,
+                       BlockFormat format, bool flip, bool mipmaps) {
+    auto start = std::chrono::steady_clock::now();
+    Ktx2Texture texture;
+    texture.vkFormat = blockFormatVkFormat(format);
+    texture.width = width;
+    texture.height = height;
+    texture.bottomUp = flip;
+
+    std::vector<unsigned char> level(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    int levelWidth = width, levelHeight = height;
+    double baseError = 0.0;
+    for (;;) {
+        double error;
+        std::vector<unsigned char> blocks = compressImage(level.data(), levelWidth, levelHeight, format, &error);
+        if (texture.levels.empty()) baseError = error;
+        texture.levels.push_back({texture.data.size(), blocks.size(), levelWidth, levelHeight});
+        texture.data.insert(texture.data.end(), blocks.begin(), blocks.end());
+        if (!mipmaps || (levelWidth == 1 && levelHeight == 1)) break;
+
+        level = downsampleImage(level.data(), levelWidth, levelHeight);
+        levelWidth = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+    }
+    if (!writeKtx2(outputPath, texture)) {
+        return false;
+    }
+
+    bool withAlpha = format == BlockFormat::BC3 || format == BlockFormat::ETC2_RGBA;
+    double samples = static_cast<double>(width) * height * (withAlpha ? 4 : 3);
+    double mse = baseError / samples;
+    size_t uncompressed = static_cast<size_t>(width) * height * 4;
+    std::cout << "  " << outputPath << ": " << ktx2FormatName(texture.vkFormat) << ", " << texture.levels.size()
+              << " levels, " << texture.data.size() / 1024 << " KB (RGBA8 base level " << uncompressed / 1024
+              << " KB), base PSNR " << (mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0) << " dB, "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+              << " ms" << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    bool writeBC = true, writeETC2 = true, flip = true, mipmaps = true;
+    std::string outputDir;
+    std::vector<std::string> images;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            writeBC = format == "bc" || format == "all";
+            writeETC2 = format == "etc2" || format == "all";
+        }
+        else if (arg == "--output-dir" && i + 1 < argc) outputDir = argv[++i];
+        else if (arg == "--no-flip") flip = false;
+        else if (arg == "--no-mipmaps") mipmaps = false;
+        else if (!arg.empty() && arg[0] != '-') images.push_back(arg);
+        else {
+            images.clear();
+            break;
+        }
+    }
+    if (images.empty() || (!writeBC && !writeETC2)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--format bc|etc2|all] [--output-dir DIR] [--no-flip] [--no-mipmaps] IMAGE..." << std::endl;
+        return 1;
+    }
+
+    // rows bottom-up like TextureCache's default flipVertically, so the data uploads as is
+    stbi_set_flip_vertically_on_load(flip);
+    for (const std::string& path : images) {
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (!pixels) {
+            std::cerr << "Failed to load " << path << " (" << stbi_failure_reason() << ")" << std::endl;
+            return 1;
+        }
+        bool withAlpha = imageHasAlpha(pixels, width, height);
+        std::string basePath = outputDir.empty() ? path : (fs::path(outputDir) / fs::path(path).filename()).string();
+        std::cout << path << " (" << width << "x" << height << (withAlpha ? ", alpha" : ", opaque") << ")" << std::endl;
+
+        bool ok = true;
+        if (writeBC) {
+            ok = ok && compressTo(ktx2SiblingPath(basePath, KTX2_SUFFIX_BC), pixels, width, height,
+                                  withAlpha ? BlockFormat::BC3 : BlockFormat::BC1, flip, mipmaps);
+        }
+        if (writeETC2) {
+            ok = ok && compressTo(ktx2SiblingPath(basePath, KTX2_SUFFIX_ETC2), pixels, width, height,
+                                  withAlpha ? BlockFormat::ETC2_RGBA : BlockFormat::ETC2_RGB, flip, mipmaps);
+        }
+        stbi_image_free(pixels);
+        if (!ok) return 1;
+    }
+    return 0;
+}